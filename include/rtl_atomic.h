@@ -0,0 +1,419 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtl_platform.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Pointer-sized integer accessed atomically.
+ */
+typedef volatile uintptr_t rtl_atomic_word_t;
+
+/**
+ * @brief Pointer accessed atomically.
+ */
+typedef void* volatile rtl_atomic_ptr_t;
+
+/**
+ * @brief 64-bit integer accessed atomically, also on 32-bit targets.
+ */
+typedef volatile uint64_t rtl_atomic_u64_t;
+
+/**
+ * @brief 32-bit integer accessed atomically, the size futexes operate on.
+ */
+typedef volatile uint32_t rtl_atomic_u32_t;
+
+#if defined(_MSC_VER)
+
+#if defined(_M_ARM64)
+#define _RTL_ATOMIC_BARRIER() __dmb(_ARM64_BARRIER_ISH)
+#else
+#define _RTL_ATOMIC_BARRIER() _ReadWriteBarrier()
+#endif
+
+#if defined(_WIN64)
+#define _RTL_INTERLOCKED_TYPE             __int64
+#define _rtl_interlocked_exchange         _InterlockedExchange64
+#define _rtl_interlocked_compare_exchange _InterlockedCompareExchange64
+#define _rtl_interlocked_exchange_add     _InterlockedExchangeAdd64
+#else
+#define _RTL_INTERLOCKED_TYPE             long
+#define _rtl_interlocked_exchange         _InterlockedExchange
+#define _rtl_interlocked_compare_exchange _InterlockedCompareExchange
+#define _rtl_interlocked_exchange_add     _InterlockedExchangeAdd
+#endif
+
+#endif
+
+/**
+ * @brief Loads a word with acquire ordering.
+ * @param word Pointer to the atomic word.
+ * @return The loaded value.
+ */
+static RTL_INLINE uintptr_t rtl_atomic_load(const rtl_atomic_word_t* word)
+{
+#if defined(_MSC_VER)
+  const uintptr_t value = *word;
+  _RTL_ATOMIC_BARRIER();
+  return value;
+#else
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @brief Loads a word without ordering guarantees.
+ * @param word Pointer to the atomic word.
+ * @return The loaded value.
+ */
+static RTL_INLINE uintptr_t rtl_atomic_load_relaxed(const rtl_atomic_word_t* word)
+{
+#if defined(_MSC_VER)
+  return *word;
+#else
+  return __atomic_load_n(word, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * @brief Stores a word with release ordering.
+ * @param word Pointer to the atomic word.
+ * @param value Value to store.
+ */
+static RTL_INLINE void rtl_atomic_store(rtl_atomic_word_t* word, uintptr_t value)
+{
+#if defined(_MSC_VER)
+  _RTL_ATOMIC_BARRIER();
+  *word = value;
+#else
+  __atomic_store_n(word, value, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * @brief Stores a word without ordering guarantees.
+ * @param word Pointer to the atomic word.
+ * @param value Value to store.
+ */
+static RTL_INLINE void rtl_atomic_store_relaxed(rtl_atomic_word_t* word, uintptr_t value)
+{
+#if defined(_MSC_VER)
+  *word = value;
+#else
+  __atomic_store_n(word, value, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * @brief Atomically replaces a word, sequentially consistent.
+ * @param word Pointer to the atomic word.
+ * @param value Value to store.
+ * @return The previous value.
+ */
+static RTL_INLINE uintptr_t rtl_atomic_exchange(rtl_atomic_word_t* word, uintptr_t value)
+{
+#if defined(_MSC_VER)
+  return (uintptr_t)_rtl_interlocked_exchange(
+    (volatile _RTL_INTERLOCKED_TYPE*)word, (_RTL_INTERLOCKED_TYPE)value);
+#else
+  return __atomic_exchange_n(word, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomically replaces a word if it holds the expected value, sequentially consistent.
+ * @param word Pointer to the atomic word.
+ * @param expected Pointer to the expected value, updated with the current value on failure.
+ * @param desired Value to store on success.
+ * @return true if the word was replaced, false otherwise.
+ */
+static RTL_INLINE bool rtl_atomic_cas(
+  rtl_atomic_word_t* word, uintptr_t* expected, uintptr_t desired)
+{
+#if defined(_MSC_VER)
+  const uintptr_t previous = (uintptr_t)_rtl_interlocked_compare_exchange(
+    (volatile _RTL_INTERLOCKED_TYPE*)word, (_RTL_INTERLOCKED_TYPE)desired,
+    (_RTL_INTERLOCKED_TYPE)*expected);
+  if (previous == *expected) {
+    return true;
+  }
+  *expected = previous;
+  return false;
+#else
+  return __atomic_compare_exchange_n(
+    word, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomically adds to a word, sequentially consistent.
+ * @param word Pointer to the atomic word.
+ * @param value Value to add.
+ * @return The previous value.
+ */
+static RTL_INLINE uintptr_t rtl_atomic_fetch_add(rtl_atomic_word_t* word, uintptr_t value)
+{
+#if defined(_MSC_VER)
+  return (uintptr_t)_rtl_interlocked_exchange_add(
+    (volatile _RTL_INTERLOCKED_TYPE*)word, (_RTL_INTERLOCKED_TYPE)value);
+#else
+  return __atomic_fetch_add(word, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Atomically adds to a word without ordering guarantees, for counters that
+ *        don't publish other data.
+ * @param word Pointer to the atomic word.
+ * @param value Value to add.
+ * @return The previous value.
+ */
+static RTL_INLINE uintptr_t rtl_atomic_fetch_add_relaxed(rtl_atomic_word_t* word, uintptr_t value)
+{
+#if defined(_MSC_VER)
+  return (uintptr_t)_rtl_interlocked_exchange_add(
+    (volatile _RTL_INTERLOCKED_TYPE*)word, (_RTL_INTERLOCKED_TYPE)value);
+#else
+  return __atomic_fetch_add(word, value, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * @brief Compares and swaps a word without ordering guarantees.
+ * @param word Pointer to the atomic word.
+ * @param expected Pointer to the expected value, updated with the current value on failure.
+ * @param desired Value to store if the word holds the expected value.
+ * @return true if the word was swapped, false otherwise.
+ */
+static RTL_INLINE bool rtl_atomic_cas_relaxed(
+  rtl_atomic_word_t* word, uintptr_t* expected, uintptr_t desired)
+{
+#if defined(_MSC_VER)
+  return rtl_atomic_cas(word, expected, desired);
+#else
+  return __atomic_compare_exchange_n(
+    word, expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * @brief Loads a pointer with acquire ordering.
+ * @param ptr Pointer to the atomic pointer.
+ * @return The loaded pointer.
+ */
+static RTL_INLINE void* rtl_atomic_load_ptr(rtl_atomic_ptr_t const* ptr)
+{
+  return (void*)rtl_atomic_load((const rtl_atomic_word_t*)ptr);
+}
+
+/**
+ * @brief Stores a pointer with release ordering.
+ * @param ptr Pointer to the atomic pointer.
+ * @param value Pointer to store.
+ */
+static RTL_INLINE void rtl_atomic_store_ptr(rtl_atomic_ptr_t* ptr, void* value)
+{
+  rtl_atomic_store((rtl_atomic_word_t*)ptr, (uintptr_t)value);
+}
+
+/**
+ * @brief Atomically replaces a pointer, sequentially consistent.
+ * @param ptr Pointer to the atomic pointer.
+ * @param value Pointer to store.
+ * @return The previous pointer.
+ */
+static RTL_INLINE void* rtl_atomic_exchange_ptr(rtl_atomic_ptr_t* ptr, void* value)
+{
+  return (void*)rtl_atomic_exchange((rtl_atomic_word_t*)ptr, (uintptr_t)value);
+}
+
+/**
+ * @brief Atomically replaces a pointer if it holds the expected value, sequentially consistent.
+ * @param ptr Pointer to the atomic pointer.
+ * @param expected Pointer to the expected value, updated with the current value on failure.
+ * @param desired Pointer to store on success.
+ * @return true if the pointer was replaced, false otherwise.
+ */
+static RTL_INLINE bool rtl_atomic_cas_ptr(rtl_atomic_ptr_t* ptr, void** expected, void* desired)
+{
+  return rtl_atomic_cas((rtl_atomic_word_t*)ptr, (uintptr_t*)expected, (uintptr_t)desired);
+}
+
+/**
+ * @brief Loads a 32-bit integer with acquire ordering.
+ * @param value Pointer to the atomic integer.
+ * @return The loaded value.
+ */
+static RTL_INLINE uint32_t rtl_atomic_load_u32(const rtl_atomic_u32_t* value)
+{
+#if defined(_MSC_VER)
+  const uint32_t result = *value;
+  _RTL_ATOMIC_BARRIER();
+  return result;
+#else
+  return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @brief Atomically adds to a 32-bit integer, sequentially consistent.
+ * @param value Pointer to the atomic integer.
+ * @param addend Value to add.
+ * @return The previous value.
+ */
+static RTL_INLINE uint32_t rtl_atomic_fetch_add_u32(rtl_atomic_u32_t* value, uint32_t addend)
+{
+#if defined(_MSC_VER)
+  return (uint32_t)_InterlockedExchangeAdd((volatile long*)value, (long)addend);
+#else
+  return __atomic_fetch_add(value, addend, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Loads a 64-bit integer with acquire ordering.
+ * @param value Pointer to the atomic integer.
+ * @return The loaded value.
+ */
+static RTL_INLINE uint64_t rtl_atomic_load_u64(const rtl_atomic_u64_t* value)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+  const uint64_t result = *value;
+  _RTL_ATOMIC_BARRIER();
+  return result;
+#elif defined(_MSC_VER)
+  // A compare-exchange that never matches is the only atomic 64-bit read on x86
+  return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)value, 0, 0);
+#else
+  return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @brief Stores a 64-bit integer with release ordering.
+ * @param value Pointer to the atomic integer.
+ * @param desired Value to store.
+ */
+static RTL_INLINE void rtl_atomic_store_u64(rtl_atomic_u64_t* value, uint64_t desired)
+{
+#if defined(_MSC_VER)
+  _InterlockedExchange64((volatile __int64*)value, (__int64)desired);
+#else
+  __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * @brief Atomically replaces a 64-bit integer if it holds the expected value,
+ *        sequentially consistent.
+ * @param value Pointer to the atomic integer.
+ * @param expected Pointer to the expected value, updated with the current value on failure.
+ * @param desired Value to store on success.
+ * @return true if the integer was replaced, false otherwise.
+ */
+static RTL_INLINE bool rtl_atomic_cas_u64(
+  rtl_atomic_u64_t* value, uint64_t* expected, uint64_t desired)
+{
+#if defined(_MSC_VER)
+  const uint64_t previous = (uint64_t)_InterlockedCompareExchange64(
+    (volatile __int64*)value, (__int64)desired, (__int64)*expected);
+  if (previous == *expected) {
+    return true;
+  }
+  *expected = previous;
+  return false;
+#else
+  return __atomic_compare_exchange_n(
+    value, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Full sequentially consistent memory fence.
+ */
+static RTL_INLINE void rtl_atomic_fence(void)
+{
+#if defined(_MSC_VER)
+#if defined(_M_ARM64)
+  __dmb(_ARM64_BARRIER_ISH);
+#else
+  _mm_mfence();
+#endif
+#else
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Hints the CPU that the caller is spinning on a contended location.
+ */
+static RTL_INLINE void rtl_atomic_pause(void)
+{
+#if defined(_MSC_VER)
+#if defined(_M_ARM64)
+  __yield();
+#else
+  _mm_pause();
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief Acquires a word used as a spinlock.
+ * @param lock Pointer to the lock word, 0 when unlocked.
+ */
+static RTL_INLINE void rtl_atomic_lock(rtl_atomic_word_t* lock)
+{
+  for (;;) {
+    uintptr_t expected = 0;
+    if (rtl_atomic_cas(lock, &expected, 1)) {
+      return;
+    }
+    // Spin on plain loads so waiting doesn't bounce the cache line
+    while (rtl_atomic_load_relaxed(lock) != 0) {
+      rtl_atomic_pause();
+    }
+  }
+}
+
+/**
+ * @brief Releases a word used as a spinlock.
+ * @param lock Pointer to the lock word.
+ */
+static RTL_INLINE void rtl_atomic_unlock(rtl_atomic_word_t* lock)
+{
+  rtl_atomic_store(lock, 0);
+}
@@ -0,0 +1,148 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rtl_atomic.h"
+#include "rtl_list.h"
+#include "rtl_memory.h"
+
+/**
+ * @brief Maximum number of block orders a buddy allocator can manage.
+ */
+#define RTL_BUDDY_MAX_ORDERS 48
+
+/**
+ * @brief Smallest block size a buddy allocator accepts, large enough for a free list link.
+ */
+#define RTL_BUDDY_MIN_BLOCK 32
+
+/**
+ * @brief Binary buddy allocator over a single mapped region.
+ *        Blocks are powers of two; splitting and coalescing are O(log n), and a
+ *        freed block merges with its buddy whenever both halves are free.
+ */
+typedef struct rtl_buddy_t
+{
+  char* base;             /**< Start of the managed region */
+  size_t size;            /**< Region size, a power of two */
+  size_t min_block;       /**< Smallest block size, a power of two */
+  unsigned max_order;     /**< Order of the whole region */
+  unsigned page_flags;    /**< rtl_page_flags_t the region was mapped with */
+  unsigned char* orders;  /**< Per smallest block: order and free flag */
+  rtl_memory_header_t* headers; /**< Per smallest block: rtl_malloc() header, mapped on bind */
+  size_t used;            /**< Bytes handed out in blocks */
+  rtl_atomic_word_t lock; /**< Spinlock guarding the allocator */
+  rtl_list_entry_t free_lists[RTL_BUDDY_MAX_ORDERS]; /**< Free blocks, one list per order */
+} rtl_buddy_t;
+
+/**
+ * @brief Initializes a buddy allocator and maps its region.
+ * @param buddy Pointer to the allocator to initialize.
+ * @param size Region size, rounded up to a power of two.
+ * @param min_block Smallest block size, rounded up to a power of two of at least
+ *        RTL_BUDDY_MIN_BLOCK.
+ * @param page_flags rtl_page_flags_t used to map the region, e.g. RTL_PAGE_HUGE.
+ * @return true on success, false if the region could not be mapped.
+ */
+bool rtl_buddy_init(rtl_buddy_t* buddy, size_t size, size_t min_block, unsigned page_flags);
+
+/**
+ * @brief Unmaps the allocator's region. Outstanding blocks become invalid.
+ *        A bound allocator with outstanding blocks is left bound and mapped, so
+ *        rtl_buddy_free_hook() never hands its blocks to free().
+ * @param buddy Pointer to the allocator to clean up.
+ */
+void rtl_buddy_cleanup(rtl_buddy_t* buddy);
+
+/**
+ * @brief Allocates a block of at least the requested size.
+ *        The block is aligned to its own size.
+ * @param buddy Pointer to the allocator.
+ * @param size Number of bytes requested.
+ * @return Pointer to the block, or NULL if no block large enough is free.
+ */
+void* rtl_buddy_alloc(rtl_buddy_t* buddy, size_t size);
+
+/**
+ * @brief Frees a block and coalesces it with free buddies.
+ * @param buddy Pointer to the allocator.
+ * @param ptr Pointer returned by rtl_buddy_alloc(), or NULL.
+ */
+void rtl_buddy_free(rtl_buddy_t* buddy, void* ptr);
+
+/**
+ * @brief Gets the size of the block backing an allocation.
+ * @param buddy Pointer to the allocator.
+ * @param ptr Pointer returned by rtl_buddy_alloc().
+ * @return Block size in bytes.
+ */
+size_t rtl_buddy_block_size(const rtl_buddy_t* buddy, const void* ptr);
+
+/**
+ * @brief Checks whether a pointer lies inside the allocator's region.
+ * @param buddy Pointer to the allocator.
+ * @param ptr Pointer to check.
+ * @return true if the pointer belongs to the allocator, false otherwise.
+ */
+bool rtl_buddy_owns(const rtl_buddy_t* buddy, const void* ptr);
+
+/**
+ * @brief Makes a buddy allocator the backend of rtl_buddy_malloc() and rtl_buddy_free_hook(),
+ *        mapping its out-of-line header table on first use.
+ *        Refused while the currently bound allocator has outstanding blocks, since
+ *        they could no longer be freed back to it.
+ * @param buddy Pointer to the allocator, or NULL to unbind.
+ * @return true if the allocator is bound, false if the binding was refused or the
+ *         header table could not be mapped.
+ */
+bool rtl_buddy_bind(rtl_buddy_t* buddy);
+
+/**
+ * @brief Allocation function matching rtl_malloc_func_t, served by the bound buddy
+ *        allocator and falling back to malloc() when it is exhausted.
+ *        Pass it to rtl_init() together with rtl_buddy_free_hook(), then register
+ *        rtl_buddy_header() with rtl_memory_set_header_func(). Headers then live in
+ *        the allocator's table, so power-of-two requests fill exactly one block.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL on failure.
+ */
+void* rtl_buddy_malloc(size_t size);
+
+/**
+ * @brief Free function matching rtl_free_func_t, pairing with rtl_buddy_malloc().
+ * @param ptr Pointer to the memory block to free.
+ */
+void rtl_buddy_free_hook(void* ptr);
+
+/**
+ * @brief Header function matching rtl_memory_header_func_t, pairing with rtl_buddy_malloc().
+ *        Blocks of the bound allocator use its header table; malloc() fallbacks carry
+ *        their header in front of the block.
+ * @param ptr Pointer returned by rtl_buddy_malloc().
+ * @return The header slot of the block.
+ */
+rtl_memory_header_t* rtl_buddy_header(void* ptr);
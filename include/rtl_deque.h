@@ -0,0 +1,177 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rtl_list.h"
+#include "rtl_platform.h"
+
+/**
+ * @brief Number of elements stored per chunk.
+ */
+#define RTL_DEQUE_CHUNK_SIZE 64
+
+/**
+ * @brief Number of emptied chunks a deque keeps for reuse instead of freeing them.
+ */
+#define RTL_DEQUE_SPARE_CHUNKS 2
+
+/**
+ * @brief Iteration callback type definition.
+ * @param index The current index in the iteration (starting from 0).
+ * @param item The current element.
+ * @param user_data User-provided data passed to the callback.
+ * @return true to continue iterating, false to stop.
+ */
+typedef bool (*rtl_deque_callback_t)(unsigned long index, void* item, void* user_data);
+
+/**
+ * @brief Span iteration callback type definition.
+ * @param items Contiguous run of elements, all from one chunk.
+ * @param count Number of elements in the run.
+ * @param user_data User-provided data passed to the callback.
+ * @return true to continue iterating, false to stop.
+ */
+typedef bool (*rtl_deque_span_callback_t)(void** items, size_t count, void* user_data);
+
+/**
+ * @brief Fixed-size block of elements, linked into its deque's chunk list.
+ */
+typedef struct rtl_deque_chunk_t
+{
+  rtl_list_entry_t link;             /**< Link in the chunk or spare list */
+  void* items[RTL_DEQUE_CHUNK_SIZE]; /**< Element slots */
+} rtl_deque_chunk_t;
+
+/**
+ * @brief Double-ended queue of pointers stored in linked chunks.
+ *        Pushes and pops at both ends are O(1), and iteration walks whole
+ *        chunks instead of chasing one link per element.
+ */
+typedef struct rtl_deque_t
+{
+  rtl_list_entry_t chunks;  /**< Chunks in order, the first holds the front element */
+  rtl_counted_list_t spare; /**< Emptied chunks kept for reuse */
+  size_t head_index;        /**< Slot of the front element in the first chunk */
+  size_t tail_index;        /**< Slot after the back element in the last chunk */
+  size_t count;             /**< Number of elements */
+} rtl_deque_t;
+
+/**
+ * @brief Initializes an empty deque. No chunk is allocated until the first push.
+ * @param deque Pointer to the deque to initialize.
+ */
+void rtl_deque_init(rtl_deque_t* deque);
+
+/**
+ * @brief Frees every chunk of the deque, including the spare ones.
+ * @param deque Pointer to the deque to clean up.
+ */
+void rtl_deque_cleanup(rtl_deque_t* deque);
+
+/**
+ * @brief Gets the number of elements in the deque.
+ * @param deque Pointer to the deque.
+ * @return The number of elements.
+ */
+static RTL_INLINE size_t rtl_deque_size(const rtl_deque_t* deque)
+{
+  return deque->count;
+}
+
+/**
+ * @brief Checks whether a deque is empty.
+ * @param deque Pointer to the deque.
+ * @return true if the deque has no elements, false otherwise.
+ */
+static RTL_INLINE bool rtl_deque_empty(const rtl_deque_t* deque)
+{
+  return deque->count == 0;
+}
+
+/**
+ * @brief Appends an element at the back.
+ * @param deque Pointer to the deque.
+ * @param item Element to append.
+ * @return true on success, false if a new chunk could not be allocated.
+ */
+bool rtl_deque_push_back(rtl_deque_t* deque, void* item);
+
+/**
+ * @brief Prepends an element at the front.
+ * @param deque Pointer to the deque.
+ * @param item Element to prepend.
+ * @return true on success, false if a new chunk could not be allocated.
+ */
+bool rtl_deque_push_front(rtl_deque_t* deque, void* item);
+
+/**
+ * @brief Removes the element at the back.
+ * @param deque Pointer to the deque.
+ * @param item Receives the removed element, can be NULL.
+ * @return true on success, false if the deque is empty.
+ */
+bool rtl_deque_pop_back(rtl_deque_t* deque, void** item);
+
+/**
+ * @brief Removes the element at the front.
+ * @param deque Pointer to the deque.
+ * @param item Receives the removed element, can be NULL.
+ * @return true on success, false if the deque is empty.
+ */
+bool rtl_deque_pop_front(rtl_deque_t* deque, void** item);
+
+/**
+ * @brief Gets the element at the front without removing it.
+ * @param deque Pointer to the deque.
+ * @return The front element, or NULL if the deque is empty.
+ */
+void* rtl_deque_front(const rtl_deque_t* deque);
+
+/**
+ * @brief Gets the element at the back without removing it.
+ * @param deque Pointer to the deque.
+ * @return The back element, or NULL if the deque is empty.
+ */
+void* rtl_deque_back(const rtl_deque_t* deque);
+
+/**
+ * @brief Iterate over a deque from front to back using a callback function.
+ * @param deque Pointer to the deque.
+ * @param callback Callback function to call for each element.
+ * @param user_data User data to pass to the callback function.
+ */
+void rtl_deque_for_each(const rtl_deque_t* deque, rtl_deque_callback_t callback, void* user_data);
+
+/**
+ * @brief Iterate over a deque from front to back one contiguous run per chunk,
+ *        so the callback can process elements in a tight loop.
+ * @param deque Pointer to the deque.
+ * @param callback Callback function to call for each run.
+ * @param user_data User data to pass to the callback function.
+ */
+void rtl_deque_for_each_span(
+  const rtl_deque_t* deque, rtl_deque_span_callback_t callback, void* user_data);
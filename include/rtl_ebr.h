@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtl_atomic.h"
+#include "rtl_list.h"
+#include "rtl_platform.h"
+
+/**
+ * @brief Number of retired pointers collected per thread before a reclamation attempt.
+ */
+#define RTL_EBR_BATCH_SIZE 64
+
+/**
+ * @brief Block of pointers retired by one thread, freed together.
+ */
+typedef struct rtl_ebr_batch_t
+{
+  struct rtl_ebr_batch_t* next;    /**< Next batch waiting for reclamation */
+  uintptr_t epoch;                 /**< Global epoch when the batch was sealed */
+  unsigned long count;             /**< Number of retired pointers in the batch */
+  void* items[RTL_EBR_BATCH_SIZE]; /**< Retired pointers, released with rtl_free() */
+} rtl_ebr_batch_t;
+
+/**
+ * @brief Epoch-based reclamation domain.
+ *        Memory retired inside the domain is freed once every registered
+ *        thread has left the critical sections that could still observe it.
+ */
+typedef struct rtl_ebr_t
+{
+  rtl_atomic_word_t epoch;    /**< Global epoch, only ever incremented */
+  char _pad[RTL_CACHE_LINE_SIZE - sizeof(rtl_atomic_word_t)];
+  rtl_atomic_word_t lock;     /**< Spinlock guarding the registry and orphans */
+  rtl_list_entry_t threads;   /**< Registered rtl_ebr_thread_t records */
+  rtl_ebr_batch_t* orphans;   /**< Batches left behind by unregistered threads */
+} rtl_ebr_t;
+
+/**
+ * @brief Per-thread reclamation state.
+ *        Owned by the caller, typically one per thread and domain.
+ */
+typedef struct rtl_ebr_thread_t
+{
+  rtl_atomic_word_t state;  /**< Observed epoch shifted left by one, low bit set while active */
+  char _pad[RTL_CACHE_LINE_SIZE - sizeof(rtl_atomic_word_t)];
+  rtl_ebr_t* ebr;           /**< Domain the thread is registered with */
+  rtl_list_entry_t link;    /**< Link in the domain's thread registry */
+  unsigned long nesting;    /**< Depth of nested critical sections */
+  rtl_ebr_batch_t* current; /**< Batch currently being filled */
+  rtl_ebr_batch_t* pending; /**< Sealed batches waiting for the epoch to advance */
+} rtl_ebr_thread_t;
+
+/**
+ * @brief Initializes a reclamation domain.
+ * @param ebr Pointer to the domain to initialize.
+ */
+void rtl_ebr_init(rtl_ebr_t* ebr);
+
+/**
+ * @brief Cleans up a domain and frees everything still retired in it.
+ *        No thread may be inside a critical section at this point.
+ * @param ebr Pointer to the domain to clean up.
+ */
+void rtl_ebr_cleanup(rtl_ebr_t* ebr);
+
+/**
+ * @brief Registers the calling thread's record with a domain.
+ * @param ebr Pointer to the domain.
+ * @param thread Pointer to the thread record to register.
+ */
+void rtl_ebr_thread_register(rtl_ebr_t* ebr, rtl_ebr_thread_t* thread);
+
+/**
+ * @brief Unregisters a thread record. Pointers it retired that can't be freed yet
+ *        are handed over to the domain and freed by other threads or at cleanup.
+ * @param thread Pointer to the thread record, must be outside any critical section.
+ */
+void rtl_ebr_thread_unregister(rtl_ebr_thread_t* thread);
+
+/**
+ * @brief Enters a critical section. Shared nodes may only be dereferenced inside one.
+ *        Critical sections can be nested.
+ * @param thread Pointer to the calling thread's record.
+ */
+void rtl_ebr_enter(rtl_ebr_thread_t* thread);
+
+/**
+ * @brief Leaves a critical section entered with rtl_ebr_enter().
+ * @param thread Pointer to the calling thread's record.
+ */
+void rtl_ebr_leave(rtl_ebr_thread_t* thread);
+
+/**
+ * @brief Defers freeing of a node that has been unlinked from all shared structures.
+ *        The pointer is released with rtl_free() once no thread can observe it.
+ * @param thread Pointer to the calling thread's record.
+ * @param ptr Pointer allocated with rtl_malloc().
+ * @return true if the pointer was retired, false if the retire list could not grow.
+ */
+bool rtl_ebr_retire(rtl_ebr_thread_t* thread, void* ptr);
+
+/**
+ * @brief Seals the thread's partial batch, tries to advance the epoch and frees
+ *        every batch that became safe.
+ * @param thread Pointer to the calling thread's record.
+ * @return Number of pointers the thread still has waiting for reclamation.
+ */
+unsigned long rtl_ebr_flush(rtl_ebr_thread_t* thread);
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "rtl_list.h"
 
@@ -69,8 +70,17 @@ typedef struct rtl_hash_table_t
   unsigned long entry_count;          /**< Current number of entries */
   rtl_hash_function_t hash_function;  /**< Hash function to use */
   rtl_hash_key_compare_t key_compare; /**< Key comparison function */
+  unsigned long entry_capacity;       /**< Fixed number of entries, 0 if entries are allocated */
+  unsigned long key_capacity;         /**< Largest key a fixed entry holds */
+  unsigned long value_capacity;       /**< Largest value a fixed entry holds */
+  rtl_list_entry_t free_entries;      /**< Unused fixed entries */
 } rtl_hash_table_t;
 
+/**
+ * @brief Alignment of keys and values stored in caller-provided storage.
+ */
+#define RTL_HASH_STATIC_ALIGNMENT 16
+
 /**
  * @brief Initializes a hash table with the specified number of buckets.
  * @param table Pointer to the hash table structure to initialize.
@@ -82,11 +92,43 @@ typedef struct rtl_hash_table_t
 bool rtl_hash_table_init(rtl_hash_table_t* table, unsigned long bucket_count,
   rtl_hash_function_t hash_function, rtl_hash_key_compare_t key_compare);
 
+/**
+ * @brief Computes the storage size rtl_hash_table_init_static() needs.
+ * @param bucket_count Number of buckets.
+ * @param entry_capacity Maximum number of entries.
+ * @param key_capacity Largest key size in bytes.
+ * @param value_capacity Largest value size in bytes.
+ * @return Required storage size in bytes.
+ */
+size_t rtl_hash_table_static_size(unsigned long bucket_count, unsigned long entry_capacity,
+  unsigned long key_capacity, unsigned long value_capacity);
+
+/**
+ * @brief Initializes a hash table over caller-provided storage.
+ *        Buckets, entries, keys and values all live in the storage, so no operation on
+ *        the table allocates and insert fails once entry_capacity entries are stored.
+ * @param table Pointer to the hash table structure to initialize.
+ * @param bucket_count Number of buckets in the hash table (must be > 0).
+ * @param entry_capacity Maximum number of entries (must be > 0).
+ * @param key_capacity Largest key size in bytes.
+ * @param value_capacity Largest value size in bytes.
+ * @param storage Memory for the table, owned by the caller and kept alive until cleanup.
+ * @param storage_size Size of the storage, at least rtl_hash_table_static_size().
+ * @param hash_function Hash function to use for hashing keys.
+ * @param key_compare Key comparison function for comparing keys.
+ * @return true if initialization was successful, false if the storage is too small.
+ */
+bool rtl_hash_table_init_static(rtl_hash_table_t* table, unsigned long bucket_count,
+  unsigned long entry_capacity, unsigned long key_capacity, unsigned long value_capacity,
+  void* storage, size_t storage_size, rtl_hash_function_t hash_function,
+  rtl_hash_key_compare_t key_compare);
+
 /**
  * @brief Cleans up a hash table and frees all associated internal memory.
  * @param table Pointer to the hash table to clean up.
  *        Note: This frees internal entries and buckets,
  *              but does not free the table structure itself.
+ *              Caller-provided storage is left to the caller.
  */
 void rtl_hash_table_cleanup(rtl_hash_table_t* table);
 
@@ -99,6 +141,8 @@ void rtl_hash_table_cleanup(rtl_hash_table_t* table);
  * @param value_size Size of the value data in bytes.
  * @return true if the operation was successful, false otherwise.
  *         Note: If the key already exists, its value will be updated.
+ *               Tables over static storage fail when full or when the key or
+ *               value exceeds the capacities given at initialization.
  */
 bool rtl_hash_table_insert(rtl_hash_table_t* table, const void* key, unsigned long key_size,
   const void* value, unsigned long value_size);
@@ -0,0 +1,138 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "rtl_atomic.h"
+#include "rtl_list.h"
+
+/**
+ * @brief Number of hazard slots each thread can hold at once.
+ */
+#define RTL_HAZARD_SLOTS 4
+
+/**
+ * @brief Minimum number of retired pointers a thread accumulates before scanning.
+ *        The effective threshold is also at least twice the number of hazard slots in
+ *        the domain, which bounds unreclaimed memory and amortizes each scan.
+ */
+#define RTL_HAZARD_SCAN_THRESHOLD 64
+
+/**
+ * @brief Hazard-pointer reclamation domain.
+ *        Unlike epochs, a stalled reader only pins the nodes it protects,
+ *        so the amount of unreclaimed memory stays bounded.
+ */
+typedef struct rtl_hazard_t
+{
+  rtl_atomic_word_t lock;         /**< Spinlock guarding the registry and orphans */
+  rtl_list_entry_t threads;       /**< Registered rtl_hazard_thread_t records */
+  rtl_atomic_word_t thread_count; /**< Number of registered threads */
+  void** orphans;                 /**< Pointers left behind by unregistered threads */
+  unsigned long orphan_count;     /**< Number of orphaned pointers */
+  unsigned long orphan_capacity;  /**< Capacity of the orphans array */
+} rtl_hazard_t;
+
+/**
+ * @brief Per-thread hazard-pointer state.
+ *        Owned by the caller, typically one per thread and domain.
+ */
+typedef struct rtl_hazard_thread_t
+{
+  rtl_atomic_ptr_t slots[RTL_HAZARD_SLOTS]; /**< Pointers this thread is accessing */
+  rtl_hazard_t* domain;                     /**< Domain the thread is registered with */
+  rtl_list_entry_t link;                    /**< Link in the domain's thread registry */
+  void** retired;                           /**< Pointers waiting to be freed */
+  unsigned long retired_count;              /**< Number of retired pointers */
+  unsigned long retired_capacity;           /**< Capacity of the retired array */
+  void** hazards;                           /**< Scratch array for scan snapshots */
+  unsigned long hazards_capacity;           /**< Capacity of the hazards array */
+} rtl_hazard_thread_t;
+
+/**
+ * @brief Initializes a hazard-pointer domain.
+ * @param domain Pointer to the domain to initialize.
+ */
+void rtl_hazard_init(rtl_hazard_t* domain);
+
+/**
+ * @brief Cleans up a domain and frees everything still retired in it.
+ *        No thread may hold a hazard pointer at this point.
+ * @param domain Pointer to the domain to clean up.
+ */
+void rtl_hazard_cleanup(rtl_hazard_t* domain);
+
+/**
+ * @brief Registers the calling thread's record with a domain.
+ * @param domain Pointer to the domain.
+ * @param thread Pointer to the thread record to register.
+ */
+void rtl_hazard_thread_register(rtl_hazard_t* domain, rtl_hazard_thread_t* thread);
+
+/**
+ * @brief Unregisters a thread record, clearing its slots. Pointers that are still
+ *        protected by other threads are handed over to the domain.
+ * @param thread Pointer to the thread record.
+ */
+void rtl_hazard_thread_unregister(rtl_hazard_thread_t* thread);
+
+/**
+ * @brief Loads a shared pointer and publishes it in a hazard slot.
+ *        The returned node stays valid until the slot is cleared or reused.
+ * @param thread Pointer to the calling thread's record.
+ * @param slot Slot index, less than RTL_HAZARD_SLOTS.
+ * @param source Shared location to load the pointer from.
+ * @return The protected pointer, which may be NULL.
+ */
+void* rtl_hazard_protect(rtl_hazard_thread_t* thread, unsigned slot, rtl_atomic_ptr_t* source);
+
+/**
+ * @brief Clears a hazard slot.
+ * @param thread Pointer to the calling thread's record.
+ * @param slot Slot index, less than RTL_HAZARD_SLOTS.
+ */
+void rtl_hazard_clear(rtl_hazard_thread_t* thread, unsigned slot);
+
+/**
+ * @brief Clears all hazard slots of a thread.
+ * @param thread Pointer to the calling thread's record.
+ */
+void rtl_hazard_clear_all(rtl_hazard_thread_t* thread);
+
+/**
+ * @brief Defers freeing of a node that has been unlinked from all shared structures.
+ *        The pointer is released with rtl_free() once no hazard slot refers to it.
+ * @param thread Pointer to the calling thread's record.
+ * @param ptr Pointer allocated with rtl_malloc().
+ * @return true if the pointer was retired, false if the retire list could not grow.
+ */
+bool rtl_hazard_retire(rtl_hazard_thread_t* thread, void* ptr);
+
+/**
+ * @brief Frees every retired pointer of the thread that no hazard slot refers to.
+ * @param thread Pointer to the calling thread's record.
+ * @return Number of pointers the thread still has waiting for reclamation.
+ */
+unsigned long rtl_hazard_scan(rtl_hazard_thread_t* thread);
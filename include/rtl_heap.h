@@ -0,0 +1,199 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rtl_platform.h"
+
+/**
+ * @brief Number of children per node of rtl_dheap_t.
+ *        Four children of a node share a cache line for small elements and
+ *        halve the tree depth compared to a binary heap.
+ */
+#define RTL_DHEAP_ARITY 4
+
+/**
+ * @brief Pairing heap node, embedded in the structures stored in the heap.
+ *        Use RTL_CONTAINER_OF() to get back to the containing structure.
+ */
+typedef struct rtl_pairing_node_t
+{
+  struct rtl_pairing_node_t* child;   /**< First child */
+  struct rtl_pairing_node_t* sibling; /**< Next sibling */
+  struct rtl_pairing_node_t* prev;    /**< Previous sibling, or parent for a first child */
+} rtl_pairing_node_t;
+
+/**
+ * @brief Pairing heap comparison function type definition.
+ * @param a Pointer to the first node.
+ * @param b Pointer to the second node.
+ * @return Negative if a has to be popped before b, zero or positive otherwise.
+ */
+typedef int (*rtl_pairing_heap_compare_t)(const rtl_pairing_node_t* a, const rtl_pairing_node_t* b);
+
+/**
+ * @brief Intrusive pairing heap (min-heap).
+ *        Insert and decrease-key are O(1), pop and remove are amortized O(log n).
+ */
+typedef struct rtl_pairing_heap_t
+{
+  rtl_pairing_node_t* root;           /**< Smallest node, NULL for an empty heap */
+  rtl_pairing_heap_compare_t compare; /**< Node ordering */
+} rtl_pairing_heap_t;
+
+/**
+ * @brief Element comparison function type definition for rtl_dheap_t.
+ * @param a Pointer to the first element.
+ * @param b Pointer to the second element.
+ * @return Negative if a has to be popped before b, zero or positive otherwise.
+ */
+typedef int (*rtl_dheap_compare_t)(const void* a, const void* b);
+
+/**
+ * @brief Array-backed 4-ary min-heap of fixed-size elements.
+ *        Elements are copied in and out, and the storage grows geometrically.
+ */
+typedef struct rtl_dheap_t
+{
+  char* data;                  /**< Elements, followed by one scratch slot */
+  size_t count;                /**< Number of elements in the heap */
+  size_t capacity;             /**< Number of elements the storage holds */
+  size_t element_size;         /**< Size of one element in bytes */
+  rtl_dheap_compare_t compare; /**< Element ordering */
+} rtl_dheap_t;
+
+/**
+ * @brief Initializes an empty pairing heap.
+ * @param heap Pointer to the heap to initialize.
+ * @param compare Node ordering function.
+ */
+void rtl_pairing_heap_init(rtl_pairing_heap_t* heap, rtl_pairing_heap_compare_t compare);
+
+/**
+ * @brief Checks whether a pairing heap is empty.
+ * @param heap Pointer to the heap.
+ * @return true if the heap has no nodes, false otherwise.
+ */
+static RTL_INLINE bool rtl_pairing_heap_empty(const rtl_pairing_heap_t* heap)
+{
+  return heap->root == NULL;
+}
+
+/**
+ * @brief Gets the smallest node without removing it.
+ * @param heap Pointer to the heap.
+ * @return The smallest node, or NULL if the heap is empty.
+ */
+static RTL_INLINE rtl_pairing_node_t* rtl_pairing_heap_top(const rtl_pairing_heap_t* heap)
+{
+  return heap->root;
+}
+
+/**
+ * @brief Inserts a node in O(1).
+ * @param heap Pointer to the heap.
+ * @param node Pointer to the node to insert, must not be in a heap.
+ */
+void rtl_pairing_heap_insert(rtl_pairing_heap_t* heap, rtl_pairing_node_t* node);
+
+/**
+ * @brief Removes and returns the smallest node.
+ * @param heap Pointer to the heap.
+ * @return The smallest node, or NULL if the heap is empty.
+ */
+rtl_pairing_node_t* rtl_pairing_heap_pop(rtl_pairing_heap_t* heap);
+
+/**
+ * @brief Removes any node from the heap.
+ * @param heap Pointer to the heap.
+ * @param node Pointer to the node to remove, must be in the heap.
+ */
+void rtl_pairing_heap_remove(rtl_pairing_heap_t* heap, rtl_pairing_node_t* node);
+
+/**
+ * @brief Restores the heap order in O(1) after a node's key was decreased.
+ * @param heap Pointer to the heap.
+ * @param node Pointer to the node whose key the caller has just decreased.
+ */
+void rtl_pairing_heap_decrease_key(rtl_pairing_heap_t* heap, rtl_pairing_node_t* node);
+
+/**
+ * @brief Initializes an empty 4-ary heap. No storage is allocated until the first push.
+ * @param heap Pointer to the heap to initialize.
+ * @param element_size Size of one element in bytes.
+ * @param compare Element ordering function.
+ */
+void rtl_dheap_init(rtl_dheap_t* heap, size_t element_size, rtl_dheap_compare_t compare);
+
+/**
+ * @brief Releases the heap's storage.
+ * @param heap Pointer to the heap to clean up.
+ */
+void rtl_dheap_cleanup(rtl_dheap_t* heap);
+
+/**
+ * @brief Gets the number of elements in the heap.
+ * @param heap Pointer to the heap.
+ * @return The number of elements.
+ */
+static RTL_INLINE size_t rtl_dheap_size(const rtl_dheap_t* heap)
+{
+  return heap->count;
+}
+
+/**
+ * @brief Grows the storage to hold at least the given number of elements.
+ * @param heap Pointer to the heap.
+ * @param capacity Number of elements to make room for.
+ * @return true on success, false if the storage could not be allocated.
+ */
+bool rtl_dheap_reserve(rtl_dheap_t* heap, size_t capacity);
+
+/**
+ * @brief Gets the smallest element without removing it.
+ * @param heap Pointer to the heap.
+ * @return Pointer to the smallest element, valid until the heap is modified, or NULL.
+ */
+static RTL_INLINE const void* rtl_dheap_top(const rtl_dheap_t* heap)
+{
+  return heap->count ? heap->data : NULL;
+}
+
+/**
+ * @brief Inserts an element in O(log n), growing the storage if needed.
+ * @param heap Pointer to the heap.
+ * @param element Pointer to the element to copy in, may point into the heap itself.
+ * @return true on success, false if the storage could not grow.
+ */
+bool rtl_dheap_push(rtl_dheap_t* heap, const void* element);
+
+/**
+ * @brief Removes the smallest element in O(log n).
+ * @param heap Pointer to the heap.
+ * @param element Pointer receiving the element, can be NULL.
+ * @return true on success, false if the heap is empty.
+ */
+bool rtl_dheap_pop(rtl_dheap_t* heap, void* element);
@@ -0,0 +1,254 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtl_platform.h"
+
+/**
+ * @brief Index that terminates a list, no node may use it.
+ */
+#define RTL_ILIST_NIL UINT32_MAX
+
+/**
+ * @brief Get the struct for a node index.
+ * @param pool The &struct rtl_ilist_pool the nodes live in.
+ * @param index Index of the node.
+ * @param type The type of the nodes.
+ * @return A pointer to the node.
+ */
+#define rtl_ilist_record(pool, index, type)                                                        \
+  ((type*)((pool)->base + (size_t)(index) * (pool)->stride))
+
+/**
+ * @brief Iterate over an index list.
+ * @param index The uint32_t to use as a loop cursor.
+ * @param list The list to iterate.
+ */
+#define rtl_ilist_for_each(index, list)                                                            \
+  for (index = (list)->head; index != RTL_ILIST_NIL; index = rtl_ilist_next(list, index))
+
+/**
+ * @brief Iterate over an index list, safe against removal of the cursor.
+ * @param index The uint32_t to use as a loop cursor.
+ * @param n Another uint32_t to use as temporary storage.
+ * @param list The list to iterate.
+ */
+#define rtl_ilist_for_each_safe(index, n, list)                                                    \
+  for (index = (list)->head, n = index != RTL_ILIST_NIL ? rtl_ilist_next(list, index) : 0;        \
+    index != RTL_ILIST_NIL; index = n, n = index != RTL_ILIST_NIL ? rtl_ilist_next(list, index) : 0)
+
+/**
+ * @brief Index list link, embedded in nodes stored in an array.
+ *        Half the size of rtl_list_entry_t on 64-bit targets.
+ */
+typedef struct rtl_ilist_entry_t
+{
+  uint32_t prev; /**< Index of the previous node, RTL_ILIST_NIL for the first */
+  uint32_t next; /**< Index of the next node, RTL_ILIST_NIL for the last */
+} rtl_ilist_entry_t;
+
+/**
+ * @brief Array of nodes that index lists link into.
+ *        Several lists can share a pool, a node belongs to at most one of them
+ *        per embedded link. A free list of unused nodes is just another list.
+ */
+typedef struct rtl_ilist_pool_t
+{
+  char* base;    /**< Address of node 0 */
+  size_t stride; /**< Distance between consecutive nodes in bytes */
+  size_t offset; /**< Offset of the rtl_ilist_entry_t within a node */
+} rtl_ilist_pool_t;
+
+/**
+ * @brief Doubly linked list of node indices.
+ */
+typedef struct rtl_ilist_t
+{
+  const rtl_ilist_pool_t* pool; /**< Pool the nodes live in */
+  uint32_t head;                /**< Index of the first node, RTL_ILIST_NIL if empty */
+  uint32_t tail;                /**< Index of the last node, RTL_ILIST_NIL if empty */
+  uint32_t count;               /**< Number of nodes in the list */
+} rtl_ilist_t;
+
+/**
+ * @brief Describes an array of nodes as a pool.
+ * @param pool Pointer to the pool to initialize.
+ * @param base Address of the first node.
+ * @param stride Size of one node, typically sizeof(type).
+ * @param offset Offset of the link within a node, typically offsetof(type, field).
+ */
+static RTL_INLINE void rtl_ilist_pool_init(
+  rtl_ilist_pool_t* pool, void* base, size_t stride, size_t offset)
+{
+  pool->base = (char*)base;
+  pool->stride = stride;
+  pool->offset = offset;
+}
+
+/**
+ * @brief Gets the link of a node.
+ * @param pool Pointer to the pool.
+ * @param index Index of the node.
+ * @return Pointer to the node's link.
+ */
+static RTL_INLINE rtl_ilist_entry_t* rtl_ilist_entry(const rtl_ilist_pool_t* pool, uint32_t index)
+{
+  return (rtl_ilist_entry_t*)(pool->base + (size_t)index * pool->stride + pool->offset);
+}
+
+/**
+ * @brief Initializes an empty list over a pool.
+ * @param list Pointer to the list.
+ * @param pool Pointer to the pool the nodes live in.
+ */
+static RTL_INLINE void rtl_ilist_init(rtl_ilist_t* list, const rtl_ilist_pool_t* pool)
+{
+  list->pool = pool;
+  list->head = RTL_ILIST_NIL;
+  list->tail = RTL_ILIST_NIL;
+  list->count = 0;
+}
+
+/**
+ * @brief Checks if a list is empty.
+ * @param list Pointer to the list.
+ * @return true if the list is empty, false otherwise.
+ */
+static RTL_INLINE bool rtl_ilist_empty(const rtl_ilist_t* list)
+{
+  return list->count == 0;
+}
+
+/**
+ * @brief Gets the number of nodes in a list in O(1).
+ * @param list Pointer to the list.
+ * @return The number of nodes in the list.
+ */
+static RTL_INLINE uint32_t rtl_ilist_length(const rtl_ilist_t* list)
+{
+  return list->count;
+}
+
+/**
+ * @brief Gets the node after another one.
+ * @param list Pointer to the list.
+ * @param index Index of a node in the list.
+ * @return Index of the next node, or RTL_ILIST_NIL if index is the last one.
+ */
+static RTL_INLINE uint32_t rtl_ilist_next(const rtl_ilist_t* list, uint32_t index)
+{
+  return rtl_ilist_entry(list->pool, index)->next;
+}
+
+/**
+ * @brief Gets the node before another one.
+ * @param list Pointer to the list.
+ * @param index Index of a node in the list.
+ * @return Index of the previous node, or RTL_ILIST_NIL if index is the first one.
+ */
+static RTL_INLINE uint32_t rtl_ilist_prev(const rtl_ilist_t* list, uint32_t index)
+{
+  return rtl_ilist_entry(list->pool, index)->prev;
+}
+
+/**
+ * @brief Adds a node to the front of a list.
+ * @param list Pointer to the list.
+ * @param index Index of the node to add, must not be in a list.
+ */
+static RTL_INLINE void rtl_ilist_add_head(rtl_ilist_t* list, uint32_t index)
+{
+  rtl_ilist_entry_t* entry = rtl_ilist_entry(list->pool, index);
+  entry->prev = RTL_ILIST_NIL;
+  entry->next = list->head;
+
+  if (list->head != RTL_ILIST_NIL) {
+    rtl_ilist_entry(list->pool, list->head)->prev = index;
+  } else {
+    list->tail = index;
+  }
+  list->head = index;
+  list->count++;
+}
+
+/**
+ * @brief Adds a node to the back of a list.
+ * @param list Pointer to the list.
+ * @param index Index of the node to add, must not be in a list.
+ */
+static RTL_INLINE void rtl_ilist_add_tail(rtl_ilist_t* list, uint32_t index)
+{
+  rtl_ilist_entry_t* entry = rtl_ilist_entry(list->pool, index);
+  entry->prev = list->tail;
+  entry->next = RTL_ILIST_NIL;
+
+  if (list->tail != RTL_ILIST_NIL) {
+    rtl_ilist_entry(list->pool, list->tail)->next = index;
+  } else {
+    list->head = index;
+  }
+  list->tail = index;
+  list->count++;
+}
+
+/**
+ * @brief Removes a node from a list.
+ * @param list Pointer to the list the node belongs to.
+ * @param index Index of the node to remove.
+ */
+static RTL_INLINE void rtl_ilist_remove(rtl_ilist_t* list, uint32_t index)
+{
+  const rtl_ilist_entry_t* entry = rtl_ilist_entry(list->pool, index);
+
+  if (entry->prev != RTL_ILIST_NIL) {
+    rtl_ilist_entry(list->pool, entry->prev)->next = entry->next;
+  } else {
+    list->head = entry->next;
+  }
+
+  if (entry->next != RTL_ILIST_NIL) {
+    rtl_ilist_entry(list->pool, entry->next)->prev = entry->prev;
+  } else {
+    list->tail = entry->prev;
+  }
+  list->count--;
+}
+
+/**
+ * @brief Removes and returns the first node of a list.
+ * @param list Pointer to the list.
+ * @return Index of the removed node, or RTL_ILIST_NIL if the list is empty.
+ */
+static RTL_INLINE uint32_t rtl_ilist_pop_head(rtl_ilist_t* list)
+{
+  const uint32_t index = list->head;
+  if (index != RTL_ILIST_NIL) {
+    rtl_ilist_remove(list, index);
+  }
+  return index;
+}
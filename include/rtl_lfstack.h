@@ -0,0 +1,101 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtl_atomic.h"
+
+/**
+ * @brief Intrusive lock-free stack node, embedded in the stacked structure.
+ *        Use RTL_CONTAINER_OF() to get back to the containing structure.
+ */
+typedef struct rtl_lfstack_node_t
+{
+  rtl_atomic_ptr_t next; /**< Node below this one */
+} rtl_lfstack_node_t;
+
+/**
+ * @brief Intrusive lock-free LIFO stack (Treiber).
+ *        The top pointer is paired with a modification counter in one 64-bit word
+ *        swapped by a single-width CAS, so a node popped and pushed back between
+ *        another thread's read and CAS can't corrupt the stack (ABA).
+ *        The counter takes the unused upper address bits and the alignment bits,
+ *        19 bits on 64-bit targets and 34 on 32-bit. The ABA window is not closed:
+ *        a pop stalled while other threads change the stack an exact multiple of
+ *        2^19 times, with the same node back on top, still installs a stale next.
+ *        Nodes must be pointer aligned and, on 64-bit, below 2^48.
+ *        Pop reads the next link of a node another thread may have just popped, so
+ *        node memory must stay mapped while the stack is in use, e.g. nodes from a
+ *        pool, or freed through rtl_ebr/rtl_hazard.
+ */
+typedef struct rtl_lfstack_t
+{
+  rtl_atomic_u64_t top; /**< Top node and modification counter, see rtl_lfstack.c */
+} rtl_lfstack_t;
+
+/**
+ * @brief Initializes an empty stack.
+ * @param stack Pointer to the stack to initialize.
+ */
+void rtl_lfstack_init(rtl_lfstack_t* stack);
+
+/**
+ * @brief Pushes a node onto the stack.
+ * @param stack Pointer to the stack.
+ * @param node Pointer to the node to push, owned by the stack until popped.
+ */
+void rtl_lfstack_push(rtl_lfstack_t* stack, rtl_lfstack_node_t* node);
+
+/**
+ * @brief Pushes a chain of nodes with a single CAS.
+ * @param stack Pointer to the stack.
+ * @param first Pointer to the node that ends up on top.
+ * @param last Pointer to the bottom node of the chain, reached from first via next links.
+ */
+void rtl_lfstack_push_chain(
+  rtl_lfstack_t* stack, rtl_lfstack_node_t* first, rtl_lfstack_node_t* last);
+
+/**
+ * @brief Pops the top node.
+ * @param stack Pointer to the stack.
+ * @return Pointer to the popped node, or NULL if the stack is empty.
+ */
+rtl_lfstack_node_t* rtl_lfstack_pop(rtl_lfstack_t* stack);
+
+/**
+ * @brief Detaches every node from the stack at once.
+ * @param stack Pointer to the stack.
+ * @return The former top node, the rest follow through next links ending in NULL,
+ *         or NULL if the stack was empty.
+ */
+rtl_lfstack_node_t* rtl_lfstack_pop_all(rtl_lfstack_t* stack);
+
+/**
+ * @brief Checks whether the stack is empty at the time of the call.
+ * @param stack Pointer to the stack.
+ * @return true if the stack is empty, false otherwise.
+ */
+bool rtl_lfstack_empty(const rtl_lfstack_t* stack);
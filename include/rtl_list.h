@@ -23,6 +23,18 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+
+#include "rtl_platform.h"
+
+/**
+ * @brief Linkage of the small list primitives defined in this header.
+ *        They are static inline everywhere except rtl_list.c, which defines this
+ *        as empty before the include to emit the exported symbols.
+ */
+#ifndef RTL_LIST_API
+#define RTL_LIST_API static RTL_INLINE
+#endif
 
 /**
  * @brief Get the struct for this entry.
@@ -31,8 +43,7 @@
  * @param field The name of the list_entry within the struct.
  * @return A pointer to the containing structure.
  */
-#define rtl_list_record(address, type, field)                                                      \
-  ((type*)((char*)(address) - (char*)(&((type*)0)->field)))
+#define rtl_list_record(address, type, field) RTL_CONTAINER_OF(address, type, field)
 
 /**
  * @brief Iterate over a list.
@@ -61,6 +72,56 @@
 #define rtl_list_for_each_indexed(index, position, head)                                           \
   for (position = (head)->next, index = 0; position != (head); position = position->next, index++)
 
+/**
+ * @brief Number of entries the prefetching iterator macros load ahead of the cursor.
+ *        Define it before including this header to tune it for a workload.
+ *        rtl_list_for_each_callback_prefetch() takes the distance as a parameter instead.
+ */
+#ifndef RTL_LIST_PREFETCH_DISTANCE
+#define RTL_LIST_PREFETCH_DISTANCE 4
+#endif
+
+/**
+ * @brief Iterate over a list, prefetching entries ahead of the cursor.
+ * @param position The &struct rtl_list_entry to use as a loop cursor.
+ * @param ahead Another &struct rtl_list_entry running RTL_LIST_PREFETCH_DISTANCE entries ahead.
+ * @param head The head for your list.
+ */
+#define rtl_list_for_each_prefetch(position, ahead, head)                                          \
+  for (position = (head)->next,                                                                    \
+      ahead = _rtl_list_prefetch_start(head, RTL_LIST_PREFETCH_DISTANCE);                          \
+    position != (head); position = position->next, ahead = _rtl_list_prefetch_step(ahead, head))
+
+/**
+ * @brief Iterate over a list, prefetching entries and their containing records ahead of the
+ *        cursor. Useful when the fields read by the loop body sit in other cache lines.
+ * @param position The &struct rtl_list_entry to use as a loop cursor.
+ * @param ahead Another &struct rtl_list_entry running RTL_LIST_PREFETCH_DISTANCE entries ahead.
+ * @param head The head for your list.
+ * @param type The type of the struct the entries are embedded in.
+ * @param field The name of the list_entry within the struct.
+ */
+#define rtl_list_for_each_prefetch_record(position, ahead, head, type, field)                      \
+  for (position = (head)->next,                                                                    \
+      ahead = _rtl_list_prefetch_record_start(                                                     \
+        head, RTL_LIST_PREFETCH_DISTANCE, offsetof(type, field));                                  \
+    position != (head); position = position->next,                                                 \
+      ahead = _rtl_list_prefetch_record_step(ahead, head, offsetof(type, field)))
+
+/**
+ * @brief Iterate over a list safe against removal of list entry, prefetching entries ahead.
+ *        Only the current entry may be removed.
+ * @param position The &struct rtl_list_entry to use as a loop cursor.
+ * @param n Another &struct rtl_list_entry to use as temporary storage.
+ * @param ahead Another &struct rtl_list_entry running RTL_LIST_PREFETCH_DISTANCE entries ahead.
+ * @param head The head for your list.
+ */
+#define rtl_list_for_each_safe_prefetch(position, n, ahead, head)                                  \
+  for (position = (head)->next, n = position->next,                                                \
+      ahead = _rtl_list_prefetch_start(head, RTL_LIST_PREFETCH_DISTANCE);                          \
+    position != (head);                                                                            \
+    position = n, n = position->next, ahead = _rtl_list_prefetch_step(ahead, head))
+
 /**
  * @brief Doubly linked list entry structure.
  *        Can be embedded in other structures to create linked lists.
@@ -82,46 +143,187 @@ typedef struct rtl_list_entry_t rtl_list_entry_t;
  */
 typedef bool (*rtl_list_callback_t)(unsigned long index, rtl_list_entry_t* entry, void* user_data);
 
+/**
+ * @brief Comparison function type for sorting and merging lists.
+ * @param a Pointer to the first entry.
+ * @param b Pointer to the second entry.
+ * @return Negative if a sorts before b, positive if after, 0 if they are equal.
+ */
+typedef int (*rtl_list_compare_t)(const rtl_list_entry_t* a, const rtl_list_entry_t* b);
+
+/**
+ * @internal
+ * @brief Inserts a new entry between two known consecutive entries.
+ *        This is an internal function, list users should use
+ *        rtl_list_add_head() or rtl_list_add_tail().
+ * @param _new Pointer to the new entry to be inserted.
+ * @param prev Pointer to the entry that will precede the new entry.
+ * @param next Pointer to the entry that will follow the new entry.
+ */
+static RTL_INLINE void _rtl_list_insert(
+  rtl_list_entry_t* _new, rtl_list_entry_t* prev, rtl_list_entry_t* next)
+{
+  next->prev = _new;
+  _new->next = next;
+  _new->prev = prev;
+  prev->next = _new;
+}
+
+/**
+ * @internal
+ * @brief Removes an entry by connecting its neighbors.
+ *        This is an internal function, list users should use rtl_list_remove().
+ * @param prev Pointer to the previous entry.
+ * @param next Pointer to the next entry.
+ */
+static RTL_INLINE void _rtl_list_remove(rtl_list_entry_t* prev, rtl_list_entry_t* next)
+{
+  next->prev = prev;
+  prev->next = next;
+}
+
+/**
+ * @internal
+ * @brief Walks a prefetch cursor the given distance into a list, prefetching as it goes.
+ * @param head Pointer to the list head entry.
+ * @param distance Number of entries to run ahead of the first one.
+ * @return The cursor, or head if the list is shorter than the distance.
+ */
+static RTL_INLINE rtl_list_entry_t* _rtl_list_prefetch_start(
+  const rtl_list_entry_t* head, unsigned distance)
+{
+  rtl_list_entry_t* ahead = head->next;
+  for (unsigned i = 0; i < distance && ahead != head; i++) {
+    ahead = ahead->next;
+    RTL_PREFETCH(ahead);
+  }
+  return ahead;
+}
+
+/**
+ * @internal
+ * @brief Advances a prefetch cursor by one entry and prefetches the entry it lands on.
+ *        The cursor stops at the head instead of wrapping around.
+ * @param ahead The prefetch cursor.
+ * @param head Pointer to the list head entry.
+ * @return The advanced cursor.
+ */
+static RTL_INLINE rtl_list_entry_t* _rtl_list_prefetch_step(
+  rtl_list_entry_t* ahead, const rtl_list_entry_t* head)
+{
+  if (ahead != head) {
+    ahead = ahead->next;
+    RTL_PREFETCH(ahead);
+  }
+  return ahead;
+}
+
+/**
+ * @internal
+ * @brief Like _rtl_list_prefetch_start(), but also prefetches the records of the first entry
+ *        and of every entry the cursor passes, so the initial window is covered too.
+ * @param head Pointer to the list head entry.
+ * @param distance Number of entries to run ahead of the first one.
+ * @param offset Offset of the list entry within its record.
+ * @return The cursor, or head if the list is shorter than the distance.
+ */
+static RTL_INLINE rtl_list_entry_t* _rtl_list_prefetch_record_start(
+  const rtl_list_entry_t* head, unsigned distance, size_t offset)
+{
+  rtl_list_entry_t* ahead = head->next;
+  for (unsigned i = 0; ahead != head; i++) {
+    RTL_PREFETCH(ahead);
+    RTL_PREFETCH((char*)ahead - offset);
+    if (i == distance) {
+      break;
+    }
+    ahead = ahead->next;
+  }
+  return ahead;
+}
+
+/**
+ * @internal
+ * @brief Advances a prefetch cursor by one entry and prefetches the entry and its record.
+ *        The head has no record, so nothing is prefetched once the cursor reaches it.
+ * @param ahead The prefetch cursor.
+ * @param head Pointer to the list head entry.
+ * @param offset Offset of the list entry within its record.
+ * @return The advanced cursor.
+ */
+static RTL_INLINE rtl_list_entry_t* _rtl_list_prefetch_record_step(
+  rtl_list_entry_t* ahead, const rtl_list_entry_t* head, size_t offset)
+{
+  ahead = _rtl_list_prefetch_step(ahead, head);
+  if (ahead != head) {
+    RTL_PREFETCH((char*)ahead - offset);
+  }
+  return ahead;
+}
+
 /**
  * @brief Initializes the head of a list.
  * @param head Pointer to the list head entry.
  */
-void rtl_list_init(rtl_list_entry_t* head);
+RTL_LIST_API void rtl_list_init(rtl_list_entry_t* head)
+{
+  head->prev = head;
+  head->next = head;
+}
 
 /**
  * @brief Checks if a list is empty.
  * @param head Pointer to the list head entry.
  * @return Non-zero if the list is empty, 0 otherwise.
  */
-bool rtl_list_empty(const rtl_list_entry_t* head);
+RTL_LIST_API bool rtl_list_empty(const rtl_list_entry_t* head)
+{
+  return head->next == head;
+}
 
 /**
  * @brief Adds a new entry to the front of the list.
  * @param head Pointer to the list head entry.
  * @param entry Pointer to the new entry to add.
  */
-void rtl_list_add_head(rtl_list_entry_t* head, rtl_list_entry_t* entry);
+RTL_LIST_API void rtl_list_add_head(rtl_list_entry_t* head, rtl_list_entry_t* entry)
+{
+  _rtl_list_insert(entry, head, head->next);
+}
 
 /**
  * @brief Adds a new entry to the back of the list.
  * @param head Pointer to the list head entry.
  * @param entry Pointer to the new entry to add.
  */
-void rtl_list_add_tail(rtl_list_entry_t* head, rtl_list_entry_t* entry);
+RTL_LIST_API void rtl_list_add_tail(rtl_list_entry_t* head, rtl_list_entry_t* entry)
+{
+  _rtl_list_insert(entry, head->prev, head);
+}
 
 /**
  * @brief Removes an entry from the list.
  * @param entry Pointer to the entry to remove.
  *        Note: entry is not freed, only removed from the list.
  */
-void rtl_list_remove(const rtl_list_entry_t* entry);
+RTL_LIST_API void rtl_list_remove(const rtl_list_entry_t* entry)
+{
+  _rtl_list_remove(entry->prev, entry->next);
+}
 
 /**
  * @brief Gets the first entry in the list.
  * @param head Pointer to the list head entry.
  * @return Pointer to the first entry, or NULL if the list is empty.
  */
-rtl_list_entry_t* rtl_list_first(const rtl_list_entry_t* head);
+RTL_LIST_API rtl_list_entry_t* rtl_list_first(const rtl_list_entry_t* head)
+{
+  if (rtl_list_empty(head)) {
+    return NULL;
+  }
+
+  return head->next;
+}
 
 /**
  * @brief Gets the next entry in the list.
@@ -129,7 +331,94 @@ rtl_list_entry_t* rtl_list_first(const rtl_list_entry_t* head);
  * @param head Pointer to the list head entry.
  * @return Pointer to the next entry, or NULL if current is the last entry.
  */
-rtl_list_entry_t* rtl_list_next(const rtl_list_entry_t* current, const rtl_list_entry_t* head);
+RTL_LIST_API rtl_list_entry_t* rtl_list_next(
+  const rtl_list_entry_t* current, const rtl_list_entry_t* head)
+{
+  if (current == NULL || current->next == head) {
+    return NULL;
+  }
+
+  return current->next;
+}
+
+/**
+ * @internal
+ * @brief Links all entries of a non-empty list between two consecutive entries.
+ * @param list Pointer to the head of the list to insert, left dangling.
+ * @param prev Pointer to the entry that will precede the inserted entries.
+ * @param next Pointer to the entry that will follow the inserted entries.
+ */
+static RTL_INLINE void _rtl_list_splice(
+  const rtl_list_entry_t* list, rtl_list_entry_t* prev, rtl_list_entry_t* next)
+{
+  rtl_list_entry_t* first = list->next;
+  rtl_list_entry_t* last = list->prev;
+
+  first->prev = prev;
+  prev->next = first;
+  last->next = next;
+  next->prev = last;
+}
+
+/**
+ * @brief Moves all entries of a list to the front of another list in O(1).
+ * @param head Pointer to the head of the receiving list.
+ * @param list Pointer to the head of the list to take entries from, left empty.
+ */
+RTL_LIST_API void rtl_list_splice_head(rtl_list_entry_t* head, rtl_list_entry_t* list)
+{
+  if (!rtl_list_empty(list)) {
+    _rtl_list_splice(list, head, head->next);
+    rtl_list_init(list);
+  }
+}
+
+/**
+ * @brief Moves all entries of a list to the back of another list in O(1).
+ * @param head Pointer to the head of the receiving list.
+ * @param list Pointer to the head of the list to take entries from, left empty.
+ */
+RTL_LIST_API void rtl_list_splice_tail(rtl_list_entry_t* head, rtl_list_entry_t* list)
+{
+  if (!rtl_list_empty(list)) {
+    _rtl_list_splice(list, head->prev, head);
+    rtl_list_init(list);
+  }
+}
+
+/**
+ * @brief Moves the entries from the front of a list up to and including a given entry
+ *        into another list in O(1).
+ * @param list Pointer to the head receiving the entries, its previous entries are dropped.
+ * @param head Pointer to the head of the list to cut.
+ * @param entry Pointer to the last entry to move, or head to move nothing.
+ */
+RTL_LIST_API void rtl_list_cut_position(
+  rtl_list_entry_t* list, rtl_list_entry_t* head, rtl_list_entry_t* entry)
+{
+  if (rtl_list_empty(head) || entry == head) {
+    rtl_list_init(list);
+    return;
+  }
+
+  rtl_list_entry_t* rest = entry->next;
+
+  list->next = head->next;
+  list->next->prev = list;
+  list->prev = entry;
+  entry->next = list;
+
+  head->next = rest;
+  rest->prev = head;
+}
+
+/**
+ * @brief Hands all entries of a list over to another head in O(1).
+ *        Use rtl_list_splice_head() or rtl_list_splice_tail() to keep entries already on new_head.
+ * @param old_head Pointer to the head of the list to take entries from, left empty.
+ * @param new_head Pointer to the head receiving the entries, must be initialized and empty.
+ */
+void rtl_list_replace_init(rtl_list_entry_t* old_head, rtl_list_entry_t* new_head);
 
 /**
  * @brief Gets the length (number of entries) in the list.
@@ -145,3 +434,123 @@ unsigned long rtl_list_length(const rtl_list_entry_t* head);
  * @param user_data User data to pass to the callback function.
  */
 void rtl_list_for_each_callback(const rtl_list_entry_t* head, rtl_list_callback_t callback, void* user_data);
+
+/**
+ * @brief Iterate over a list using a callback function, prefetching entries ahead of the one
+ *        passed to the callback.
+ * @param head Pointer to the list head entry.
+ * @param distance Number of entries to prefetch ahead, e.g. RTL_LIST_PREFETCH_DISTANCE.
+ * @param callback Callback function to call for each entry.
+ * @param user_data User data to pass to the callback function.
+ */
+void rtl_list_for_each_callback_prefetch(const rtl_list_entry_t* head, unsigned distance,
+  rtl_list_callback_t callback, void* user_data);
+
+/**
+ * @brief Sorts a list in place with a bottom-up merge sort.
+ *        The sort is stable, O(n log n) and doesn't allocate.
+ * @param head Pointer to the list head entry.
+ * @param compare Comparison function for the entries.
+ */
+void rtl_list_sort(rtl_list_entry_t* head, rtl_list_compare_t compare);
+
+/**
+ * @brief Merges a sorted list into another sorted list.
+ *        Entries that compare equal keep the ones already in head first.
+ * @param head Pointer to the head of the sorted list receiving the entries.
+ * @param other Pointer to the head of the sorted list to merge, left empty.
+ * @param compare Comparison function both lists are sorted by.
+ */
+void rtl_list_merge(rtl_list_entry_t* head, rtl_list_entry_t* other, rtl_list_compare_t compare);
+
+/**
+ * @brief List head that keeps track of its length.
+ *        Nodes are ordinary rtl_list_entry_t entries and &list->head works with every
+ *        rtl_list_for_each* macro, but entries must be added and removed through the
+ *        rtl_counted_list_* functions to keep the count right.
+ */
+typedef struct rtl_counted_list_t
+{
+  rtl_list_entry_t head; /**< Underlying list head */
+  unsigned long count;   /**< Number of entries in the list */
+} rtl_counted_list_t;
+
+/**
+ * @brief Initializes a counted list.
+ * @param list Pointer to the counted list.
+ */
+RTL_LIST_API void rtl_counted_list_init(rtl_counted_list_t* list)
+{
+  rtl_list_init(&list->head);
+  list->count = 0;
+}
+
+/**
+ * @brief Checks if a counted list is empty.
+ * @param list Pointer to the counted list.
+ * @return true if the list is empty, false otherwise.
+ */
+RTL_LIST_API bool rtl_counted_list_empty(const rtl_counted_list_t* list)
+{
+  return list->count == 0;
+}
+
+/**
+ * @brief Gets the number of entries in a counted list in O(1).
+ * @param list Pointer to the counted list.
+ * @return The number of entries in the list.
+ */
+RTL_LIST_API unsigned long rtl_counted_list_length(const rtl_counted_list_t* list)
+{
+  return list->count;
+}
+
+/**
+ * @brief Adds a new entry to the front of a counted list.
+ * @param list Pointer to the counted list.
+ * @param entry Pointer to the new entry to add.
+ */
+RTL_LIST_API void rtl_counted_list_add_head(rtl_counted_list_t* list, rtl_list_entry_t* entry)
+{
+  rtl_list_add_head(&list->head, entry);
+  list->count++;
+}
+
+/**
+ * @brief Adds a new entry to the back of a counted list.
+ * @param list Pointer to the counted list.
+ * @param entry Pointer to the new entry to add.
+ */
+RTL_LIST_API void rtl_counted_list_add_tail(rtl_counted_list_t* list, rtl_list_entry_t* entry)
+{
+  rtl_list_add_tail(&list->head, entry);
+  list->count++;
+}
+
+/**
+ * @brief Removes an entry from a counted list.
+ * @param list Pointer to the counted list the entry belongs to.
+ * @param entry Pointer to the entry to remove.
+ *        Note: entry is not freed, only removed from the list.
+ */
+RTL_LIST_API void rtl_counted_list_remove(rtl_counted_list_t* list, const rtl_list_entry_t* entry)
+{
+  rtl_list_remove(entry);
+  list->count--;
+}
+
+/**
+ * @brief Removes and returns the first entry of a counted list.
+ * @param list Pointer to the counted list.
+ * @return Pointer to the removed entry, or NULL if the list is empty.
+ */
+RTL_LIST_API rtl_list_entry_t* rtl_counted_list_pop_head(rtl_counted_list_t* list)
+{
+  if (list->count == 0) {
+    return NULL;
+  }
+
+  rtl_list_entry_t* entry = list->head.next;
+  rtl_counted_list_remove(list, entry);
+  return entry;
+}
@@ -26,6 +26,7 @@
 #include "rtl_list.h"
 #endif
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /**
@@ -41,8 +42,57 @@ typedef void* (*rtl_malloc_func_t)(size_t size);
  */
 typedef void (*rtl_free_func_t)(void* ptr);
 
-#define rtl_malloc(size) _rtl_malloc(__FILE__, __LINE__, size)
-#define rtl_strdup(str)  _rtl_strdup(__FILE__, __LINE__, str)
+#define rtl_malloc(size)             _rtl_malloc(__FILE__, __LINE__, size)
+#define rtl_malloc_tagged(tag, size) _rtl_malloc_tagged(__FILE__, __LINE__, tag, size)
+#define rtl_strdup(str)              _rtl_strdup(__FILE__, __LINE__, str)
+
+/**
+ * @brief Maximum number of allocation tags.
+ */
+#define RTL_MEM_TAG_MAX 32
+
+/**
+ * @brief Allocation tags used to account memory per subsystem.
+ *        Values from RTL_MEM_TAG_USER_FIRST up to RTL_MEM_TAG_MAX are free for applications.
+ */
+typedef enum rtl_memory_tag_t
+{
+  RTL_MEM_TAG_USER = 0,       /**< Untagged allocations made through rtl_malloc() */
+  RTL_MEM_TAG_HASH,           /**< Hash table buckets and entries */
+  RTL_MEM_TAG_RECLAIM,        /**< Retire lists of the memory reclamation schemes */
+  RTL_MEM_TAG_SCRATCH,        /**< Chunks of the per-thread scratch allocator */
+  RTL_MEM_TAG_QUEUE,          /**< Storage of bounded queues, rings and heaps */
+  RTL_MEM_TAG_SKIPLIST,       /**< Nodes of concurrent skip lists */
+  RTL_MEM_TAG_VECTOR,         /**< Storage of dynamic arrays */
+  RTL_MEM_TAG_USER_FIRST = 16 /**< First tag available for user-defined subsystems */
+} rtl_memory_tag_t;
+
+/**
+ * @brief Memory usage snapshot of a single tag.
+ */
+typedef struct rtl_memory_tag_stats_t
+{
+  size_t bytes;       /**< Bytes currently allocated */
+  size_t peak_bytes;  /**< Highest value bytes has reached */
+  size_t allocations; /**< Number of live allocations */
+  size_t limit;       /**< Soft limit in bytes, 0 if unlimited */
+} rtl_memory_tag_stats_t;
+
+/**
+ * @brief Maximum number of memory pressure callbacks that can be registered.
+ */
+#define RTL_MEMORY_MAX_PRESSURE_CALLBACKS 16
+
+/**
+ * @brief Callback invoked when memory usage crosses the soft limit.
+ *        Callbacks should release memory (evict cache entries, shrink tables)
+ *        and may call rtl_malloc() and rtl_free(); pressure is not re-signalled
+ *        from inside a callback.
+ * @param usage Memory usage that triggered the callback, in bytes.
+ * @param limit The soft limit that was crossed, in bytes.
+ * @param user_data User-provided data passed at registration.
+ */
+typedef void (*rtl_memory_pressure_callback_t)(size_t usage, size_t limit, void* user_data);
 
 /**
  * @brief Structure to store source code location information.
@@ -53,18 +103,30 @@ typedef struct rtl_source_location_t
   unsigned long line; /**< Source line number */
 } rtl_source_location_t;
 
-#ifdef RTL_DEBUG_BUILD
 /**
- * @brief Header structure prepended to memory allocations in debug builds.
- *        Contains metadata for tracking memory leaks.
+ * @brief Header structure prepended to every memory allocation.
+ *        Holds the size and tag for per-tag accounting, and in debug builds
+ *        metadata for tracking memory leaks.
  */
 typedef struct rtl_memory_header_t
 {
+#ifdef RTL_DEBUG_BUILD
   rtl_list_entry_t link;
   rtl_source_location_t source_location;
+#endif
   unsigned long size;
+  size_t tag; /**< Allocation tag, pointer-sized so the header keeps malloc alignment */
 } rtl_memory_header_t;
-#endif
+
+/**
+ * @brief Function locating the out-of-line header of a block.
+ *        Allocators that keep headers outside their blocks register one with
+ *        rtl_memory_set_header_func(), after which their malloc function receives
+ *        the caller's size without room for a header.
+ * @param ptr Pointer returned by the registered malloc function.
+ * @return The header slot owned by the block.
+ */
+typedef rtl_memory_header_t* (*rtl_memory_header_func_t)(void* ptr);
 
 /**
  * @brief Internal memory allocation function.
@@ -76,6 +138,19 @@ typedef struct rtl_memory_header_t
  */
 void* _rtl_malloc(const char* file, unsigned long line, unsigned long size);
 
+/**
+ * @brief Internal tagged memory allocation function.
+ *        Allocations are never refused because of a tag's soft limit, subsystems
+ *        check rtl_memory_tag_within_limit() before they grow.
+ * @param file Source file name where the allocation was requested.
+ * @param line Source line number where the allocation was requested.
+ * @param tag Tag the allocation is accounted to.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL on failure.
+ * @note Users should typically use the rtl_malloc_tagged() macro instead.
+ */
+void* _rtl_malloc_tagged(const char* file, unsigned long line, unsigned tag, unsigned long size);
+
 /**
  * @brief Internal string duplication function.
  * @param file Source file name where the duplication was requested.
@@ -92,9 +167,150 @@ char* _rtl_strdup(const char* file, unsigned long line, const char* str);
  */
 void rtl_free(void* data);
 
+/**
+ * @brief Sets a human-readable name for a tag, shown in leak reports.
+ * @param tag The tag to name.
+ * @param name Name with static storage duration.
+ */
+void rtl_memory_tag_set_name(unsigned tag, const char* name);
+
+/**
+ * @brief Gets the name of a tag.
+ * @param tag The tag to query.
+ * @return The tag's name, or NULL if it has none.
+ */
+const char* rtl_memory_tag_name(unsigned tag);
+
+/**
+ * @brief Sets the soft limit of a tag.
+ * @param tag The tag to limit.
+ * @param limit Budget in bytes, 0 to remove the limit.
+ */
+void rtl_memory_tag_set_limit(unsigned tag, size_t limit);
+
+/**
+ * @brief Checks whether a tag can grow by the given amount without exceeding its soft limit.
+ * @param tag The tag to check.
+ * @param size Number of bytes about to be allocated.
+ * @return true if the tag is unlimited or stays within its budget, false otherwise.
+ */
+bool rtl_memory_tag_within_limit(unsigned tag, size_t size);
+
+/**
+ * @brief Gets a snapshot of a tag's memory usage.
+ * @param tag The tag to query.
+ * @param stats Pointer to the structure receiving the snapshot.
+ */
+void rtl_memory_tag_get_stats(unsigned tag, rtl_memory_tag_stats_t* stats);
+
+/**
+ * @brief Gets the number of bytes currently allocated through rtl_malloc() across all tags.
+ * @return Tracked memory usage in bytes.
+ */
+size_t rtl_memory_usage(void);
+
+/**
+ * @brief Sets the global soft limit on tracked memory usage.
+ *        Crossing it from an allocation invokes the pressure callbacks once,
+ *        they fire again only after usage has dropped back below the limit.
+ * @param limit Limit in bytes, 0 to disable.
+ */
+void rtl_memory_set_soft_limit(size_t limit);
+
+/**
+ * @brief Gets the global soft limit.
+ * @return Limit in bytes, 0 if disabled.
+ */
+size_t rtl_memory_get_soft_limit(void);
+
+/**
+ * @brief Registers a callback invoked under memory pressure.
+ *        Callbacks also run when the underlying allocator fails, after which
+ *        the allocation is retried once.
+ * @param callback Function to call.
+ * @param user_data User data passed to the callback.
+ * @return true if registered, false if RTL_MEMORY_MAX_PRESSURE_CALLBACKS is reached.
+ */
+bool rtl_memory_register_pressure_callback(
+  rtl_memory_pressure_callback_t callback, void* user_data);
+
+/**
+ * @brief Unregisters a callback registered with the same user data.
+ * @param callback Function that was registered.
+ * @param user_data User data it was registered with.
+ */
+void rtl_memory_unregister_pressure_callback(
+  rtl_memory_pressure_callback_t callback, void* user_data);
+
+/**
+ * @brief Reads the memory usage and limit of the process's cgroup.
+ *        Supports cgroup v2 (memory.current, memory.max) and v1
+ *        (memory.usage_in_bytes, memory.limit_in_bytes).
+ * @param usage Pointer receiving the current usage in bytes.
+ * @param limit Pointer receiving the limit in bytes, 0 if unlimited. Can be NULL.
+ * @return true if the usage could be read, false otherwise (e.g. not on Linux).
+ */
+bool rtl_memory_read_cgroup(size_t* usage, size_t* limit);
+
+/**
+ * @brief Invokes the pressure callbacks if the process's cgroup is using more than
+ *        the given share of its limit. Meant to be polled, it reads from cgroupfs.
+ * @param percent Threshold in percent of the cgroup limit.
+ * @return true if the callbacks were invoked, false otherwise.
+ */
+bool rtl_memory_check_cgroup_pressure(unsigned percent);
+
+/**
+ * @brief Size of the chunks backing the per-thread scratch allocator.
+ */
+#define RTL_SCRATCH_CHUNK_SIZE (64UL * 1024UL)
+
+/**
+ * @brief Alignment of every scratch allocation.
+ */
+#define RTL_SCRATCH_ALIGNMENT 16
+
+/**
+ * @brief Position in the calling thread's scratch stack.
+ */
+typedef struct rtl_scratch_marker_t
+{
+  void* chunk;   /**< Chunk that was on top when the marker was taken */
+  size_t offset; /**< Bytes used in that chunk */
+} rtl_scratch_marker_t;
+
+/**
+ * @brief Takes a marker of the calling thread's scratch stack.
+ *        Everything allocated after it is released by rtl_scratch_pop().
+ * @return The current scratch position.
+ */
+rtl_scratch_marker_t rtl_scratch_push(void);
+
+/**
+ * @brief Allocates temporary memory from the calling thread's scratch stack.
+ *        No locking and no global allocator involvement, except when a new chunk is needed.
+ * @param size The number of bytes to allocate.
+ * @return A pointer aligned to RTL_SCRATCH_ALIGNMENT, or NULL on failure.
+ */
+void* rtl_scratch_alloc(size_t size);
+
+/**
+ * @brief Releases all scratch memory allocated since the marker was taken.
+ *        Markers must be popped in LIFO order.
+ * @param marker Marker returned by rtl_scratch_push().
+ */
+void rtl_scratch_pop(rtl_scratch_marker_t marker);
+
+/**
+ * @brief Frees all chunks owned by the calling thread's scratch stack.
+ *        Threads using scratch memory should call it before they exit.
+ */
+void rtl_scratch_release(void);
+
 /**
  * @brief Initializes the rtl memory management subsystem.
  *        Must be called before any rtl_malloc() or rtl_free() calls.
+ *        Resets all tag statistics, limits and names, the soft limit and pressure callbacks.
  *        In debug builds, initializes the allocation tracking list.
  * @param malloc_func Custom malloc function (NULL to use standard malloc)
  * @param free_func Custom free function (NULL to use standard free)
@@ -104,6 +320,16 @@ void rtl_memory_init(rtl_malloc_func_t malloc_func, rtl_free_func_t free_func);
 /**
  * @brief Cleans up the rtl memory management subsystem.
  *        Should be called at program termination.
+ *        Releases the calling thread's scratch memory.
  *        In debug builds, checks for memory leaks and reports them to stderr.
  */
 void rtl_memory_cleanup();
+
+/**
+ * @brief Moves allocation headers out of line, so the malloc function passed to
+ *        rtl_init() sees exact user sizes. Must be called while nothing is allocated;
+ *        rtl_memory_init() switches back to prepended headers.
+ *        In debug builds, leaked blocks are reported but left to their allocator.
+ * @param header_func Function locating the header of a block, or NULL to prepend headers.
+ */
+void rtl_memory_set_header_func(rtl_memory_header_func_t header_func);
@@ -0,0 +1,107 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtl_atomic.h"
+#include "rtl_platform.h"
+
+/**
+ * @brief Bounded multi-producer multi-consumer queue of fixed-size elements (Vyukov).
+ *        Every cell carries a sequence number that tells producers and consumers
+ *        whether it is free or filled for their position, so both sides claim
+ *        positions with one CAS and never touch each other's index.
+ *        Blocking operations sleep on a futex on Linux and yield elsewhere.
+ */
+typedef struct rtl_mpmc_t
+{
+  char* cells;         /**< Cell storage, each a sequence word followed by an element */
+  size_t mask;         /**< Capacity minus one, capacity is a power of two */
+  size_t element_size; /**< Size of one element in bytes */
+  size_t cell_size;    /**< Size of one cell in bytes */
+  char _pad0[RTL_CACHE_LINE_SIZE - sizeof(char*) - 3 * sizeof(size_t)];
+  rtl_atomic_word_t enqueue_pos; /**< Next position producers claim */
+  char _pad1[RTL_CACHE_LINE_SIZE - sizeof(rtl_atomic_word_t)];
+  rtl_atomic_word_t dequeue_pos; /**< Next position consumers claim */
+  char _pad2[RTL_CACHE_LINE_SIZE - sizeof(rtl_atomic_word_t)];
+  rtl_atomic_u32_t not_full;          /**< Bumped when a blocked producer may proceed */
+  rtl_atomic_u32_t not_empty;         /**< Bumped when a blocked consumer may proceed */
+  rtl_atomic_word_t producers_waiting; /**< Number of producers blocked on not_full */
+  rtl_atomic_word_t consumers_waiting; /**< Number of consumers blocked on not_empty */
+} rtl_mpmc_t;
+
+/**
+ * @brief Initializes a queue and allocates its storage.
+ * @param queue Pointer to the queue to initialize.
+ * @param capacity Number of elements, rounded up to a power of two of at least 2.
+ * @param element_size Size of one element in bytes.
+ * @return true on success, false if the storage could not be allocated.
+ */
+bool rtl_mpmc_init(rtl_mpmc_t* queue, size_t capacity, size_t element_size);
+
+/**
+ * @brief Releases the queue's storage. No thread may be using the queue.
+ * @param queue Pointer to the queue to clean up.
+ */
+void rtl_mpmc_cleanup(rtl_mpmc_t* queue);
+
+/**
+ * @brief Gets the number of elements the queue holds when full.
+ * @param queue Pointer to the queue.
+ * @return The capacity.
+ */
+size_t rtl_mpmc_capacity(const rtl_mpmc_t* queue);
+
+/**
+ * @brief Appends an element if there is room.
+ * @param queue Pointer to the queue.
+ * @param element Pointer to the element to copy in.
+ * @return true on success, false if the queue is full.
+ */
+bool rtl_mpmc_try_push(rtl_mpmc_t* queue, const void* element);
+
+/**
+ * @brief Removes the oldest element if there is one.
+ * @param queue Pointer to the queue.
+ * @param element Pointer receiving the element.
+ * @return true on success, false if the queue is empty.
+ */
+bool rtl_mpmc_try_pop(rtl_mpmc_t* queue, void* element);
+
+/**
+ * @brief Appends an element, sleeping while the queue is full.
+ * @param queue Pointer to the queue.
+ * @param element Pointer to the element to copy in.
+ */
+void rtl_mpmc_push(rtl_mpmc_t* queue, const void* element);
+
+/**
+ * @brief Removes the oldest element, sleeping while the queue is empty.
+ * @param queue Pointer to the queue.
+ * @param element Pointer receiving the element.
+ */
+void rtl_mpmc_pop(rtl_mpmc_t* queue, void* element);
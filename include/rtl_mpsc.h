@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "rtl_atomic.h"
+#include "rtl_platform.h"
+
+/**
+ * @brief Intrusive MPSC queue node, embedded in the queued structure.
+ *        Use RTL_CONTAINER_OF() to get back to the containing structure.
+ */
+typedef struct rtl_mpsc_node_t
+{
+  rtl_atomic_ptr_t next; /**< Next node towards the producers' end */
+} rtl_mpsc_node_t;
+
+/**
+ * @brief Intrusive multi-producer single-consumer queue (Vyukov).
+ *        Push is wait-free: one exchange and one store. Pop never blocks and
+ *        never allocates; it only runs on the consumer thread.
+ */
+typedef struct rtl_mpsc_t
+{
+  rtl_atomic_ptr_t head; /**< Most recently pushed node, swapped by producers */
+  char _pad[RTL_CACHE_LINE_SIZE - sizeof(rtl_atomic_ptr_t)];
+  rtl_mpsc_node_t* tail; /**< Oldest node, owned by the consumer */
+  rtl_mpsc_node_t stub;  /**< Placeholder node keeping the queue non-empty */
+} rtl_mpsc_t;
+
+/**
+ * @brief Initializes an empty queue.
+ * @param queue Pointer to the queue to initialize.
+ */
+void rtl_mpsc_init(rtl_mpsc_t* queue);
+
+/**
+ * @brief Appends a node to the queue. Safe to call from any number of threads.
+ * @param queue Pointer to the queue.
+ * @param node Pointer to the node to append, owned by the queue until popped.
+ */
+void rtl_mpsc_push(rtl_mpsc_t* queue, rtl_mpsc_node_t* node);
+
+/**
+ * @brief Removes the oldest node from the queue. Must only be called by the consumer.
+ *        A push that has swapped the head but not yet linked its node hides it and
+ *        the nodes behind it; pop returns NULL then and the caller retries later.
+ * @param queue Pointer to the queue.
+ * @return Pointer to the removed node, or NULL if no node is available.
+ */
+rtl_mpsc_node_t* rtl_mpsc_pop(rtl_mpsc_t* queue);
+
+/**
+ * @brief Checks whether the queue holds no nodes. Must only be called by the consumer.
+ *        Nodes whose push is still in flight are not counted.
+ * @param queue Pointer to the queue.
+ * @return true if the queue is empty, false otherwise.
+ */
+bool rtl_mpsc_empty(const rtl_mpsc_t* queue);
@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Allocations of at least this many bytes, and at least rtl_page_huge_size(),
+ *        are served by rtl_huge_malloc() from huge-page backed mappings; smaller
+ *        ones fall through to malloc() rather than occupy a mostly empty huge page.
+ */
+#define RTL_HUGE_MALLOC_THRESHOLD (2UL * 1024UL * 1024UL)
+
+/**
+ * @brief Flags controlling how pages are mapped by rtl_page_alloc().
+ */
+typedef enum rtl_page_flags_t
+{
+  RTL_PAGE_DEFAULT = 0,      /**< Regular pages of the system page size */
+  RTL_PAGE_HUGE = 1 << 0,    /**< Transparent huge pages hint, falls back to regular pages */
+  RTL_PAGE_HUGETLB = 1 << 1, /**< Explicit hugetlbfs pages, falls back to RTL_PAGE_HUGE */
+} rtl_page_flags_t;
+
+/**
+ * @brief Gets the size of a regular memory page.
+ * @return Page size in bytes.
+ */
+size_t rtl_page_size(void);
+
+/**
+ * @brief Gets the size of a huge memory page, queried from the system once.
+ *        On Linux it is Hugepagesize from /proc/meminfo, the size MAP_HUGETLB maps with.
+ * @return Huge page size in bytes, 2 MiB if the system doesn't report one.
+ */
+size_t rtl_page_huge_size(void);
+
+/**
+ * @brief Maps zero-filled memory directly from the operating system.
+ *        The size is rounded up to the page size, or to the huge page size
+ *        when any of the huge page flags is set.
+ * @param size Number of bytes to map.
+ * @param flags Combination of rtl_page_flags_t values.
+ * @return Pointer to the mapped memory, or NULL on failure.
+ */
+void* rtl_page_alloc(size_t size, unsigned flags);
+
+/**
+ * @brief Unmaps memory previously mapped with rtl_page_alloc().
+ * @param ptr Pointer returned by rtl_page_alloc().
+ * @param size The size passed to rtl_page_alloc().
+ * @param flags The flags passed to rtl_page_alloc().
+ */
+void rtl_page_free(void* ptr, size_t size, unsigned flags);
+
+/**
+ * @brief Reserves a range of address space without backing it by memory.
+ *        Pages must be committed with rtl_page_commit() before they are touched.
+ * @param size Number of bytes to reserve, rounded up to the page size.
+ * @return Pointer to the reserved range, or NULL on failure.
+ */
+void* rtl_page_reserve(size_t size);
+
+/**
+ * @brief Backs part of a reserved range with zero-filled, writable memory.
+ * @param ptr Page-aligned pointer inside a range returned by rtl_page_reserve().
+ * @param size Number of bytes to commit, rounded up to the page size.
+ * @return true if the pages were committed, false otherwise.
+ */
+bool rtl_page_commit(void* ptr, size_t size);
+
+/**
+ * @brief Returns committed pages to the operating system, keeping the address range reserved.
+ *        The pages read as zero if they are committed again.
+ * @param ptr Page-aligned pointer inside a range returned by rtl_page_reserve().
+ * @param size Number of bytes to decommit, rounded up to the page size.
+ */
+void rtl_page_decommit(void* ptr, size_t size);
+
+/**
+ * @brief Releases a range returned by rtl_page_reserve(), committed or not.
+ * @param ptr Pointer returned by rtl_page_reserve().
+ * @param size The size passed to rtl_page_reserve().
+ */
+void rtl_page_release(void* ptr, size_t size);
+
+/**
+ * @brief Allocation function backing large blocks with huge pages.
+ *        Matches rtl_malloc_func_t, so it can be passed to rtl_init() to put
+ *        large allocations such as hash table bucket arrays on huge pages.
+ *        Mapped blocks start on the mapping, their bookkeeping is kept out of line.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL on failure.
+ */
+void* rtl_huge_malloc(size_t size);
+
+/**
+ * @brief Frees memory previously allocated by rtl_huge_malloc().
+ *        Matches rtl_free_func_t.
+ * @param ptr Pointer to the memory block to free.
+ */
+void rtl_huge_free(void* ptr);
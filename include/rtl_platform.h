@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Inline function specifier usable from C99 and MSVC C.
+ */
+#if defined(_MSC_VER)
+#define RTL_INLINE __inline
+#else
+#define RTL_INLINE inline
+#endif
+
+/**
+ * @brief Storage class specifier for thread-local variables.
+ */
+#if defined(_MSC_VER)
+#define RTL_THREAD_LOCAL __declspec(thread)
+#else
+#define RTL_THREAD_LOCAL __thread
+#endif
+
+/**
+ * @brief Gets the structure an intrusive node or link is embedded in.
+ *        Shared by every intrusive container: lists, trees, heaps and queues.
+ * @param address The address of the embedded member.
+ * @param type The type of the struct it is embedded in.
+ * @param field The name of the member within the struct.
+ * @return A pointer to the containing structure.
+ */
+#define RTL_CONTAINER_OF(address, type, field) ((type*)((char*)(address) - offsetof(type, field)))
+
+/**
+ * @brief Assumed size of a CPU cache line, used to keep hot shared fields apart.
+ */
+#define RTL_CACHE_LINE_SIZE 64
+
+/**
+ * @brief Hints the CPU to start loading the cache line holding an address.
+ *        Never faults, so it is safe on addresses that may not be dereferenceable.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define RTL_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define RTL_PREFETCH(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#else
+#define RTL_PREFETCH(address) ((void)(address))
+#endif
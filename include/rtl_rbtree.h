@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rtl_platform.h"
+
+/**
+ * @brief Iterate over a tree in ascending order.
+ * @param position The &struct rtl_rb_node to use as a loop cursor.
+ * @param tree The tree to iterate.
+ */
+#define rtl_rbtree_for_each(position, tree)                                                        \
+  for (position = rtl_rbtree_first(tree); position; position = rtl_rbtree_next(position))
+
+/**
+ * @brief Iterate over a tree in ascending order, safe against erasing the cursor.
+ * @param position The &struct rtl_rb_node to use as a loop cursor.
+ * @param n Another &struct rtl_rb_node to use as temporary storage.
+ * @param tree The tree to iterate.
+ */
+#define rtl_rbtree_for_each_safe(position, n, tree)                                                \
+  for (position = rtl_rbtree_first(tree), n = position ? rtl_rbtree_next(position) : NULL;         \
+    position; position = n, n = position ? rtl_rbtree_next(position) : NULL)
+
+/**
+ * @brief Red-black tree node, embedded in the structures stored in the tree.
+ *        Use RTL_CONTAINER_OF() to get back to the containing structure.
+ */
+typedef struct rtl_rb_node_t
+{
+  struct rtl_rb_node_t* parent; /**< Parent node, NULL for the root */
+  struct rtl_rb_node_t* left;   /**< Subtree of smaller nodes */
+  struct rtl_rb_node_t* right;  /**< Subtree of greater or equal nodes */
+  bool red;                     /**< Node color */
+} rtl_rb_node_t;
+
+/**
+ * @brief Node comparison function type definition.
+ * @param a Pointer to the first node.
+ * @param b Pointer to the second node.
+ * @return Negative, zero or positive if a orders before, equal to or after b.
+ */
+typedef int (*rtl_rbtree_compare_t)(const rtl_rb_node_t* a, const rtl_rb_node_t* b);
+
+/**
+ * @brief Key to node comparison function type definition, used for lookups.
+ * @param key Pointer to the key being looked up.
+ * @param node Pointer to a node of the tree.
+ * @return Negative, zero or positive if the key orders before, equal to or after the node.
+ */
+typedef int (*rtl_rbtree_key_compare_t)(const void* key, const rtl_rb_node_t* node);
+
+/**
+ * @brief Intrusive red-black tree. Nodes with equal keys are allowed and kept
+ *        in insertion order. The leftmost node is cached for O(1) access to the minimum.
+ */
+typedef struct rtl_rbtree_t
+{
+  rtl_rb_node_t* root;          /**< Root node, NULL for an empty tree */
+  rtl_rb_node_t* leftmost;      /**< Smallest node, NULL for an empty tree */
+  rtl_rbtree_compare_t compare; /**< Node ordering */
+} rtl_rbtree_t;
+
+/**
+ * @brief Initializes an empty tree.
+ * @param tree Pointer to the tree to initialize.
+ * @param compare Node ordering function.
+ */
+void rtl_rbtree_init(rtl_rbtree_t* tree, rtl_rbtree_compare_t compare);
+
+/**
+ * @brief Checks whether a tree is empty.
+ * @param tree Pointer to the tree.
+ * @return true if the tree has no nodes, false otherwise.
+ */
+static RTL_INLINE bool rtl_rbtree_empty(const rtl_rbtree_t* tree)
+{
+  return tree->root == NULL;
+}
+
+/**
+ * @brief Gets the smallest node in O(1).
+ * @param tree Pointer to the tree.
+ * @return The leftmost node, or NULL if the tree is empty.
+ */
+static RTL_INLINE rtl_rb_node_t* rtl_rbtree_first(const rtl_rbtree_t* tree)
+{
+  return tree->leftmost;
+}
+
+/**
+ * @brief Gets the largest node.
+ * @param tree Pointer to the tree.
+ * @return The rightmost node, or NULL if the tree is empty.
+ */
+rtl_rb_node_t* rtl_rbtree_last(const rtl_rbtree_t* tree);
+
+/**
+ * @brief Gets the in-order successor of a node.
+ * @param node Pointer to a node in a tree.
+ * @return The next node, or NULL if node is the last one.
+ */
+rtl_rb_node_t* rtl_rbtree_next(const rtl_rb_node_t* node);
+
+/**
+ * @brief Gets the in-order predecessor of a node.
+ * @param node Pointer to a node in a tree.
+ * @return The previous node, or NULL if node is the first one.
+ */
+rtl_rb_node_t* rtl_rbtree_prev(const rtl_rb_node_t* node);
+
+/**
+ * @brief Inserts a node in O(log n), after any nodes that compare equal to it.
+ * @param tree Pointer to the tree.
+ * @param node Pointer to the node to insert, must not be in a tree.
+ */
+void rtl_rbtree_insert(rtl_rbtree_t* tree, rtl_rb_node_t* node);
+
+/**
+ * @brief Erases a node from its tree in O(log n).
+ * @param tree Pointer to the tree.
+ * @param node Pointer to the node to erase, must be in the tree.
+ */
+void rtl_rbtree_erase(rtl_rbtree_t* tree, rtl_rb_node_t* node);
+
+/**
+ * @brief Finds the first node that does not order before a key, in O(log n).
+ * @param tree Pointer to the tree.
+ * @param key Pointer to the key to look up.
+ * @param compare Function comparing the key with the nodes of the tree.
+ * @return The first node not less than key, or NULL if there is none.
+ */
+rtl_rb_node_t* rtl_rbtree_lower_bound(
+  const rtl_rbtree_t* tree, const void* key, rtl_rbtree_key_compare_t compare);
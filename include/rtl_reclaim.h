@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "rtl_atomic.h"
+#include "rtl_ebr.h"
+#include "rtl_hazard.h"
+#include "rtl_platform.h"
+
+/**
+ * @brief Operations implemented by a memory reclamation scheme.
+ */
+typedef struct rtl_reclaim_ops_t
+{
+  /**
+   * @brief Starts an operation on a shared structure.
+   */
+  void (*begin)(void* thread);
+
+  /**
+   * @brief Finishes an operation, dropping every protection it took.
+   */
+  void (*end)(void* thread);
+
+  /**
+   * @brief Loads a shared pointer and keeps its target alive until end().
+   */
+  void* (*protect)(void* thread, unsigned slot, rtl_atomic_ptr_t* source);
+
+  /**
+   * @brief Defers freeing of an unlinked node.
+   */
+  bool (*retire)(void* thread, void* ptr);
+} rtl_reclaim_ops_t;
+
+/**
+ * @brief Reclamation handle binding a thread record to its scheme.
+ *        Lets lock-free structures stay agnostic of epochs versus hazard pointers.
+ */
+typedef struct rtl_reclaim_t
+{
+  const rtl_reclaim_ops_t* ops; /**< Scheme implementation */
+  void* thread;                 /**< rtl_ebr_thread_t or rtl_hazard_thread_t record */
+} rtl_reclaim_t;
+
+/**
+ * @brief Reclamation operations backed by epochs.
+ *        Slots are ignored, begin() and end() enter and leave a critical section.
+ */
+extern const rtl_reclaim_ops_t rtl_reclaim_ebr_ops;
+
+/**
+ * @brief Reclamation operations backed by hazard pointers.
+ *        begin() is a no-op, end() clears all slots of the thread.
+ */
+extern const rtl_reclaim_ops_t rtl_reclaim_hazard_ops;
+
+/**
+ * @brief Makes a reclamation handle for a registered epoch thread record.
+ * @param reclaim Pointer to the handle to initialize.
+ * @param thread Pointer to the registered thread record.
+ */
+void rtl_reclaim_init_ebr(rtl_reclaim_t* reclaim, rtl_ebr_thread_t* thread);
+
+/**
+ * @brief Makes a reclamation handle for a registered hazard-pointer thread record.
+ * @param reclaim Pointer to the handle to initialize.
+ * @param thread Pointer to the registered thread record.
+ */
+void rtl_reclaim_init_hazard(rtl_reclaim_t* reclaim, rtl_hazard_thread_t* thread);
+
+/**
+ * @brief Starts an operation on a shared structure.
+ * @param reclaim Pointer to the reclamation handle.
+ */
+static RTL_INLINE void rtl_reclaim_begin(const rtl_reclaim_t* reclaim)
+{
+  reclaim->ops->begin(reclaim->thread);
+}
+
+/**
+ * @brief Finishes an operation started with rtl_reclaim_begin().
+ * @param reclaim Pointer to the reclamation handle.
+ */
+static RTL_INLINE void rtl_reclaim_end(const rtl_reclaim_t* reclaim)
+{
+  reclaim->ops->end(reclaim->thread);
+}
+
+/**
+ * @brief Loads a shared pointer that stays safe to dereference until rtl_reclaim_end().
+ * @param reclaim Pointer to the reclamation handle.
+ * @param slot Protection slot, less than RTL_HAZARD_SLOTS.
+ * @param source Shared location to load the pointer from.
+ * @return The loaded pointer.
+ */
+static RTL_INLINE void* rtl_reclaim_protect(
+  const rtl_reclaim_t* reclaim, unsigned slot, rtl_atomic_ptr_t* source)
+{
+  return reclaim->ops->protect(reclaim->thread, slot, source);
+}
+
+/**
+ * @brief Defers freeing of an unlinked node through rtl_free().
+ * @param reclaim Pointer to the reclamation handle.
+ * @param ptr Pointer allocated with rtl_malloc().
+ * @return true if the pointer was retired, false otherwise.
+ */
+static RTL_INLINE bool rtl_reclaim_retire(const rtl_reclaim_t* reclaim, void* ptr)
+{
+  return reclaim->ops->retire(reclaim->thread, ptr);
+}
@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtl_atomic.h"
+#include "rtl_ebr.h"
+
+/**
+ * @brief Highest tower a skip list node can have.
+ *        With a 1/4 promotion rate this covers far more keys than fit in memory.
+ */
+#define RTL_SKIPLIST_MAX_HEIGHT 16
+
+/**
+ * @brief Key comparison function type definition.
+ * @param key1 Pointer to the first key.
+ * @param key2 Pointer to the second key.
+ * @return Negative, zero or positive if key1 orders before, equal to or after key2.
+ */
+typedef int (*rtl_skiplist_compare_t)(const void* key1, const void* key2);
+
+/**
+ * @brief Range iteration callback type definition.
+ * @param key Pointer to the node's key, valid for the duration of the call.
+ * @param value Value stored with the key.
+ * @param user_data User-provided data passed to the callback.
+ * @return true to continue iterating, false to stop.
+ */
+typedef bool (*rtl_skiplist_callback_t)(const void* key, void* value, void* user_data);
+
+/**
+ * @brief Skip list node, allocated in one block with its tower and key.
+ *        Links carry a mark in their low bit once the node is being removed.
+ */
+typedef struct rtl_skiplist_node_t
+{
+  rtl_atomic_ptr_t value;   /**< Value stored with the key */
+  rtl_atomic_word_t refs;   /**< Inserter and remover references, retired at zero */
+  uintptr_t height;         /**< Number of levels the node is linked on */
+  rtl_atomic_word_t next[]; /**< Tower of links, the key follows the last one */
+} rtl_skiplist_node_t;
+
+/**
+ * @brief Concurrent ordered map from fixed-size keys to pointers.
+ *        Lock-free skip list (Fraser / Herlihy-Shavit): inserts and removals
+ *        synchronize on single CAS operations per level, lookups never write.
+ *        Removed nodes are released with rtl_free() through epoch-based reclamation,
+ *        so every operation takes the calling thread's registered rtl_ebr_thread_t.
+ */
+typedef struct rtl_skiplist_t
+{
+  rtl_skiplist_node_t* head;      /**< Sentinel with a full-height tower */
+  rtl_skiplist_compare_t compare; /**< Key ordering */
+  size_t key_size;                /**< Size of every key in bytes */
+} rtl_skiplist_t;
+
+/**
+ * @brief Initializes an empty skip list.
+ * @param list Pointer to the list to initialize.
+ * @param key_size Size of every key in bytes.
+ * @param compare Key ordering function.
+ * @return true on success, false if the head node could not be allocated.
+ */
+bool rtl_skiplist_init(rtl_skiplist_t* list, size_t key_size, rtl_skiplist_compare_t compare);
+
+/**
+ * @brief Frees every node of the list. No thread may be using the list, and
+ *        nodes retired earlier are freed by their reclamation domain.
+ * @param list Pointer to the list to clean up.
+ */
+void rtl_skiplist_cleanup(rtl_skiplist_t* list);
+
+/**
+ * @brief Inserts a key if it is not present yet.
+ * @param list Pointer to the list.
+ * @param thread Calling thread's reclamation record.
+ * @param key Pointer to the key, copied into the node.
+ * @param value Value to store with the key.
+ * @return true if the key was inserted, false if it was present or allocation failed.
+ */
+bool rtl_skiplist_insert(
+  rtl_skiplist_t* list, rtl_ebr_thread_t* thread, const void* key, void* value);
+
+/**
+ * @brief Removes a key.
+ * @param list Pointer to the list.
+ * @param thread Calling thread's reclamation record.
+ * @param key Pointer to the key to remove.
+ * @param value Receives the value that was stored with the key, can be NULL.
+ * @return true if this call removed the key, false if it was not present.
+ */
+bool rtl_skiplist_remove(
+  rtl_skiplist_t* list, rtl_ebr_thread_t* thread, const void* key, void** value);
+
+/**
+ * @brief Looks up a key.
+ * @param list Pointer to the list.
+ * @param thread Calling thread's reclamation record.
+ * @param key Pointer to the key to look up.
+ * @param value Receives the value stored with the key, can be NULL.
+ * @return true if the key is present, false otherwise.
+ */
+bool rtl_skiplist_find(
+  rtl_skiplist_t* list, rtl_ebr_thread_t* thread, const void* key, void** value);
+
+/**
+ * @brief Calls a function for every key in [from, to) in ascending order.
+ *        Keys inserted or removed concurrently may or may not be visited.
+ * @param list Pointer to the list.
+ * @param thread Calling thread's reclamation record.
+ * @param from Lowest key to visit, NULL to start at the smallest key.
+ * @param to Key to stop before, NULL to run to the largest key.
+ * @param callback Function called for each key.
+ * @param user_data User data to pass to the callback function.
+ * @return Number of keys passed to the callback.
+ */
+unsigned long rtl_skiplist_for_each_range(rtl_skiplist_t* list, rtl_ebr_thread_t* thread,
+  const void* from, const void* to, rtl_skiplist_callback_t callback, void* user_data);
@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtl_atomic.h"
+#include "rtl_platform.h"
+
+/**
+ * @brief Bounded single-producer single-consumer ring of fixed-size elements.
+ *        The producer and consumer indices live on separate cache lines, and
+ *        each side keeps a cached copy of the other's index so it only touches
+ *        the shared line when the cached value says the ring is full or empty.
+ */
+typedef struct rtl_spsc_t
+{
+  char* buffer;        /**< Element storage, capacity * element_size bytes */
+  size_t mask;         /**< Capacity minus one, capacity is a power of two */
+  size_t element_size; /**< Size of one element in bytes */
+  char _pad0[RTL_CACHE_LINE_SIZE - sizeof(char*) - 2 * sizeof(size_t)];
+  rtl_atomic_word_t head; /**< Next element to read, written by the consumer */
+  uintptr_t cached_tail;  /**< Consumer's last view of tail */
+  char _pad1[RTL_CACHE_LINE_SIZE - 2 * sizeof(uintptr_t)];
+  rtl_atomic_word_t tail; /**< Next slot to write, written by the producer */
+  uintptr_t cached_head;  /**< Producer's last view of head */
+  char _pad2[RTL_CACHE_LINE_SIZE - 2 * sizeof(uintptr_t)];
+} rtl_spsc_t;
+
+/**
+ * @brief Initializes a ring and allocates its storage.
+ * @param ring Pointer to the ring to initialize.
+ * @param capacity Number of elements, rounded up to a power of two.
+ * @param element_size Size of one element in bytes.
+ * @return true on success, false if the storage could not be allocated.
+ */
+bool rtl_spsc_init(rtl_spsc_t* ring, size_t capacity, size_t element_size);
+
+/**
+ * @brief Releases the ring's storage.
+ * @param ring Pointer to the ring to clean up.
+ */
+void rtl_spsc_cleanup(rtl_spsc_t* ring);
+
+/**
+ * @brief Gets the number of elements the ring holds when full.
+ * @param ring Pointer to the ring.
+ * @return The capacity.
+ */
+size_t rtl_spsc_capacity(const rtl_spsc_t* ring);
+
+/**
+ * @brief Gets the number of queued elements. Exact when called by either side
+ *        while the other is idle, a snapshot otherwise.
+ * @param ring Pointer to the ring.
+ * @return The number of elements.
+ */
+size_t rtl_spsc_size(const rtl_spsc_t* ring);
+
+/**
+ * @brief Appends one element. Producer only.
+ * @param ring Pointer to the ring.
+ * @param element Pointer to the element to copy in.
+ * @return true on success, false if the ring is full.
+ */
+bool rtl_spsc_push(rtl_spsc_t* ring, const void* element);
+
+/**
+ * @brief Removes the oldest element. Consumer only.
+ * @param ring Pointer to the ring.
+ * @param element Pointer receiving the element.
+ * @return true on success, false if the ring is empty.
+ */
+bool rtl_spsc_pop(rtl_spsc_t* ring, void* element);
+
+/**
+ * @brief Appends as many elements as fit, publishing them together. Producer only.
+ * @param ring Pointer to the ring.
+ * @param elements Pointer to a contiguous array of elements.
+ * @param count Number of elements in the array.
+ * @return The number of elements appended, from the start of the array.
+ */
+size_t rtl_spsc_push_batch(rtl_spsc_t* ring, const void* elements, size_t count);
+
+/**
+ * @brief Removes up to count of the oldest elements at once. Consumer only.
+ * @param ring Pointer to the ring.
+ * @param elements Pointer to an array receiving the elements.
+ * @param count Maximum number of elements to remove.
+ * @return The number of elements removed.
+ */
+size_t rtl_spsc_pop_batch(rtl_spsc_t* ring, void* elements, size_t count);
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Magic bytes at the start of every trace file.
+ */
+#define RTL_TRACE_MAGIC "RTLTRACE"
+
+/**
+ * @brief Version of the trace file format.
+ */
+#define RTL_TRACE_VERSION 1
+
+/**
+ * @brief Number of records per trace buffer. The thread that fills the last slot
+ *        of a buffer writes it to the file, other threads keep appending to the next one.
+ */
+#define RTL_TRACE_BUFFER_RECORDS 4096
+
+/**
+ * @brief Number of trace buffers in the ring. Allocating threads only wait when
+ *        all of them are full and still being written.
+ */
+#define RTL_TRACE_BUFFERS 4
+
+/**
+ * @brief Operation stored in a trace record.
+ */
+typedef enum rtl_trace_op_t
+{
+  RTL_TRACE_OP_MALLOC = 1, /**< Allocation through rtl_malloc() */
+  RTL_TRACE_OP_FREE = 2,   /**< Deallocation through rtl_free() */
+} rtl_trace_op_t;
+
+/**
+ * @brief Header written once at the start of a trace file.
+ */
+typedef struct rtl_trace_file_header_t
+{
+  char magic[8];        /**< RTL_TRACE_MAGIC without the terminator */
+  uint32_t version;     /**< RTL_TRACE_VERSION */
+  uint32_t record_size; /**< sizeof(rtl_trace_record_t) */
+} rtl_trace_file_header_t;
+
+/**
+ * @brief A single allocator event, 32 bytes on every platform.
+ */
+typedef struct rtl_trace_record_t
+{
+  uint64_t timestamp; /**< Nanoseconds since the trace was started */
+  uint64_t ptr_id;    /**< Address of the block, unique among live blocks */
+  uint64_t size;      /**< Requested size of the block */
+  uint32_t thread;    /**< Small per-thread identifier, assigned on first use */
+  uint16_t op;        /**< rtl_trace_op_t */
+  uint16_t tag;       /**< Memory tag of the block */
+} rtl_trace_record_t;
+
+/**
+ * @brief Starts recording rtl_malloc() and rtl_free() calls to a file.
+ * @param path Path of the trace file, truncated if it exists.
+ * @return true on success, false if a trace is already running or the file can't be opened.
+ */
+bool rtl_trace_start(const char* path);
+
+/**
+ * @brief Stops recording, flushes buffered records and closes the file.
+ */
+void rtl_trace_stop(void);
+
+/**
+ * @brief Flushes the records of every completed buffer to the trace file.
+ *        Records in the partially filled buffer are written when it fills up or
+ *        when the trace stops.
+ * @return true on success, false if a write failed or no trace is running.
+ */
+bool rtl_trace_flush(void);
+
+/**
+ * @brief Checks whether a trace is being recorded.
+ * @return true if recording, false otherwise.
+ */
+bool rtl_trace_active(void);
+
+/**
+ * @internal
+ * @brief Appends a record to the trace ring, a no-op when no trace is running.
+ * @param op rtl_trace_op_t of the event.
+ * @param tag Memory tag of the block.
+ * @param size Requested size of the block.
+ * @param ptr Address identifying the block.
+ */
+void _rtl_trace_record(unsigned op, unsigned tag, size_t size, const void* ptr);
@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rtl_platform.h"
+
+/**
+ * @brief Alignment of a vector's first element.
+ */
+#define RTL_VECTOR_ALIGNMENT RTL_CACHE_LINE_SIZE
+
+/**
+ * @brief Capacity of a vector's first allocation.
+ */
+#define RTL_VECTOR_INITIAL_CAPACITY 8
+
+/**
+ * @brief Element source for rtl_vector_append_iter().
+ * @param element Slot in the vector to write the next element to.
+ * @param user_data User-provided data passed to the iterator.
+ * @return true if an element was written, false once the source is exhausted.
+ */
+typedef bool (*rtl_vector_iterator_t)(void* element, void* user_data);
+
+/**
+ * @brief Growable contiguous array of fixed-size elements.
+ *        Storage is allocated through rtl_malloc_tagged() and aligned to
+ *        RTL_VECTOR_ALIGNMENT, capacity doubles when it runs out.
+ */
+typedef struct rtl_vector_t
+{
+  void* allocation;    /**< Block returned by the allocator, NULL if none */
+  char* data;          /**< Aligned first element */
+  size_t count;        /**< Number of elements */
+  size_t capacity;     /**< Number of elements the storage holds */
+  size_t element_size; /**< Size of one element in bytes */
+} rtl_vector_t;
+
+/**
+ * @brief Initializes an empty vector. No storage is allocated until it is needed.
+ * @param vector Pointer to the vector to initialize.
+ * @param element_size Size of one element in bytes.
+ */
+void rtl_vector_init(rtl_vector_t* vector, size_t element_size);
+
+/**
+ * @brief Releases the vector's storage.
+ * @param vector Pointer to the vector to clean up.
+ */
+void rtl_vector_cleanup(rtl_vector_t* vector);
+
+/**
+ * @brief Gets the number of elements in the vector.
+ * @param vector Pointer to the vector.
+ * @return The number of elements.
+ */
+static RTL_INLINE size_t rtl_vector_size(const rtl_vector_t* vector)
+{
+  return vector->count;
+}
+
+/**
+ * @brief Gets the number of elements the vector holds without reallocating.
+ * @param vector Pointer to the vector.
+ * @return The capacity.
+ */
+static RTL_INLINE size_t rtl_vector_capacity(const rtl_vector_t* vector)
+{
+  return vector->capacity;
+}
+
+/**
+ * @brief Checks whether a vector is empty.
+ * @param vector Pointer to the vector.
+ * @return true if the vector has no elements, false otherwise.
+ */
+static RTL_INLINE bool rtl_vector_empty(const rtl_vector_t* vector)
+{
+  return vector->count == 0;
+}
+
+/**
+ * @brief Gets the element storage, valid until the vector is reallocated.
+ * @param vector Pointer to the vector.
+ * @return Pointer to the first element, or NULL if no storage is allocated.
+ */
+static RTL_INLINE void* rtl_vector_data(const rtl_vector_t* vector)
+{
+  return vector->data;
+}
+
+/**
+ * @brief Gets an element, valid until the vector is reallocated.
+ * @param vector Pointer to the vector.
+ * @param index Index of the element, must be less than the size.
+ * @return Pointer to the element.
+ */
+static RTL_INLINE void* rtl_vector_at(const rtl_vector_t* vector, size_t index)
+{
+  return vector->data + index * vector->element_size;
+}
+
+/**
+ * @brief Removes every element, keeping the storage.
+ * @param vector Pointer to the vector.
+ */
+static RTL_INLINE void rtl_vector_clear(rtl_vector_t* vector)
+{
+  vector->count = 0;
+}
+
+/**
+ * @brief Grows the storage to hold at least the given number of elements.
+ * @param vector Pointer to the vector.
+ * @param capacity Number of elements to make room for.
+ * @return true on success, false if the storage could not be allocated.
+ */
+bool rtl_vector_reserve(rtl_vector_t* vector, size_t capacity);
+
+/**
+ * @brief Shrinks the storage to the current size, freeing it if the vector is empty.
+ * @param vector Pointer to the vector.
+ * @return true on success, false if the smaller storage could not be allocated.
+ */
+bool rtl_vector_shrink(rtl_vector_t* vector);
+
+/**
+ * @brief Appends an element in amortized O(1).
+ * @param vector Pointer to the vector.
+ * @param element Pointer to the element to copy in, may be an element of this vector.
+ * @return true on success, false if the storage could not grow.
+ */
+bool rtl_vector_push_back(rtl_vector_t* vector, const void* element);
+
+/**
+ * @brief Removes the last element.
+ * @param vector Pointer to the vector.
+ * @param element Pointer receiving the element, can be NULL.
+ * @return true on success, false if the vector is empty.
+ */
+bool rtl_vector_pop_back(rtl_vector_t* vector, void* element);
+
+/**
+ * @brief Inserts a range of elements before an index.
+ * @param vector Pointer to the vector.
+ * @param index Position to insert at, at most the size.
+ * @param elements Pointer to the elements to copy in, may be a range of this vector.
+ * @param count Number of elements to insert.
+ * @return true on success, false if the storage could not grow.
+ */
+bool rtl_vector_insert(rtl_vector_t* vector, size_t index, const void* elements, size_t count);
+
+/**
+ * @brief Removes a range of elements, shifting the following ones down.
+ * @param vector Pointer to the vector.
+ * @param index Index of the first element to remove.
+ * @param count Number of elements to remove, the range must lie within the vector.
+ */
+void rtl_vector_erase(rtl_vector_t* vector, size_t index, size_t count);
+
+/**
+ * @brief Appends a range of elements.
+ * @param vector Pointer to the vector.
+ * @param elements Pointer to the elements to copy in, may be a range of this vector.
+ * @param count Number of elements to append.
+ * @return true on success, false if the storage could not grow.
+ */
+bool rtl_vector_append(rtl_vector_t* vector, const void* elements, size_t count);
+
+/**
+ * @brief Appends every element an iterator produces, written straight into the storage.
+ * @param vector Pointer to the vector.
+ * @param iterator Function producing the elements.
+ * @param user_data User data to pass to the iterator.
+ * @param size_hint Expected number of elements, reserved up front, 0 if unknown.
+ * @return true on success, false if the storage could not grow. Elements appended
+ *         before the failure are kept.
+ */
+bool rtl_vector_append_iter(
+  rtl_vector_t* vector, rtl_vector_iterator_t iterator, void* user_data, size_t size_hint);
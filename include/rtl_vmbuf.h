@@ -0,0 +1,90 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Minimum number of bytes committed at once when a buffer grows.
+ */
+#define RTL_VMBUF_COMMIT_GRANULARITY (64UL * 1024UL)
+
+/**
+ * @brief Growable buffer over a reserved virtual address range.
+ *        The range is reserved once and pages are committed on demand,
+ *        so the data never moves and growing never copies.
+ */
+typedef struct rtl_vmbuf_t
+{
+  char* data;       /**< Start of the reserved range, stable for the buffer lifetime */
+  size_t size;      /**< Number of bytes in use */
+  size_t committed; /**< Number of bytes backed by memory */
+  size_t reserved;  /**< Number of bytes of reserved address space */
+} rtl_vmbuf_t;
+
+/**
+ * @brief Initializes a buffer, reserving address space for its maximum size.
+ * @param buf Pointer to the buffer structure to initialize.
+ * @param max_size Upper bound the buffer can ever grow to, in bytes.
+ * @return true if the address range was reserved, false otherwise.
+ */
+bool rtl_vmbuf_init(rtl_vmbuf_t* buf, size_t max_size);
+
+/**
+ * @brief Releases the buffer's address range and all committed memory.
+ * @param buf Pointer to the buffer to clean up.
+ */
+void rtl_vmbuf_cleanup(rtl_vmbuf_t* buf);
+
+/**
+ * @brief Makes sure at least capacity bytes are committed.
+ * @param buf Pointer to the buffer.
+ * @param capacity Number of bytes that must be usable.
+ * @return true on success, false if capacity exceeds the reservation or commit failed.
+ */
+bool rtl_vmbuf_reserve(rtl_vmbuf_t* buf, size_t capacity);
+
+/**
+ * @brief Changes the number of bytes in use, committing pages as needed.
+ *        Bytes exposed by growing are zero unless they were used before.
+ * @param buf Pointer to the buffer.
+ * @param size New size in bytes.
+ * @return true on success, false if the buffer could not grow.
+ */
+bool rtl_vmbuf_resize(rtl_vmbuf_t* buf, size_t size);
+
+/**
+ * @brief Appends uninitialized space to the end of the buffer.
+ * @param buf Pointer to the buffer.
+ * @param size Number of bytes to append.
+ * @return Pointer to the appended bytes, or NULL if the buffer could not grow.
+ */
+void* rtl_vmbuf_push(rtl_vmbuf_t* buf, size_t size);
+
+/**
+ * @brief Decommits whole pages past the bytes in use, returning them to the system.
+ * @param buf Pointer to the buffer.
+ */
+void rtl_vmbuf_shrink(rtl_vmbuf_t* buf);
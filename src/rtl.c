@@ -23,6 +23,7 @@
 #include "rtl.h"
 
 #include "rtl_memory.h"
+#include "rtl_trace.h"
 
 void rtl_init(rtl_malloc_func_t malloc_func, rtl_free_func_t free_func)
 {
@@ -31,5 +32,6 @@ void rtl_init(rtl_malloc_func_t malloc_func, rtl_free_func_t free_func)
 
 void rtl_cleanup()
 {
+  rtl_trace_stop();
   rtl_memory_cleanup();
 }
@@ -0,0 +1,304 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_buddy.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_page.h"
+
+/**
+ * @internal
+ * @brief Flag in the orders array marking the first smallest block of a free block.
+ */
+#define RTL_BUDDY_FREE 0x80
+
+/**
+ * @internal
+ * @brief Buddy allocator backing rtl_buddy_malloc().
+ */
+static rtl_buddy_t* g_bound_buddy = NULL;
+
+/**
+ * @internal
+ * @brief Rounds a size up to the next power of two.
+ */
+static size_t _rtl_buddy_round_pow2(size_t size)
+{
+  size_t result = 1;
+  while (result < size) {
+    result <<= 1;
+  }
+  return result;
+}
+
+/**
+ * @internal
+ * @brief Gets the index of a block in units of the smallest block.
+ */
+static size_t _rtl_buddy_index(const rtl_buddy_t* buddy, const void* ptr)
+{
+  return (size_t)((const char*)ptr - buddy->base) / buddy->min_block;
+}
+
+/**
+ * @internal
+ * @brief Gets the list entry stored in a free block.
+ */
+static rtl_list_entry_t* _rtl_buddy_block(const rtl_buddy_t* buddy, size_t index)
+{
+  return (rtl_list_entry_t*)(buddy->base + index * buddy->min_block);
+}
+
+bool rtl_buddy_init(rtl_buddy_t* buddy, size_t size, size_t min_block, unsigned page_flags)
+{
+  rtl_assert(buddy != NULL, "Buddy allocator cannot be NULL");
+  rtl_assert(size > 0, "Region size must be greater than 0");
+
+  if (min_block < RTL_BUDDY_MIN_BLOCK) {
+    min_block = RTL_BUDDY_MIN_BLOCK;
+  }
+  min_block = _rtl_buddy_round_pow2(min_block);
+  size = _rtl_buddy_round_pow2(size < min_block ? min_block : size);
+
+  unsigned max_order = 0;
+  while ((min_block << max_order) < size) {
+    max_order++;
+  }
+  rtl_assert(max_order < RTL_BUDDY_MAX_ORDERS, "Region has too many orders: %u", max_order);
+
+  const size_t block_count = size / min_block;
+  buddy->base = rtl_page_alloc(size, page_flags);
+  if (!buddy->base) {
+    return false;
+  }
+
+  // Metadata is mapped directly so the allocator can back rtl_malloc() itself
+  buddy->orders = rtl_page_alloc(block_count, RTL_PAGE_DEFAULT);
+  if (!buddy->orders) {
+    rtl_page_free(buddy->base, size, page_flags);
+    buddy->base = NULL;
+    return false;
+  }
+
+  buddy->size = size;
+  buddy->min_block = min_block;
+  buddy->max_order = max_order;
+  buddy->page_flags = page_flags;
+  buddy->headers = NULL;
+  buddy->used = 0;
+  rtl_atomic_store_relaxed(&buddy->lock, 0);
+
+  for (unsigned i = 0; i < RTL_BUDDY_MAX_ORDERS; i++) {
+    rtl_list_init(&buddy->free_lists[i]);
+  }
+
+  // The whole region starts out as a single free block
+  buddy->orders[0] = RTL_BUDDY_FREE | (unsigned char)max_order;
+  rtl_list_add_head(&buddy->free_lists[max_order], _rtl_buddy_block(buddy, 0));
+
+  return true;
+}
+
+void rtl_buddy_cleanup(rtl_buddy_t* buddy)
+{
+  if (!buddy || !buddy->base) {
+    return;
+  }
+
+  if (g_bound_buddy == buddy) {
+    if (buddy->used > 0) {
+      rtl_log_err("Bound buddy allocator kept alive, %lu bytes are still allocated",
+        (unsigned long)buddy->used);
+      return;
+    }
+    g_bound_buddy = NULL;
+  }
+
+  if (buddy->used > 0) {
+    rtl_log_wrn("Buddy allocator released with %lu bytes still allocated",
+      (unsigned long)buddy->used);
+  }
+
+  const size_t block_count = buddy->size / buddy->min_block;
+  if (buddy->headers) {
+    rtl_page_free(buddy->headers, block_count * sizeof(rtl_memory_header_t), RTL_PAGE_DEFAULT);
+    buddy->headers = NULL;
+  }
+  rtl_page_free(buddy->orders, block_count, RTL_PAGE_DEFAULT);
+  rtl_page_free(buddy->base, buddy->size, buddy->page_flags);
+  buddy->base = NULL;
+  buddy->orders = NULL;
+  buddy->size = 0;
+  buddy->used = 0;
+}
+
+void* rtl_buddy_alloc(rtl_buddy_t* buddy, size_t size)
+{
+  rtl_assert(buddy != NULL, "Buddy allocator cannot be NULL");
+
+  unsigned order = 0;
+  while ((buddy->min_block << order) < size) {
+    if (++order > buddy->max_order) {
+      return NULL;
+    }
+  }
+
+  rtl_atomic_lock(&buddy->lock);
+
+  // Find the smallest free block that fits
+  unsigned current = order;
+  while (current <= buddy->max_order && rtl_list_empty(&buddy->free_lists[current])) {
+    current++;
+  }
+  if (current > buddy->max_order) {
+    rtl_atomic_unlock(&buddy->lock);
+    return NULL;
+  }
+
+  rtl_list_entry_t* block = buddy->free_lists[current].next;
+  rtl_list_remove(block);
+  const size_t index = _rtl_buddy_index(buddy, block);
+
+  // Split it down, returning the upper halves to the free lists
+  while (current > order) {
+    current--;
+    const size_t half = index + ((size_t)1 << current);
+    buddy->orders[half] = RTL_BUDDY_FREE | (unsigned char)current;
+    rtl_list_add_head(&buddy->free_lists[current], _rtl_buddy_block(buddy, half));
+  }
+
+  buddy->orders[index] = (unsigned char)order;
+  buddy->used += buddy->min_block << order;
+
+  rtl_atomic_unlock(&buddy->lock);
+  return block;
+}
+
+void rtl_buddy_free(rtl_buddy_t* buddy, void* ptr)
+{
+  rtl_assert(buddy != NULL, "Buddy allocator cannot be NULL");
+
+  if (ptr == NULL) {
+    return;
+  }
+
+  rtl_assert(rtl_buddy_owns(buddy, ptr), "Pointer %p is not owned by the buddy allocator", ptr);
+
+  rtl_atomic_lock(&buddy->lock);
+
+  size_t index = _rtl_buddy_index(buddy, ptr);
+  unsigned order = buddy->orders[index];
+  rtl_assert(!(order & RTL_BUDDY_FREE), "Double free of buddy block %p", ptr);
+  buddy->used -= buddy->min_block << order;
+
+  // Merge with the buddy as long as it is a whole free block of the same order
+  while (order < buddy->max_order) {
+    const size_t sibling = index ^ ((size_t)1 << order);
+    if (buddy->orders[sibling] != (RTL_BUDDY_FREE | order)) {
+      break;
+    }
+    rtl_list_remove(_rtl_buddy_block(buddy, sibling));
+    buddy->orders[sibling] = 0;
+    buddy->orders[index] = 0;
+    index &= ~((size_t)1 << order);
+    order++;
+  }
+
+  buddy->orders[index] = RTL_BUDDY_FREE | (unsigned char)order;
+  rtl_list_add_head(&buddy->free_lists[order], _rtl_buddy_block(buddy, index));
+
+  rtl_atomic_unlock(&buddy->lock);
+}
+
+size_t rtl_buddy_block_size(const rtl_buddy_t* buddy, const void* ptr)
+{
+  rtl_assert(rtl_buddy_owns(buddy, ptr), "Pointer %p is not owned by the buddy allocator", ptr);
+  return buddy->min_block << (buddy->orders[_rtl_buddy_index(buddy, ptr)] & ~RTL_BUDDY_FREE);
+}
+
+bool rtl_buddy_owns(const rtl_buddy_t* buddy, const void* ptr)
+{
+  return buddy->base != NULL && (const char*)ptr >= buddy->base &&
+    (const char*)ptr < buddy->base + buddy->size;
+}
+
+bool rtl_buddy_bind(rtl_buddy_t* buddy)
+{
+  if (g_bound_buddy == buddy) {
+    return true;
+  }
+
+  // Blocks of the old allocator would otherwise reach free()
+  if (g_bound_buddy && g_bound_buddy->used > 0) {
+    rtl_log_wrn("Buddy allocator cannot be unbound, %lu bytes are still allocated",
+      (unsigned long)g_bound_buddy->used);
+    return false;
+  }
+
+  if (buddy && !buddy->headers) {
+    // Mapped lazily, only the slots of blocks actually handed out get touched
+    buddy->headers = rtl_page_alloc(
+      buddy->size / buddy->min_block * sizeof(rtl_memory_header_t), RTL_PAGE_DEFAULT);
+    if (!buddy->headers) {
+      return false;
+    }
+  }
+
+  g_bound_buddy = buddy;
+  return true;
+}
+
+void* rtl_buddy_malloc(size_t size)
+{
+  if (g_bound_buddy) {
+    void* ptr = rtl_buddy_alloc(g_bound_buddy, size);
+    if (ptr) {
+      return ptr;
+    }
+  }
+
+  // Fallback blocks carry their header in front, wherever rtl_malloc() puts its own
+  char* data = malloc(sizeof(rtl_memory_header_t) + size);
+  return data ? data + sizeof(rtl_memory_header_t) : NULL;
+}
+
+void rtl_buddy_free_hook(void* ptr)
+{
+  if (g_bound_buddy && rtl_buddy_owns(g_bound_buddy, ptr)) {
+    rtl_buddy_free(g_bound_buddy, ptr);
+  } else {
+    free((char*)ptr - sizeof(rtl_memory_header_t));
+  }
+}
+
+rtl_memory_header_t* rtl_buddy_header(void* ptr)
+{
+  if (g_bound_buddy && rtl_buddy_owns(g_bound_buddy, ptr)) {
+    return &g_bound_buddy->headers[_rtl_buddy_index(g_bound_buddy, ptr)];
+  }
+  return (rtl_memory_header_t*)((char*)ptr - sizeof(rtl_memory_header_t));
+}
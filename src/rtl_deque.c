@@ -0,0 +1,285 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_deque.h"
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Takes a spare chunk or allocates a new one.
+ */
+static rtl_deque_chunk_t* _rtl_deque_chunk_get(rtl_deque_t* deque)
+{
+  rtl_list_entry_t* entry = rtl_counted_list_pop_head(&deque->spare);
+  if (entry) {
+    return rtl_list_record(entry, rtl_deque_chunk_t, link);
+  }
+  return rtl_malloc_tagged(RTL_MEM_TAG_QUEUE, sizeof(rtl_deque_chunk_t));
+}
+
+/**
+ * @internal
+ * @brief Unlinks an emptied chunk and keeps it as a spare, or frees it.
+ */
+static void _rtl_deque_chunk_put(rtl_deque_t* deque, rtl_deque_chunk_t* chunk)
+{
+  rtl_list_remove(&chunk->link);
+  if (rtl_counted_list_length(&deque->spare) < RTL_DEQUE_SPARE_CHUNKS) {
+    rtl_counted_list_add_head(&deque->spare, &chunk->link);
+  } else {
+    rtl_free(chunk);
+  }
+}
+
+/**
+ * @internal
+ * @brief Gets the chunk holding the front element.
+ */
+static RTL_INLINE rtl_deque_chunk_t* _rtl_deque_first(const rtl_deque_t* deque)
+{
+  return rtl_list_record(deque->chunks.next, rtl_deque_chunk_t, link);
+}
+
+/**
+ * @internal
+ * @brief Gets the chunk holding the back element.
+ */
+static RTL_INLINE rtl_deque_chunk_t* _rtl_deque_last(const rtl_deque_t* deque)
+{
+  return rtl_list_record(deque->chunks.prev, rtl_deque_chunk_t, link);
+}
+
+/**
+ * @internal
+ * @brief Links the first chunk of an empty deque, starting in its middle so
+ *        either end can grow without allocating right away.
+ */
+static bool _rtl_deque_start(rtl_deque_t* deque)
+{
+  rtl_deque_chunk_t* chunk = _rtl_deque_chunk_get(deque);
+  if (!chunk) {
+    return false;
+  }
+
+  rtl_list_add_tail(&deque->chunks, &chunk->link);
+  deque->head_index = RTL_DEQUE_CHUNK_SIZE / 2;
+  deque->tail_index = RTL_DEQUE_CHUNK_SIZE / 2;
+  return true;
+}
+
+void rtl_deque_init(rtl_deque_t* deque)
+{
+  rtl_assert(deque != NULL, "Deque cannot be NULL");
+
+  rtl_list_init(&deque->chunks);
+  rtl_counted_list_init(&deque->spare);
+  deque->head_index = 0;
+  deque->tail_index = 0;
+  deque->count = 0;
+}
+
+void rtl_deque_cleanup(rtl_deque_t* deque)
+{
+  if (!deque) {
+    return;
+  }
+
+  rtl_list_entry_t* entry;
+  rtl_list_entry_t* n;
+  rtl_list_for_each_safe(entry, n, &deque->chunks)
+  {
+    rtl_free(rtl_list_record(entry, rtl_deque_chunk_t, link));
+  }
+  while ((entry = rtl_counted_list_pop_head(&deque->spare)) != NULL) {
+    rtl_free(rtl_list_record(entry, rtl_deque_chunk_t, link));
+  }
+
+  rtl_deque_init(deque);
+}
+
+bool rtl_deque_push_back(rtl_deque_t* deque, void* item)
+{
+  rtl_assert(deque != NULL, "Deque cannot be NULL");
+
+  if (deque->count == 0) {
+    if (rtl_list_empty(&deque->chunks) && !_rtl_deque_start(deque)) {
+      return false;
+    }
+  } else if (deque->tail_index == RTL_DEQUE_CHUNK_SIZE) {
+    rtl_deque_chunk_t* chunk = _rtl_deque_chunk_get(deque);
+    if (!chunk) {
+      return false;
+    }
+    rtl_list_add_tail(&deque->chunks, &chunk->link);
+    deque->tail_index = 0;
+  }
+
+  _rtl_deque_last(deque)->items[deque->tail_index++] = item;
+  deque->count++;
+  return true;
+}
+
+bool rtl_deque_push_front(rtl_deque_t* deque, void* item)
+{
+  rtl_assert(deque != NULL, "Deque cannot be NULL");
+
+  if (deque->count == 0) {
+    if (rtl_list_empty(&deque->chunks) && !_rtl_deque_start(deque)) {
+      return false;
+    }
+  } else if (deque->head_index == 0) {
+    rtl_deque_chunk_t* chunk = _rtl_deque_chunk_get(deque);
+    if (!chunk) {
+      return false;
+    }
+    rtl_list_add_head(&deque->chunks, &chunk->link);
+    deque->head_index = RTL_DEQUE_CHUNK_SIZE;
+  }
+
+  _rtl_deque_first(deque)->items[--deque->head_index] = item;
+  deque->count++;
+  return true;
+}
+
+bool rtl_deque_pop_back(rtl_deque_t* deque, void** item)
+{
+  rtl_assert(deque != NULL, "Deque cannot be NULL");
+
+  if (deque->count == 0) {
+    return false;
+  }
+
+  rtl_deque_chunk_t* chunk = _rtl_deque_last(deque);
+  void* value = chunk->items[--deque->tail_index];
+  deque->count--;
+
+  if (deque->count == 0) {
+    // Keep the last chunk linked and recentre it for the next push
+    deque->head_index = RTL_DEQUE_CHUNK_SIZE / 2;
+    deque->tail_index = RTL_DEQUE_CHUNK_SIZE / 2;
+  } else if (deque->tail_index == 0) {
+    _rtl_deque_chunk_put(deque, chunk);
+    deque->tail_index = RTL_DEQUE_CHUNK_SIZE;
+  }
+
+  if (item) {
+    *item = value;
+  }
+  return true;
+}
+
+bool rtl_deque_pop_front(rtl_deque_t* deque, void** item)
+{
+  rtl_assert(deque != NULL, "Deque cannot be NULL");
+
+  if (deque->count == 0) {
+    return false;
+  }
+
+  rtl_deque_chunk_t* chunk = _rtl_deque_first(deque);
+  void* value = chunk->items[deque->head_index++];
+  deque->count--;
+
+  if (deque->count == 0) {
+    deque->head_index = RTL_DEQUE_CHUNK_SIZE / 2;
+    deque->tail_index = RTL_DEQUE_CHUNK_SIZE / 2;
+  } else if (deque->head_index == RTL_DEQUE_CHUNK_SIZE) {
+    _rtl_deque_chunk_put(deque, chunk);
+    deque->head_index = 0;
+  }
+
+  if (item) {
+    *item = value;
+  }
+  return true;
+}
+
+void* rtl_deque_front(const rtl_deque_t* deque)
+{
+  return deque->count ? _rtl_deque_first(deque)->items[deque->head_index] : NULL;
+}
+
+void* rtl_deque_back(const rtl_deque_t* deque)
+{
+  return deque->count ? _rtl_deque_last(deque)->items[deque->tail_index - 1] : NULL;
+}
+
+void rtl_deque_for_each_span(
+  const rtl_deque_t* deque, rtl_deque_span_callback_t callback, void* user_data)
+{
+  rtl_assert(deque != NULL, "Deque cannot be NULL");
+  rtl_assert(callback != NULL, "Callback cannot be NULL");
+
+  if (deque->count == 0) {
+    return;
+  }
+
+  const rtl_deque_chunk_t* last = _rtl_deque_last(deque);
+  rtl_list_entry_t* entry;
+  rtl_list_for_each(entry, &deque->chunks)
+  {
+    rtl_deque_chunk_t* chunk = rtl_list_record(entry, rtl_deque_chunk_t, link);
+    const size_t begin = entry == deque->chunks.next ? deque->head_index : 0;
+    const size_t end = chunk == last ? deque->tail_index : RTL_DEQUE_CHUNK_SIZE;
+    if (!callback(chunk->items + begin, end - begin, user_data) || chunk == last) {
+      return;
+    }
+  }
+}
+
+/**
+ * @internal
+ * @brief Per-element iteration state threaded through rtl_deque_for_each_span().
+ */
+typedef struct rtl_deque_for_each_state_t
+{
+  rtl_deque_callback_t callback; /**< Element callback */
+  void* user_data;               /**< User data for the element callback */
+  unsigned long index;           /**< Index of the next element */
+} rtl_deque_for_each_state_t;
+
+/**
+ * @internal
+ * @brief Feeds one run of elements to the per-element callback.
+ */
+static bool _rtl_deque_for_each_span(void** items, size_t count, void* user_data)
+{
+  rtl_deque_for_each_state_t* state = (rtl_deque_for_each_state_t*)user_data;
+  for (size_t i = 0; i < count; i++) {
+    if (!state->callback(state->index++, items[i], state->user_data)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void rtl_deque_for_each(const rtl_deque_t* deque, rtl_deque_callback_t callback, void* user_data)
+{
+  rtl_assert(callback != NULL, "Callback cannot be NULL");
+
+  rtl_deque_for_each_state_t state = { callback, user_data, 0 };
+  rtl_deque_for_each_span(deque, _rtl_deque_for_each_span, &state);
+}
@@ -0,0 +1,285 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_ebr.h"
+
+#include <stddef.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Frees all pointers held by a batch and the batch itself.
+ * @param batch Pointer to the batch to free.
+ */
+static void _rtl_ebr_free_batch(rtl_ebr_batch_t* batch)
+{
+  for (unsigned long i = 0; i < batch->count; i++) {
+    rtl_free(batch->items[i]);
+  }
+  rtl_free(batch);
+}
+
+/**
+ * @internal
+ * @brief Frees every batch in a chain that was sealed at least two epochs ago.
+ * @param batches Chain of sealed batches.
+ * @param epoch Current global epoch.
+ * @return The chain of batches that are not safe to free yet.
+ */
+static rtl_ebr_batch_t* _rtl_ebr_collect(rtl_ebr_batch_t* batches, uintptr_t epoch)
+{
+  rtl_ebr_batch_t* remaining = NULL;
+  while (batches) {
+    rtl_ebr_batch_t* next = batches->next;
+    // Readers that could see the batch's nodes entered no later than its epoch,
+    // two advances prove all of them have left
+    if (batches->epoch + 2 <= epoch) {
+      _rtl_ebr_free_batch(batches);
+    } else {
+      batches->next = remaining;
+      remaining = batches;
+    }
+    batches = next;
+  }
+  return remaining;
+}
+
+/**
+ * @internal
+ * @brief Advances the global epoch if every active thread has observed the current one.
+ * @param ebr Pointer to the domain.
+ */
+static void _rtl_ebr_try_advance(rtl_ebr_t* ebr)
+{
+  uintptr_t epoch = rtl_atomic_load(&ebr->epoch);
+
+  rtl_atomic_lock(&ebr->lock);
+  rtl_list_entry_t* current;
+  rtl_list_for_each(current, &ebr->threads)
+  {
+    const rtl_ebr_thread_t* thread = rtl_list_record(current, rtl_ebr_thread_t, link);
+    const uintptr_t state = rtl_atomic_load(&thread->state);
+    if ((state & 1) && (state >> 1) != epoch) {
+      rtl_atomic_unlock(&ebr->lock);
+      return;
+    }
+  }
+  rtl_atomic_unlock(&ebr->lock);
+
+  // Losing the race means another thread advanced it already
+  rtl_atomic_cas(&ebr->epoch, &epoch, epoch + 1);
+}
+
+/**
+ * @internal
+ * @brief Moves the thread's current batch to its pending chain.
+ * @param thread Pointer to the thread record.
+ */
+static void _rtl_ebr_seal(rtl_ebr_thread_t* thread)
+{
+  rtl_ebr_batch_t* batch = thread->current;
+  batch->epoch = rtl_atomic_load(&thread->ebr->epoch);
+  batch->next = thread->pending;
+  thread->pending = batch;
+  thread->current = NULL;
+}
+
+/**
+ * @internal
+ * @brief Tries to advance the epoch and frees the thread's and the domain's safe batches.
+ * @param thread Pointer to the thread record.
+ */
+static void _rtl_ebr_reclaim(rtl_ebr_thread_t* thread)
+{
+  rtl_ebr_t* ebr = thread->ebr;
+
+  _rtl_ebr_try_advance(ebr);
+  const uintptr_t epoch = rtl_atomic_load(&ebr->epoch);
+  thread->pending = _rtl_ebr_collect(thread->pending, epoch);
+
+  // Take the orphans out so rtl_free() doesn't run under the registry lock
+  rtl_atomic_lock(&ebr->lock);
+  rtl_ebr_batch_t* orphans = ebr->orphans;
+  ebr->orphans = NULL;
+  rtl_atomic_unlock(&ebr->lock);
+
+  orphans = _rtl_ebr_collect(orphans, epoch);
+  if (orphans) {
+    rtl_ebr_batch_t* last = orphans;
+    while (last->next) {
+      last = last->next;
+    }
+    rtl_atomic_lock(&ebr->lock);
+    last->next = ebr->orphans;
+    ebr->orphans = orphans;
+    rtl_atomic_unlock(&ebr->lock);
+  }
+}
+
+void rtl_ebr_init(rtl_ebr_t* ebr)
+{
+  rtl_assert(ebr != NULL, "Reclamation domain cannot be NULL");
+
+  rtl_atomic_store_relaxed(&ebr->epoch, 0);
+  rtl_atomic_store_relaxed(&ebr->lock, 0);
+  rtl_list_init(&ebr->threads);
+  ebr->orphans = NULL;
+}
+
+void rtl_ebr_cleanup(rtl_ebr_t* ebr)
+{
+  if (!ebr) {
+    return;
+  }
+
+  // Threads that never unregistered can't be inside a critical section anymore
+  rtl_list_entry_t* current;
+  rtl_list_entry_t* next;
+  rtl_list_for_each_safe(current, next, &ebr->threads)
+  {
+    rtl_ebr_thread_t* thread = rtl_list_record(current, rtl_ebr_thread_t, link);
+    rtl_log_wrn("Thread record %p is still registered at cleanup", (void*)thread);
+    if (thread->current) {
+      _rtl_ebr_seal(thread);
+    }
+    rtl_list_remove(current);
+    while (thread->pending) {
+      rtl_ebr_batch_t* batch = thread->pending;
+      thread->pending = batch->next;
+      _rtl_ebr_free_batch(batch);
+    }
+    thread->ebr = NULL;
+  }
+
+  while (ebr->orphans) {
+    rtl_ebr_batch_t* batch = ebr->orphans;
+    ebr->orphans = batch->next;
+    _rtl_ebr_free_batch(batch);
+  }
+}
+
+void rtl_ebr_thread_register(rtl_ebr_t* ebr, rtl_ebr_thread_t* thread)
+{
+  rtl_assert(ebr != NULL, "Reclamation domain cannot be NULL");
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+
+  rtl_atomic_store_relaxed(&thread->state, 0);
+  thread->ebr = ebr;
+  thread->nesting = 0;
+  thread->current = NULL;
+  thread->pending = NULL;
+
+  rtl_atomic_lock(&ebr->lock);
+  rtl_list_add_tail(&ebr->threads, &thread->link);
+  rtl_atomic_unlock(&ebr->lock);
+}
+
+void rtl_ebr_thread_unregister(rtl_ebr_thread_t* thread)
+{
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+  rtl_assert(thread->nesting == 0, "Thread record cannot be inside a critical section");
+
+  rtl_ebr_flush(thread);
+
+  rtl_ebr_t* ebr = thread->ebr;
+  rtl_atomic_lock(&ebr->lock);
+  rtl_list_remove(&thread->link);
+  while (thread->pending) {
+    rtl_ebr_batch_t* batch = thread->pending;
+    thread->pending = batch->next;
+    batch->next = ebr->orphans;
+    ebr->orphans = batch;
+  }
+  rtl_atomic_unlock(&ebr->lock);
+
+  thread->ebr = NULL;
+}
+
+void rtl_ebr_enter(rtl_ebr_thread_t* thread)
+{
+  if (thread->nesting++ > 0) {
+    return;
+  }
+
+  const uintptr_t epoch = rtl_atomic_load(&thread->ebr->epoch);
+  rtl_atomic_store_relaxed(&thread->state, (epoch << 1) | 1);
+  // The announcement must be visible before any shared pointer is read
+  rtl_atomic_fence();
+}
+
+void rtl_ebr_leave(rtl_ebr_thread_t* thread)
+{
+  rtl_assert(thread->nesting > 0, "Leaving a critical section that was never entered");
+
+  if (--thread->nesting > 0) {
+    return;
+  }
+
+  rtl_atomic_store(&thread->state, rtl_atomic_load_relaxed(&thread->state) & ~(uintptr_t)1);
+}
+
+bool rtl_ebr_retire(rtl_ebr_thread_t* thread, void* ptr)
+{
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+
+  if (ptr == NULL) {
+    return true;
+  }
+
+  if (!thread->current) {
+    thread->current = rtl_malloc_tagged(RTL_MEM_TAG_RECLAIM, sizeof(rtl_ebr_batch_t));
+    if (!thread->current) {
+      return false;
+    }
+    thread->current->next = NULL;
+    thread->current->count = 0;
+  }
+
+  rtl_ebr_batch_t* batch = thread->current;
+  batch->items[batch->count++] = ptr;
+  if (batch->count == RTL_EBR_BATCH_SIZE) {
+    _rtl_ebr_seal(thread);
+    _rtl_ebr_reclaim(thread);
+  }
+
+  return true;
+}
+
+unsigned long rtl_ebr_flush(rtl_ebr_thread_t* thread)
+{
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+
+  if (thread->current) {
+    _rtl_ebr_seal(thread);
+  }
+  _rtl_ebr_reclaim(thread);
+
+  unsigned long count = 0;
+  for (const rtl_ebr_batch_t* batch = thread->pending; batch; batch = batch->next) {
+    count += batch->count;
+  }
+  return count;
+}
@@ -63,13 +63,13 @@ static rtl_hash_entry_t* _rtl_hash_find_entry(const rtl_list_entry_t* bucket, co
 static rtl_hash_entry_t* _rtl_hash_create_entry(
   const void* key, unsigned long key_size, const void* value, unsigned long value_size)
 {
-  rtl_hash_entry_t* entry = rtl_malloc(sizeof(rtl_hash_entry_t));
+  rtl_hash_entry_t* entry = rtl_malloc_tagged(RTL_MEM_TAG_HASH, sizeof(rtl_hash_entry_t));
   if (!entry) {
     return NULL;
   }
 
   // Allocate and copy key
-  entry->key = rtl_malloc(key_size);
+  entry->key = rtl_malloc_tagged(RTL_MEM_TAG_HASH, key_size);
   if (!entry->key) {
     rtl_free(entry);
     return NULL;
@@ -78,7 +78,7 @@ static rtl_hash_entry_t* _rtl_hash_create_entry(
   entry->key_size = key_size;
 
   // Allocate and copy value
-  entry->value = rtl_malloc(value_size);
+  entry->value = rtl_malloc_tagged(RTL_MEM_TAG_HASH, value_size);
   if (!entry->value) {
     rtl_free(entry->key);
     rtl_free(entry);
@@ -104,6 +104,49 @@ static void _rtl_hash_destroy_entry(rtl_hash_entry_t* entry)
   }
 }
 
+/**
+ * @internal
+ * @brief Rounds a size up to RTL_HASH_STATIC_ALIGNMENT.
+ */
+static size_t _rtl_hash_align(size_t size)
+{
+  return (size + RTL_HASH_STATIC_ALIGNMENT - 1) & ~(size_t)(RTL_HASH_STATIC_ALIGNMENT - 1);
+}
+
+/**
+ * @internal
+ * @brief Size of one fixed entry slot: the entry followed by its key and value buffers.
+ */
+static size_t _rtl_hash_static_slot_size(unsigned long key_capacity, unsigned long value_capacity)
+{
+  return _rtl_hash_align(sizeof(rtl_hash_entry_t)) + _rtl_hash_align(key_capacity) +
+    _rtl_hash_align(value_capacity);
+}
+
+/**
+ * @internal
+ * @brief Takes an entry from a static table's free list and copies the key and value in.
+ * @return Pointer to the entry, or NULL if the table is full.
+ */
+static rtl_hash_entry_t* _rtl_hash_take_entry(rtl_hash_table_t* table, const void* key,
+  unsigned long key_size, const void* value, unsigned long value_size)
+{
+  if (rtl_list_empty(&table->free_entries)) {
+    return NULL;
+  }
+
+  rtl_list_entry_t* link = table->free_entries.next;
+  rtl_list_remove(link);
+
+  // Key and value buffers were laid out behind the entry at init
+  rtl_hash_entry_t* entry = rtl_list_record(link, rtl_hash_entry_t, list_entry);
+  memcpy(entry->key, key, key_size);
+  entry->key_size = key_size;
+  memcpy(entry->value, value, value_size);
+  entry->value_size = value_size;
+  return entry;
+}
+
 bool rtl_hash_table_init(rtl_hash_table_t* table, unsigned long bucket_count,
   rtl_hash_function_t hash_function, rtl_hash_key_compare_t key_compare)
 {
@@ -113,7 +156,7 @@ bool rtl_hash_table_init(rtl_hash_table_t* table, unsigned long bucket_count,
   rtl_assert(key_compare != NULL, "Key compare function cannot be NULL");
 
   // Allocate buckets array
-  table->buckets = rtl_malloc(bucket_count * sizeof(rtl_list_entry_t));
+  table->buckets = rtl_malloc_tagged(RTL_MEM_TAG_HASH, bucket_count * sizeof(rtl_list_entry_t));
   if (!table->buckets) {
     return false;
   }
@@ -127,6 +170,72 @@ bool rtl_hash_table_init(rtl_hash_table_t* table, unsigned long bucket_count,
   table->entry_count = 0;
   table->hash_function = hash_function;
   table->key_compare = key_compare;
+  table->entry_capacity = 0;
+  table->key_capacity = 0;
+  table->value_capacity = 0;
+  rtl_list_init(&table->free_entries);
+
+  return true;
+}
+
+size_t rtl_hash_table_static_size(unsigned long bucket_count, unsigned long entry_capacity,
+  unsigned long key_capacity, unsigned long value_capacity)
+{
+  // Extra alignment slack lets callers pass storage with any alignment
+  return RTL_HASH_STATIC_ALIGNMENT - 1 + _rtl_hash_align(bucket_count * sizeof(rtl_list_entry_t)) +
+    entry_capacity * _rtl_hash_static_slot_size(key_capacity, value_capacity);
+}
+
+bool rtl_hash_table_init_static(rtl_hash_table_t* table, unsigned long bucket_count,
+  unsigned long entry_capacity, unsigned long key_capacity, unsigned long value_capacity,
+  void* storage, size_t storage_size, rtl_hash_function_t hash_function,
+  rtl_hash_key_compare_t key_compare)
+{
+  rtl_assert(table != NULL, "Hash table cannot be NULL");
+  rtl_assert(bucket_count > 0, "Bucket count must be greater than 0");
+  rtl_assert(entry_capacity > 0, "Entry capacity must be greater than 0");
+  rtl_assert(key_capacity > 0, "Key capacity must be greater than 0");
+  rtl_assert(value_capacity > 0, "Value capacity must be greater than 0");
+  rtl_assert(storage != NULL, "Storage cannot be NULL");
+  rtl_assert(hash_function != NULL, "Hash function cannot be NULL");
+  rtl_assert(key_compare != NULL, "Key compare function cannot be NULL");
+
+  const size_t required =
+    rtl_hash_table_static_size(bucket_count, entry_capacity, key_capacity, value_capacity);
+  if (storage_size < required) {
+    rtl_log_err("Hash table storage of %lu bytes is smaller than the required %lu bytes",
+      (unsigned long)storage_size, (unsigned long)required);
+    return false;
+  }
+
+  char* cursor = (char*)_rtl_hash_align((uintptr_t)storage);
+  table->buckets = (rtl_list_entry_t*)cursor;
+  cursor += _rtl_hash_align(bucket_count * sizeof(rtl_list_entry_t));
+
+  for (unsigned long i = 0; i < bucket_count; i++) {
+    rtl_list_init(&table->buckets[i]);
+  }
+
+  // Carve every entry slot up front and chain them into the free list
+  rtl_list_init(&table->free_entries);
+  const size_t slot_size = _rtl_hash_static_slot_size(key_capacity, value_capacity);
+  for (unsigned long i = 0; i < entry_capacity; i++) {
+    rtl_hash_entry_t* entry = (rtl_hash_entry_t*)cursor;
+    entry->key = cursor + _rtl_hash_align(sizeof(rtl_hash_entry_t));
+    entry->value = (char*)entry->key + _rtl_hash_align(key_capacity);
+    entry->key_size = 0;
+    entry->value_size = 0;
+    rtl_list_add_tail(&table->free_entries, &entry->list_entry);
+    cursor += slot_size;
+  }
+
+  table->bucket_count = bucket_count;
+  table->entry_count = 0;
+  table->hash_function = hash_function;
+  table->key_compare = key_compare;
+  table->entry_capacity = entry_capacity;
+  table->key_capacity = key_capacity;
+  table->value_capacity = value_capacity;
 
   return true;
 }
@@ -137,6 +246,18 @@ void rtl_hash_table_cleanup(rtl_hash_table_t* table)
     return;
   }
 
+  // Static storage belongs to the caller, there is nothing to free
+  if (table->entry_capacity != 0) {
+    table->buckets = NULL;
+    table->bucket_count = 0;
+    table->entry_count = 0;
+    table->hash_function = NULL;
+    table->key_compare = NULL;
+    table->entry_capacity = 0;
+    rtl_list_init(&table->free_entries);
+    return;
+  }
+
   // Free all entries in all buckets
   for (unsigned long i = 0; i < table->bucket_count; i++) {
     rtl_list_entry_t* current;
@@ -173,9 +294,44 @@ bool rtl_hash_table_insert(rtl_hash_table_t* table, const void* key, unsigned lo
   // Check if key already exists
   rtl_hash_entry_t* existing_entry =
     _rtl_hash_find_entry(bucket, key, key_size, table->key_compare);
+
+  if (table->entry_capacity != 0) {
+    if (key_size > table->key_capacity || value_size > table->value_capacity) {
+      rtl_log_wrn("Key or value exceeds the hash table's fixed entry capacity");
+      return false;
+    }
+
+    // Values are updated in place, the slot is already large enough
+    if (existing_entry) {
+      memcpy(existing_entry->value, value, value_size);
+      existing_entry->value_size = value_size;
+      return true;
+    }
+
+    rtl_hash_entry_t* new_entry = _rtl_hash_take_entry(table, key, key_size, value, value_size);
+    if (!new_entry) {
+      return false;
+    }
+
+    rtl_list_add_head(bucket, &new_entry->list_entry);
+    table->entry_count++;
+    return true;
+  }
+
+  // Refuse to grow past the hash tag's budget, an update only counts its net growth
+  size_t growth = sizeof(rtl_hash_entry_t) + key_size + value_size;
+  if (existing_entry) {
+    growth =
+      value_size > existing_entry->value_size ? value_size - existing_entry->value_size : 0;
+  }
+  if (growth > 0 && !rtl_memory_tag_within_limit(RTL_MEM_TAG_HASH, growth)) {
+    rtl_log_wrn("Hash memory limit reached, refusing to insert %lu bytes", (unsigned long)growth);
+    return false;
+  }
+
   if (existing_entry) {
     // Update existing entry's value
-    void* new_value = rtl_malloc(value_size);
+    void* new_value = rtl_malloc_tagged(RTL_MEM_TAG_HASH, value_size);
     if (!new_value) {
       return false;
     }
@@ -239,7 +395,11 @@ bool rtl_hash_table_remove(rtl_hash_table_t* table, const void* key, unsigned lo
   rtl_hash_entry_t* entry = _rtl_hash_find_entry(bucket, key, key_size, table->key_compare);
   if (entry) {
     rtl_list_remove(&entry->list_entry);
-    _rtl_hash_destroy_entry(entry);
+    if (table->entry_capacity != 0) {
+      rtl_list_add_head(&table->free_entries, &entry->list_entry);
+    } else {
+      _rtl_hash_destroy_entry(entry);
+    }
     table->entry_count--;
     return true;
   }
@@ -0,0 +1,350 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_hazard.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Computes the capacity a pointer array grows to, doubling until it fits.
+ */
+static unsigned long _rtl_hazard_capacity(unsigned long capacity, unsigned long needed)
+{
+  unsigned long new_capacity = capacity ? capacity * 2 : RTL_HAZARD_SCAN_THRESHOLD;
+  while (new_capacity < needed) {
+    new_capacity *= 2;
+  }
+  return new_capacity;
+}
+
+/**
+ * @internal
+ * @brief Grows a thread-private pointer array so it can hold at least the needed number of items.
+ *        Must not be called with the domain lock held.
+ * @param array Pointer to the array, replaced when it grows.
+ * @param count Number of items to preserve.
+ * @param capacity Pointer to the current capacity, updated when the array grows.
+ * @param needed Minimum capacity required.
+ * @return true if the array is large enough, false if it could not grow.
+ */
+static bool _rtl_hazard_grow(
+  void*** array, unsigned long count, unsigned long* capacity, unsigned long needed)
+{
+  if (needed <= *capacity) {
+    return true;
+  }
+
+  const unsigned long new_capacity = _rtl_hazard_capacity(*capacity, needed);
+  void** grown = rtl_malloc_tagged(RTL_MEM_TAG_RECLAIM, new_capacity * sizeof(void*));
+  if (!grown) {
+    return false;
+  }
+
+  if (count > 0) {
+    memcpy(grown, *array, count * sizeof(void*));
+  }
+  rtl_free(*array);
+  *array = grown;
+  *capacity = new_capacity;
+  return true;
+}
+
+/**
+ * @internal
+ * @brief Grows the orphan list so it can take the given number of extra items.
+ *        Called and returns with the domain lock held, but allocates and frees with the
+ *        lock released, the new array is only swapped in under it.
+ * @return true if the list is large enough, false if it could not grow.
+ */
+static bool _rtl_hazard_reserve_orphans(rtl_hazard_t* domain, unsigned long extra)
+{
+  while (domain->orphan_count + extra > domain->orphan_capacity) {
+    const unsigned long capacity =
+      _rtl_hazard_capacity(domain->orphan_capacity, domain->orphan_count + extra);
+
+    rtl_atomic_unlock(&domain->lock);
+    void** grown = rtl_malloc_tagged(RTL_MEM_TAG_RECLAIM, capacity * sizeof(void*));
+    rtl_atomic_lock(&domain->lock);
+    if (!grown) {
+      return false;
+    }
+
+    // Another thread may have grown the list meanwhile, then the new array is dropped
+    void** stale = grown;
+    if (capacity > domain->orphan_capacity) {
+      if (domain->orphan_count > 0) {
+        memcpy(grown, domain->orphans, domain->orphan_count * sizeof(void*));
+      }
+      stale = domain->orphans;
+      domain->orphans = grown;
+      domain->orphan_capacity = capacity;
+    }
+
+    if (stale) {
+      rtl_atomic_unlock(&domain->lock);
+      rtl_free(stale);
+      rtl_atomic_lock(&domain->lock);
+    }
+  }
+  return true;
+}
+
+/**
+ * @internal
+ * @brief Orders pointers by address for qsort() and bsearch().
+ */
+static int _rtl_hazard_compare(const void* a, const void* b)
+{
+  const uintptr_t left = (uintptr_t)*(void* const*)a;
+  const uintptr_t right = (uintptr_t)*(void* const*)b;
+  return (left > right) - (left < right);
+}
+
+void rtl_hazard_init(rtl_hazard_t* domain)
+{
+  rtl_assert(domain != NULL, "Hazard domain cannot be NULL");
+
+  rtl_atomic_store_relaxed(&domain->lock, 0);
+  rtl_list_init(&domain->threads);
+  rtl_atomic_store_relaxed(&domain->thread_count, 0);
+  domain->orphans = NULL;
+  domain->orphan_count = 0;
+  domain->orphan_capacity = 0;
+}
+
+void rtl_hazard_cleanup(rtl_hazard_t* domain)
+{
+  if (!domain) {
+    return;
+  }
+
+  rtl_list_entry_t* current;
+  rtl_list_entry_t* next;
+  rtl_list_for_each_safe(current, next, &domain->threads)
+  {
+    rtl_hazard_thread_t* thread = rtl_list_record(current, rtl_hazard_thread_t, link);
+    rtl_log_wrn("Thread record %p is still registered at cleanup", (void*)thread);
+    rtl_hazard_thread_unregister(thread);
+  }
+
+  for (unsigned long i = 0; i < domain->orphan_count; i++) {
+    rtl_free(domain->orphans[i]);
+  }
+  rtl_free(domain->orphans);
+  domain->orphans = NULL;
+  domain->orphan_count = 0;
+  domain->orphan_capacity = 0;
+}
+
+void rtl_hazard_thread_register(rtl_hazard_t* domain, rtl_hazard_thread_t* thread)
+{
+  rtl_assert(domain != NULL, "Hazard domain cannot be NULL");
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+
+  for (unsigned i = 0; i < RTL_HAZARD_SLOTS; i++) {
+    rtl_atomic_store_ptr(&thread->slots[i], NULL);
+  }
+  thread->domain = domain;
+  thread->retired = NULL;
+  thread->retired_count = 0;
+  thread->retired_capacity = 0;
+  thread->hazards = NULL;
+  thread->hazards_capacity = 0;
+
+  rtl_atomic_lock(&domain->lock);
+  rtl_list_add_tail(&domain->threads, &thread->link);
+  rtl_atomic_fetch_add(&domain->thread_count, 1);
+  rtl_atomic_unlock(&domain->lock);
+}
+
+void rtl_hazard_thread_unregister(rtl_hazard_thread_t* thread)
+{
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+
+  rtl_hazard_clear_all(thread);
+  rtl_hazard_scan(thread);
+
+  rtl_hazard_t* domain = thread->domain;
+  rtl_atomic_lock(&domain->lock);
+  rtl_list_remove(&thread->link);
+  rtl_atomic_fetch_add(&domain->thread_count, (uintptr_t)-1);
+  if (thread->retired_count > 0) {
+    if (_rtl_hazard_reserve_orphans(domain, thread->retired_count)) {
+      memcpy(&domain->orphans[domain->orphan_count], thread->retired,
+        thread->retired_count * sizeof(void*));
+      domain->orphan_count += thread->retired_count;
+    } else {
+      rtl_log_err(
+        "Leaking %lu retired pointers, orphan list could not grow", thread->retired_count);
+    }
+  }
+  rtl_atomic_unlock(&domain->lock);
+
+  rtl_free(thread->retired);
+  rtl_free(thread->hazards);
+  thread->retired = NULL;
+  thread->retired_count = 0;
+  thread->retired_capacity = 0;
+  thread->hazards = NULL;
+  thread->hazards_capacity = 0;
+  thread->domain = NULL;
+}
+
+void* rtl_hazard_protect(rtl_hazard_thread_t* thread, unsigned slot, rtl_atomic_ptr_t* source)
+{
+  rtl_assert(slot < RTL_HAZARD_SLOTS, "Hazard slot %u is out of range", slot);
+
+  void* ptr = rtl_atomic_load_ptr(source);
+  for (;;) {
+    rtl_atomic_store_relaxed((rtl_atomic_word_t*)&thread->slots[slot], (uintptr_t)ptr);
+    // The slot must be visible to scanners before the source is validated
+    rtl_atomic_fence();
+    void* current = rtl_atomic_load_ptr(source);
+    if (current == ptr) {
+      return ptr;
+    }
+    ptr = current;
+  }
+}
+
+void rtl_hazard_clear(rtl_hazard_thread_t* thread, unsigned slot)
+{
+  rtl_assert(slot < RTL_HAZARD_SLOTS, "Hazard slot %u is out of range", slot);
+  rtl_atomic_store_ptr(&thread->slots[slot], NULL);
+}
+
+void rtl_hazard_clear_all(rtl_hazard_thread_t* thread)
+{
+  for (unsigned i = 0; i < RTL_HAZARD_SLOTS; i++) {
+    rtl_atomic_store_ptr(&thread->slots[i], NULL);
+  }
+}
+
+bool rtl_hazard_retire(rtl_hazard_thread_t* thread, void* ptr)
+{
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+
+  if (ptr == NULL) {
+    return true;
+  }
+
+  if (!_rtl_hazard_grow(&thread->retired, thread->retired_count, &thread->retired_capacity,
+        thread->retired_count + 1)) {
+    return false;
+  }
+  thread->retired[thread->retired_count++] = ptr;
+
+  unsigned long threshold =
+    2 * RTL_HAZARD_SLOTS * (unsigned long)rtl_atomic_load_relaxed(&thread->domain->thread_count);
+  if (threshold < RTL_HAZARD_SCAN_THRESHOLD) {
+    threshold = RTL_HAZARD_SCAN_THRESHOLD;
+  }
+  if (thread->retired_count >= threshold) {
+    rtl_hazard_scan(thread);
+  }
+
+  return true;
+}
+
+unsigned long rtl_hazard_scan(rtl_hazard_thread_t* thread)
+{
+  rtl_assert(thread != NULL, "Thread record cannot be NULL");
+
+  rtl_hazard_t* domain = thread->domain;
+
+  // Retirements must be ordered before the slots are read
+  rtl_atomic_fence();
+
+  rtl_atomic_lock(&domain->lock);
+
+  // Size the thread's arrays with the lock released, the allocator may block
+  unsigned long slot_count;
+  for (;;) {
+    const unsigned long retired_needed = thread->retired_count + domain->orphan_count;
+    slot_count = RTL_HAZARD_SLOTS * (unsigned long)rtl_atomic_load_relaxed(&domain->thread_count);
+    if (retired_needed <= thread->retired_capacity && slot_count <= thread->hazards_capacity) {
+      break;
+    }
+
+    rtl_atomic_unlock(&domain->lock);
+    const bool grown =
+      _rtl_hazard_grow(&thread->retired, thread->retired_count, &thread->retired_capacity,
+        retired_needed) &&
+      _rtl_hazard_grow(&thread->hazards, 0, &thread->hazards_capacity, slot_count);
+    rtl_atomic_lock(&domain->lock);
+    if (!grown) {
+      break;
+    }
+  }
+
+  // Adopt pointers left behind by threads that are gone
+  if (domain->orphan_count > 0 &&
+      thread->retired_count + domain->orphan_count <= thread->retired_capacity) {
+    memcpy(&thread->retired[thread->retired_count], domain->orphans,
+      domain->orphan_count * sizeof(void*));
+    thread->retired_count += domain->orphan_count;
+    domain->orphan_count = 0;
+  }
+
+  if (slot_count > thread->hazards_capacity) {
+    rtl_atomic_unlock(&domain->lock);
+    return thread->retired_count;
+  }
+
+  unsigned long hazard_count = 0;
+  rtl_list_entry_t* current;
+  rtl_list_for_each(current, &domain->threads)
+  {
+    rtl_hazard_thread_t* other = rtl_list_record(current, rtl_hazard_thread_t, link);
+    for (unsigned i = 0; i < RTL_HAZARD_SLOTS; i++) {
+      void* hazard = rtl_atomic_load_ptr(&other->slots[i]);
+      if (hazard) {
+        thread->hazards[hazard_count++] = hazard;
+      }
+    }
+  }
+  rtl_atomic_unlock(&domain->lock);
+
+  qsort(thread->hazards, hazard_count, sizeof(void*), _rtl_hazard_compare);
+
+  unsigned long kept = 0;
+  for (unsigned long i = 0; i < thread->retired_count; i++) {
+    void* ptr = thread->retired[i];
+    if (hazard_count > 0 &&
+        bsearch(&ptr, thread->hazards, hazard_count, sizeof(void*), _rtl_hazard_compare)) {
+      thread->retired[kept++] = ptr;
+    } else {
+      rtl_free(ptr);
+    }
+  }
+  thread->retired_count = kept;
+
+  return kept;
+}
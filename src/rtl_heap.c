@@ -0,0 +1,325 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_heap.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Capacity of a 4-ary heap's first allocation.
+ */
+#define RTL_DHEAP_INITIAL_CAPACITY 16
+
+/**
+ * @internal
+ * @brief Links two detached heaps, the larger root becomes the first child of the smaller.
+ */
+static rtl_pairing_node_t* _rtl_pairing_heap_meld(
+  const rtl_pairing_heap_t* heap, rtl_pairing_node_t* a, rtl_pairing_node_t* b)
+{
+  if (heap->compare(b, a) < 0) {
+    rtl_pairing_node_t* swap = a;
+    a = b;
+    b = swap;
+  }
+
+  b->prev = a;
+  b->sibling = a->child;
+  if (a->child) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  return a;
+}
+
+/**
+ * @internal
+ * @brief Combines a list of sibling subtrees into one heap with the standard
+ *        two passes: meld pairs left to right, then fold the pairs right to left.
+ */
+static rtl_pairing_node_t* _rtl_pairing_heap_merge_pairs(
+  const rtl_pairing_heap_t* heap, rtl_pairing_node_t* first)
+{
+  if (!first) {
+    return NULL;
+  }
+
+  // The melded pairs are chained through sibling in reverse order
+  rtl_pairing_node_t* pairs = NULL;
+  while (first) {
+    rtl_pairing_node_t* a = first;
+    rtl_pairing_node_t* b = a->sibling;
+    a->prev = NULL;
+    if (!b) {
+      a->sibling = pairs;
+      pairs = a;
+      break;
+    }
+
+    first = b->sibling;
+    a->sibling = NULL;
+    b->sibling = NULL;
+    b->prev = NULL;
+
+    rtl_pairing_node_t* merged = _rtl_pairing_heap_meld(heap, a, b);
+    merged->sibling = pairs;
+    pairs = merged;
+  }
+
+  rtl_pairing_node_t* result = pairs;
+  pairs = pairs->sibling;
+  result->sibling = NULL;
+  while (pairs) {
+    rtl_pairing_node_t* next = pairs->sibling;
+    pairs->sibling = NULL;
+    result = _rtl_pairing_heap_meld(heap, result, pairs);
+    pairs = next;
+  }
+  return result;
+}
+
+/**
+ * @internal
+ * @brief Detaches a non-root node, with its subtree, from its parent and siblings.
+ */
+static void _rtl_pairing_heap_cut(rtl_pairing_node_t* node)
+{
+  if (node->prev->child == node) {
+    node->prev->child = node->sibling;
+  } else {
+    node->prev->sibling = node->sibling;
+  }
+  if (node->sibling) {
+    node->sibling->prev = node->prev;
+  }
+  node->sibling = NULL;
+  node->prev = NULL;
+}
+
+void rtl_pairing_heap_init(rtl_pairing_heap_t* heap, rtl_pairing_heap_compare_t compare)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+  rtl_assert(compare != NULL, "Compare function cannot be NULL");
+
+  heap->root = NULL;
+  heap->compare = compare;
+}
+
+void rtl_pairing_heap_insert(rtl_pairing_heap_t* heap, rtl_pairing_node_t* node)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+  rtl_assert(node != NULL, "Node cannot be NULL");
+
+  node->child = NULL;
+  node->sibling = NULL;
+  node->prev = NULL;
+  heap->root = heap->root ? _rtl_pairing_heap_meld(heap, heap->root, node) : node;
+}
+
+rtl_pairing_node_t* rtl_pairing_heap_pop(rtl_pairing_heap_t* heap)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+
+  rtl_pairing_node_t* root = heap->root;
+  if (root) {
+    heap->root = _rtl_pairing_heap_merge_pairs(heap, root->child);
+    root->child = NULL;
+  }
+  return root;
+}
+
+void rtl_pairing_heap_remove(rtl_pairing_heap_t* heap, rtl_pairing_node_t* node)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+  rtl_assert(node != NULL, "Node cannot be NULL");
+
+  if (node == heap->root) {
+    rtl_pairing_heap_pop(heap);
+    return;
+  }
+
+  _rtl_pairing_heap_cut(node);
+  rtl_pairing_node_t* children = _rtl_pairing_heap_merge_pairs(heap, node->child);
+  node->child = NULL;
+  if (children) {
+    heap->root = _rtl_pairing_heap_meld(heap, heap->root, children);
+  }
+}
+
+void rtl_pairing_heap_decrease_key(rtl_pairing_heap_t* heap, rtl_pairing_node_t* node)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+  rtl_assert(node != NULL, "Node cannot be NULL");
+
+  // The node's subtree stays ordered, only the link to its parent can be violated
+  if (node != heap->root) {
+    _rtl_pairing_heap_cut(node);
+    heap->root = _rtl_pairing_heap_meld(heap, heap->root, node);
+  }
+}
+
+/**
+ * @internal
+ * @brief Gets the address of the element at an index, the scratch slot sits at capacity.
+ */
+static RTL_INLINE char* _rtl_dheap_at(const rtl_dheap_t* heap, size_t index)
+{
+  return heap->data + index * heap->element_size;
+}
+
+void rtl_dheap_init(rtl_dheap_t* heap, size_t element_size, rtl_dheap_compare_t compare)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+  rtl_assert(element_size > 0, "Element size must be greater than 0");
+  rtl_assert(compare != NULL, "Compare function cannot be NULL");
+
+  heap->data = NULL;
+  heap->count = 0;
+  heap->capacity = 0;
+  heap->element_size = element_size;
+  heap->compare = compare;
+}
+
+void rtl_dheap_cleanup(rtl_dheap_t* heap)
+{
+  if (!heap) {
+    return;
+  }
+
+  rtl_free(heap->data);
+  heap->data = NULL;
+  heap->count = 0;
+  heap->capacity = 0;
+}
+
+bool rtl_dheap_reserve(rtl_dheap_t* heap, size_t capacity)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+
+  if (capacity <= heap->capacity) {
+    return true;
+  }
+
+  char* data = rtl_malloc_tagged(RTL_MEM_TAG_QUEUE, (capacity + 1) * heap->element_size);
+  if (!data) {
+    return false;
+  }
+
+  if (heap->data) {
+    memcpy(data, heap->data, heap->count * heap->element_size);
+    rtl_free(heap->data);
+  }
+  heap->data = data;
+  heap->capacity = capacity;
+  return true;
+}
+
+bool rtl_dheap_push(rtl_dheap_t* heap, const void* element)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+  rtl_assert(element != NULL, "Element cannot be NULL");
+
+  // The element may be one of ours, e.g. the top, find it again after the storage moves
+  const uintptr_t begin = (uintptr_t)heap->data;
+  const uintptr_t address = (uintptr_t)element;
+  const bool aliased =
+    heap->data != NULL && address >= begin && address < begin + heap->count * heap->element_size;
+  if (heap->count == heap->capacity &&
+    !rtl_dheap_reserve(
+      heap, heap->capacity ? heap->capacity * 2 : RTL_DHEAP_INITIAL_CAPACITY)) {
+    return false;
+  }
+  if (aliased) {
+    element = heap->data + (address - begin);
+  }
+
+  // Move parents down into the hole instead of swapping at every level
+  char* scratch = _rtl_dheap_at(heap, heap->capacity);
+  memcpy(scratch, element, heap->element_size);
+
+  size_t index = heap->count;
+  while (index > 0) {
+    const size_t parent = (index - 1) / RTL_DHEAP_ARITY;
+    if (heap->compare(scratch, _rtl_dheap_at(heap, parent)) >= 0) {
+      break;
+    }
+    memcpy(_rtl_dheap_at(heap, index), _rtl_dheap_at(heap, parent), heap->element_size);
+    index = parent;
+  }
+
+  memcpy(_rtl_dheap_at(heap, index), scratch, heap->element_size);
+  heap->count++;
+  return true;
+}
+
+bool rtl_dheap_pop(rtl_dheap_t* heap, void* element)
+{
+  rtl_assert(heap != NULL, "Heap cannot be NULL");
+
+  if (heap->count == 0) {
+    return false;
+  }
+
+  if (element) {
+    memcpy(element, heap->data, heap->element_size);
+  }
+  if (--heap->count == 0) {
+    return true;
+  }
+
+  // Sift the last element down from the root, moving the smallest child up each level
+  char* scratch = _rtl_dheap_at(heap, heap->capacity);
+  memcpy(scratch, _rtl_dheap_at(heap, heap->count), heap->element_size);
+
+  size_t index = 0;
+  for (;;) {
+    const size_t first = index * RTL_DHEAP_ARITY + 1;
+    if (first >= heap->count) {
+      break;
+    }
+
+    const size_t end =
+      first + RTL_DHEAP_ARITY < heap->count ? first + RTL_DHEAP_ARITY : heap->count;
+    size_t best = first;
+    for (size_t child = first + 1; child < end; child++) {
+      if (heap->compare(_rtl_dheap_at(heap, child), _rtl_dheap_at(heap, best)) < 0) {
+        best = child;
+      }
+    }
+
+    if (heap->compare(_rtl_dheap_at(heap, best), scratch) >= 0) {
+      break;
+    }
+    memcpy(_rtl_dheap_at(heap, index), _rtl_dheap_at(heap, best), heap->element_size);
+    index = best;
+  }
+
+  memcpy(_rtl_dheap_at(heap, index), scratch, heap->element_size);
+  return true;
+}
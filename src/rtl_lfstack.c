@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_lfstack.h"
+
+#include <stddef.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+
+// The top word packs the node address with a counter bumped on every change.
+// 64-bit targets keep user-space addresses in the low 48 bits, so the upper 16
+// bits hold the high part of the counter; 32-bit targets split the word evenly.
+// Nodes are pointer aligned, so the low bits of the address are always zero and
+// hold the low part of the counter: 19 bits in total on 64-bit, 34 on 32-bit.
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define RTL_LFSTACK_POINTER_BITS 48
+#define RTL_LFSTACK_ALIGN_BITS   3
+#else
+#define RTL_LFSTACK_POINTER_BITS 32
+#define RTL_LFSTACK_ALIGN_BITS   2
+#endif
+
+#define RTL_LFSTACK_POINTER_MASK ((UINT64_C(1) << RTL_LFSTACK_POINTER_BITS) - 1)
+#define RTL_LFSTACK_ALIGN_MASK   ((UINT64_C(1) << RTL_LFSTACK_ALIGN_BITS) - 1)
+
+/**
+ * @internal
+ * @brief Extracts the node from a top word.
+ *        Assumes 64-bit user-space addresses fit in 48 bits. That breaks with 5-level
+ *        paging (LA57) once the kernel hands out addresses above 2^47 and with pointer
+ *        tagging (ARM TBI/MTE, Intel LAM) that stores metadata in the upper bits;
+ *        push_chain asserts on such nodes.
+ */
+static rtl_lfstack_node_t* _rtl_lfstack_node(uint64_t top)
+{
+  return (rtl_lfstack_node_t*)(uintptr_t)(top & RTL_LFSTACK_POINTER_MASK &
+    ~RTL_LFSTACK_ALIGN_MASK);
+}
+
+/**
+ * @internal
+ * @brief Builds the top word that replaces a previous one.
+ */
+static uint64_t _rtl_lfstack_next_top(uint64_t previous, const rtl_lfstack_node_t* node)
+{
+  const uint64_t counter =
+    (((previous >> RTL_LFSTACK_POINTER_BITS) << RTL_LFSTACK_ALIGN_BITS) |
+      (previous & RTL_LFSTACK_ALIGN_MASK)) + 1;
+  return ((counter >> RTL_LFSTACK_ALIGN_BITS) << RTL_LFSTACK_POINTER_BITS) |
+    (uint64_t)(uintptr_t)node | (counter & RTL_LFSTACK_ALIGN_MASK);
+}
+
+void rtl_lfstack_init(rtl_lfstack_t* stack)
+{
+  rtl_assert(stack != NULL, "Stack cannot be NULL");
+  rtl_atomic_store_u64(&stack->top, 0);
+}
+
+void rtl_lfstack_push(rtl_lfstack_t* stack, rtl_lfstack_node_t* node)
+{
+  rtl_lfstack_push_chain(stack, node, node);
+}
+
+void rtl_lfstack_push_chain(
+  rtl_lfstack_t* stack, rtl_lfstack_node_t* first, rtl_lfstack_node_t* last)
+{
+  rtl_assert(
+    ((uint64_t)(uintptr_t)first & (~RTL_LFSTACK_POINTER_MASK | RTL_LFSTACK_ALIGN_MASK)) == 0,
+    "Node %p doesn't fit the tagged pointer", (void*)first);
+
+  uint64_t top = rtl_atomic_load_u64(&stack->top);
+  do {
+    rtl_atomic_store_ptr(&last->next, _rtl_lfstack_node(top));
+  } while (!rtl_atomic_cas_u64(&stack->top, &top, _rtl_lfstack_next_top(top, first)));
+}
+
+rtl_lfstack_node_t* rtl_lfstack_pop(rtl_lfstack_t* stack)
+{
+  uint64_t top = rtl_atomic_load_u64(&stack->top);
+  for (;;) {
+    rtl_lfstack_node_t* node = _rtl_lfstack_node(top);
+    if (node == NULL) {
+      return NULL;
+    }
+
+    // The node may be popped and reused concurrently. The counter makes the CAS
+    // fail unless the top changed exactly a multiple of 2^19 times (2^34 on 32-bit)
+    // in between, so a stale next is unlikely but not impossible to install
+    rtl_lfstack_node_t* next = rtl_atomic_load_ptr(&node->next);
+    if (rtl_atomic_cas_u64(&stack->top, &top, _rtl_lfstack_next_top(top, next))) {
+      return node;
+    }
+  }
+}
+
+rtl_lfstack_node_t* rtl_lfstack_pop_all(rtl_lfstack_t* stack)
+{
+  uint64_t top = rtl_atomic_load_u64(&stack->top);
+  while (_rtl_lfstack_node(top) != NULL &&
+         !rtl_atomic_cas_u64(&stack->top, &top, _rtl_lfstack_next_top(top, NULL))) {
+  }
+  return _rtl_lfstack_node(top);
+}
+
+bool rtl_lfstack_empty(const rtl_lfstack_t* stack)
+{
+  return _rtl_lfstack_node(rtl_atomic_load_u64(&stack->top)) == NULL;
+}
@@ -20,86 +20,30 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+// Emit external definitions of the inline primitives for ABI compatibility
+#define RTL_LIST_API
+
 #include "rtl_list.h"
 #include <stddef.h>
 
-void rtl_list_init(rtl_list_entry_t* head)
-{
-  head->prev = head;
-  head->next = head;
-}
+#include "rtl.h"
+#include "rtl_log.h"
 
-bool rtl_list_empty(const rtl_list_entry_t* head)
+void rtl_list_replace_init(rtl_list_entry_t* old_head, rtl_list_entry_t* new_head)
 {
-  return head->next == head;
-}
+  // Overwriting a non-empty head would silently drop its entries
+  rtl_assert(rtl_list_empty(new_head), "List %p receiving the entries must be empty",
+    (void*)new_head);
 
-/**
- * @internal
- * @brief Inserts a new entry between two known consecutive entries.
- *        This is an internal function, list users should use
- *        rtl_list_push_front() or rtl_list_push_back().
- * @param _new Pointer to the new entry to be inserted.
- * @param prev Pointer to the entry that will precede the new entry.
- * @param next Pointer to the entry that will follow the new entry.
- */
-static void _rtl_list_insert(rtl_list_entry_t* _new, rtl_list_entry_t* prev, rtl_list_entry_t* next)
-{
-  next->prev = _new;
-  _new->next = next;
-  _new->prev = prev;
-  prev->next = _new;
-}
-
-/**
- * @brief Adds a new entry to the front of the list.
- * @param head Pointer to the list head entry.
- * @param entry Pointer to the new entry to add.
- */
-void rtl_list_add_head(rtl_list_entry_t* head, rtl_list_entry_t* entry)
-{
-  _rtl_list_insert(entry, head, head->next);
-}
-
-void rtl_list_add_tail(rtl_list_entry_t* head, rtl_list_entry_t* entry)
-{
-  _rtl_list_insert(entry, head->prev, head);
-}
-
-/**
- * @internal
- * @brief Removes an entry by connecting its neighbors.
- *        This is an internal function, list users should use rtl_list_remove().
- * @param prev Pointer to the previous entry.
- * @param next Pointer to the next entry.
- */
-static void _rtl_list_remove(rtl_list_entry_t* prev, rtl_list_entry_t* next)
-{
-  next->prev = prev;
-  prev->next = next;
-}
-
-void rtl_list_remove(const rtl_list_entry_t* entry)
-{
-  _rtl_list_remove(entry->prev, entry->next);
-}
-
-rtl_list_entry_t* rtl_list_first(const rtl_list_entry_t* head)
-{
-  if (rtl_list_empty(head)) {
-    return NULL;
-  }
-
-  return head->next;
-}
-
-rtl_list_entry_t* rtl_list_next(const rtl_list_entry_t* current, const rtl_list_entry_t* head)
-{
-  if (current == NULL || current->next == head) {
-    return NULL;
+  if (rtl_list_empty(old_head)) {
+    return;
   }
 
-  return current->next;
+  new_head->next = old_head->next;
+  new_head->prev = old_head->prev;
+  new_head->next->prev = new_head;
+  new_head->prev->next = new_head;
+  rtl_list_init(old_head);
 }
 
 unsigned long rtl_list_length(const rtl_list_entry_t* head)
@@ -132,3 +76,121 @@ void rtl_list_for_each_callback(const rtl_list_entry_t* head, rtl_list_callback_
     index++;
   }
 }
+
+void rtl_list_for_each_callback_prefetch(const rtl_list_entry_t* head, unsigned distance,
+  rtl_list_callback_t callback, void* user_data)
+{
+  if (head == NULL || callback == NULL) {
+    return;
+  }
+
+  unsigned long index = 0;
+  rtl_list_entry_t* current = head->next;
+  rtl_list_entry_t* ahead = _rtl_list_prefetch_start(head, distance);
+
+  // The distance is a parameter since RTL_LIST_PREFETCH_DISTANCE is fixed when this file is built
+  for (; current != head; current = current->next, ahead = _rtl_list_prefetch_step(ahead, head)) {
+    if (!callback(index, current, user_data)) {
+      break;  // Stop iteration if callback returns false
+    }
+    index++;
+  }
+}
+
+/**
+ * @internal
+ * @brief Number of pending runs in rtl_list_sort(), run i holds 2^i entries.
+ */
+#define RTL_LIST_SORT_RUNS 64
+
+/**
+ * @internal
+ * @brief Merges two NULL-terminated runs linked through next only.
+ *        Ties take the entry from a, which must hold the earlier entries.
+ */
+static rtl_list_entry_t* _rtl_list_merge_runs(
+  rtl_list_entry_t* a, rtl_list_entry_t* b, rtl_list_compare_t compare)
+{
+  rtl_list_entry_t merged;
+  rtl_list_entry_t* tail = &merged;
+
+  while (a != NULL && b != NULL) {
+    if (compare(a, b) <= 0) {
+      tail->next = a;
+      a = a->next;
+    } else {
+      tail->next = b;
+      b = b->next;
+    }
+    tail = tail->next;
+  }
+  tail->next = a != NULL ? a : b;
+
+  return merged.next;
+}
+
+void rtl_list_sort(rtl_list_entry_t* head, rtl_list_compare_t compare)
+{
+  if (head->next == head->prev) {
+    return;  // Zero or one entries
+  }
+
+  // Break the ring into a NULL-terminated chain, prev links are restored at the end
+  rtl_list_entry_t* list = head->next;
+  head->prev->next = NULL;
+
+  // Binary counter of runs: each new entry is carried upward like an increment
+  rtl_list_entry_t* runs[RTL_LIST_SORT_RUNS] = {NULL};
+  unsigned run_count = 0;
+  while (list != NULL) {
+    rtl_list_entry_t* carry = list;
+    list = list->next;
+    carry->next = NULL;
+
+    unsigned i = 0;
+    for (; i < run_count && runs[i] != NULL; i++) {
+      carry = _rtl_list_merge_runs(runs[i], carry, compare);
+      runs[i] = NULL;
+    }
+    if (i == RTL_LIST_SORT_RUNS) {
+      i--;
+      carry = _rtl_list_merge_runs(runs[i], carry, compare);
+    }
+    runs[i] = carry;
+    if (i >= run_count) {
+      run_count = i + 1;
+    }
+  }
+
+  // Higher runs hold older entries, so they go first in each merge
+  rtl_list_entry_t* sorted = NULL;
+  for (unsigned i = 0; i < run_count; i++) {
+    sorted = _rtl_list_merge_runs(runs[i], sorted, compare);
+  }
+
+  rtl_list_entry_t* prev = head;
+  for (rtl_list_entry_t* current = sorted; current != NULL; current = current->next) {
+    current->prev = prev;
+    prev->next = current;
+    prev = current;
+  }
+  prev->next = head;
+  head->prev = prev;
+}
+
+void rtl_list_merge(rtl_list_entry_t* head, rtl_list_entry_t* other, rtl_list_compare_t compare)
+{
+  rtl_list_entry_t* position = head->next;
+
+  while (!rtl_list_empty(other)) {
+    rtl_list_entry_t* entry = other->next;
+
+    // Skip entries that sort before or equal to the incoming one
+    while (position != head && compare(position, entry) <= 0) {
+      position = position->next;
+    }
+
+    rtl_list_remove(entry);
+    _rtl_list_insert(entry, position->prev, position);
+  }
+}
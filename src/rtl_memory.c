@@ -22,13 +22,16 @@
 
 #include "rtl_memory.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#ifdef RTL_DEBUG_BUILD
+#include "rtl.h"
+#include "rtl_atomic.h"
 #include "rtl_log.h"
-#endif
+#include "rtl_platform.h"
+#include "rtl_trace.h"
 
 #ifdef RTL_DEBUG_BUILD
 /**
@@ -36,6 +39,12 @@
  * @brief Head of the linked list used to track memory allocations in debug builds.
  */
 static rtl_list_entry_t rtl_memory_allocations;
+
+/**
+ * @internal
+ * @brief Spinlock guarding rtl_memory_allocations, memory may be freed from any thread.
+ */
+static rtl_atomic_word_t rtl_memory_allocations_lock;
 #endif
 
 /**
@@ -63,31 +72,191 @@ static void default_free_wrapper(void* ptr)
 static rtl_malloc_func_t g_malloc_func = NULL;
 static rtl_free_func_t g_free_func = NULL;
 
+/**
+ * @internal
+ * @brief Locates out-of-line headers, NULL while headers are prepended to blocks.
+ */
+static rtl_memory_header_func_t g_header_func = NULL;
+
+/**
+ * @internal
+ * @brief Accounting state of a single allocation tag.
+ *        Padded to a cache line so threads allocating under different tags
+ *        don't bounce each other's counters.
+ */
+typedef struct rtl_memory_tag_state_t
+{
+  rtl_atomic_word_t bytes;       /**< Bytes currently allocated */
+  rtl_atomic_word_t peak_bytes;  /**< Highest value bytes has reached */
+  rtl_atomic_word_t allocations; /**< Number of live allocations */
+  rtl_atomic_word_t limit;       /**< Soft limit in bytes, 0 if unlimited */
+  const char* name;              /**< Optional name for reports */
+  char _pad[RTL_CACHE_LINE_SIZE - 4 * sizeof(rtl_atomic_word_t) - sizeof(const char*)];
+} rtl_memory_tag_state_t;
+
+/**
+ * @internal
+ * @brief Per-tag accounting, maintained in every build configuration.
+ */
+static rtl_memory_tag_state_t g_memory_tags[RTL_MEM_TAG_MAX];
+
+/**
+ * @internal
+ * @brief Bytes allocated across all tags.
+ */
+static rtl_atomic_word_t g_memory_usage;
+
+/**
+ * @internal
+ * @brief Global soft limit, 0 if disabled.
+ */
+static rtl_atomic_word_t g_memory_soft_limit;
+
+/**
+ * @internal
+ * @brief Set while usage is above the soft limit, so callbacks fire once per crossing.
+ */
+static rtl_atomic_word_t g_memory_over_limit;
+
+/**
+ * @internal
+ * @brief Registered memory pressure callback.
+ */
+typedef struct rtl_memory_pressure_entry_t
+{
+  rtl_memory_pressure_callback_t callback;
+  void* user_data;
+} rtl_memory_pressure_entry_t;
+
+/**
+ * @internal
+ * @brief Pressure callbacks, a fixed array so signalling never allocates.
+ */
+static rtl_memory_pressure_entry_t g_pressure_callbacks[RTL_MEMORY_MAX_PRESSURE_CALLBACKS];
+static unsigned long g_pressure_callback_count;
+static rtl_atomic_word_t g_pressure_lock;
+
+/**
+ * @internal
+ * @brief Set while the calling thread runs pressure callbacks, to prevent recursion.
+ */
+static RTL_THREAD_LOCAL int g_in_pressure = 0;
+
+/**
+ * @internal
+ * @brief Invokes every registered pressure callback.
+ */
+static void _rtl_memory_signal_pressure(size_t usage, size_t limit)
+{
+  if (g_in_pressure) {
+    return;
+  }
+  g_in_pressure = 1;
+
+  // Call outside the lock, callbacks may register or unregister others
+  rtl_memory_pressure_entry_t callbacks[RTL_MEMORY_MAX_PRESSURE_CALLBACKS];
+  rtl_atomic_lock(&g_pressure_lock);
+  const unsigned long count = g_pressure_callback_count;
+  memcpy(callbacks, g_pressure_callbacks, count * sizeof(rtl_memory_pressure_entry_t));
+  rtl_atomic_unlock(&g_pressure_lock);
+
+  for (unsigned long i = 0; i < count; i++) {
+    callbacks[i].callback(usage, limit, callbacks[i].user_data);
+  }
+
+  g_in_pressure = 0;
+}
+
+/**
+ * @internal
+ * @brief Adds an allocation to a tag's usage and raises its peak if needed.
+ * @return Total usage across all tags after the allocation.
+ */
+static size_t _rtl_memory_tag_add(unsigned tag, size_t size)
+{
+  // Plain statistics, nothing is published through them
+  rtl_memory_tag_state_t* state = &g_memory_tags[tag];
+  const uintptr_t bytes = rtl_atomic_fetch_add_relaxed(&state->bytes, size) + size;
+  rtl_atomic_fetch_add_relaxed(&state->allocations, 1);
+
+  // Only write the shared peak when it is actually exceeded
+  uintptr_t peak = rtl_atomic_load_relaxed(&state->peak_bytes);
+  while (bytes > peak && !rtl_atomic_cas_relaxed(&state->peak_bytes, &peak, bytes)) {
+  }
+
+  return rtl_atomic_fetch_add_relaxed(&g_memory_usage, size) + size;
+}
+
+/**
+ * @internal
+ * @brief Removes an allocation from a tag's usage.
+ */
+static void _rtl_memory_tag_sub(unsigned tag, size_t size)
+{
+  rtl_memory_tag_state_t* state = &g_memory_tags[tag];
+  rtl_atomic_fetch_add_relaxed(&state->bytes, (uintptr_t)0 - size);
+  rtl_atomic_fetch_add_relaxed(&state->allocations, (uintptr_t)-1);
+
+  const size_t usage = rtl_atomic_fetch_add_relaxed(&g_memory_usage, (uintptr_t)0 - size) - size;
+  if (rtl_atomic_load_relaxed(&g_memory_over_limit) &&
+      usage <= rtl_atomic_load_relaxed(&g_memory_soft_limit)) {
+    rtl_atomic_store(&g_memory_over_limit, 0);
+  }
+}
+
 void* _rtl_malloc(const char* file, unsigned long line, unsigned long size)
 {
-#ifdef RTL_DEBUG_BUILD
+  return _rtl_malloc_tagged(file, line, RTL_MEM_TAG_USER, size);
+}
+
+void* _rtl_malloc_tagged(const char* file, unsigned long line, unsigned tag, unsigned long size)
+{
+  rtl_assert(tag < RTL_MEM_TAG_MAX, "Memory tag %u is out of range", tag);
+
   // It's not a memory leak, it's just a trick to add a bit more
   // info about allocated memory so...
   // ReSharper disable once CppDFAMemoryLeak
-  char* data = (char*)g_malloc_func(sizeof(rtl_memory_header_t) + size);
+  const size_t header_size = g_header_func ? 0 : sizeof(rtl_memory_header_t);
+  char* data = (char*)g_malloc_func(header_size + size);
 
   if (data == NULL) {
-    return NULL;
+    // Give caches a chance to release memory, then retry once
+    _rtl_memory_signal_pressure(
+      rtl_atomic_load_relaxed(&g_memory_usage), rtl_atomic_load_relaxed(&g_memory_soft_limit));
+    data = (char*)g_malloc_func(header_size + size);
+    if (data == NULL) {
+      return NULL;
+    }
+  }
+
+  rtl_memory_header_t* header = g_header_func ? g_header_func(data) : (rtl_memory_header_t*)data;
+  header->size = size;
+  header->tag = tag;
+  const size_t usage = _rtl_memory_tag_add(tag, size);
+
+  const size_t soft_limit = rtl_atomic_load_relaxed(&g_memory_soft_limit);
+  if (soft_limit != 0 && usage > soft_limit && rtl_atomic_exchange(&g_memory_over_limit, 1) == 0) {
+    _rtl_memory_signal_pressure(usage, soft_limit);
   }
 
-  rtl_memory_header_t* header = (rtl_memory_header_t*)data;
+#ifdef RTL_DEBUG_BUILD
   header->source_location.file = file;
   header->source_location.line = line;
-  header->size = size;
+  rtl_atomic_lock(&rtl_memory_allocations_lock);
   rtl_list_add_tail(&rtl_memory_allocations, &header->link);
+  rtl_atomic_unlock(&rtl_memory_allocations_lock);
   // Mark the memory with 0x77 to be able to debug uninitialized memory
-  memset(&data[sizeof(rtl_memory_header_t)], 0x77, size);
-  // Return only the needed piece and hide the header
-  // ReSharper disable once CppDFAMemoryLeak
-  return &data[sizeof(rtl_memory_header_t)];
+  memset(&data[header_size], 0x77, size);
 #else
-  return g_malloc_func(size);
+  (void)file;
+  (void)line;
 #endif
+
+  _rtl_trace_record(RTL_TRACE_OP_MALLOC, tag, size, &data[header_size]);
+
+  // Return only the needed piece and hide the header
+  // ReSharper disable once CppDFAMemoryLeak
+  return &data[header_size];
 }
 
 char* _rtl_strdup(const char* file, unsigned long line, const char* str)
@@ -111,15 +280,337 @@ void rtl_free(void* data)
     return;
   }
 
-#ifdef RTL_DEBUG_BUILD
   // Find the header with meta information
-  rtl_memory_header_t* header = (rtl_memory_header_t*)((char*)data - sizeof(rtl_memory_header_t));
+  rtl_memory_header_t* header = g_header_func
+    ? g_header_func(data)
+    : (rtl_memory_header_t*)((char*)data - sizeof(rtl_memory_header_t));
+  _rtl_memory_tag_sub((unsigned)header->tag, header->size);
+  _rtl_trace_record(RTL_TRACE_OP_FREE, (unsigned)header->tag, header->size, data);
+
+#ifdef RTL_DEBUG_BUILD
+  rtl_atomic_lock(&rtl_memory_allocations_lock);
   rtl_list_remove(&header->link);
+  rtl_atomic_unlock(&rtl_memory_allocations_lock);
+#endif
+
   // Now we can free the real allocated piece
-  g_free_func(header);
+  g_free_func(g_header_func ? data : (void*)header);
+}
+
+void rtl_memory_tag_set_name(unsigned tag, const char* name)
+{
+  rtl_assert(tag < RTL_MEM_TAG_MAX, "Memory tag %u is out of range", tag);
+  g_memory_tags[tag].name = name;
+}
+
+const char* rtl_memory_tag_name(unsigned tag)
+{
+  rtl_assert(tag < RTL_MEM_TAG_MAX, "Memory tag %u is out of range", tag);
+  return g_memory_tags[tag].name;
+}
+
+void rtl_memory_tag_set_limit(unsigned tag, size_t limit)
+{
+  rtl_assert(tag < RTL_MEM_TAG_MAX, "Memory tag %u is out of range", tag);
+  rtl_atomic_store(&g_memory_tags[tag].limit, limit);
+}
+
+bool rtl_memory_tag_within_limit(unsigned tag, size_t size)
+{
+  rtl_assert(tag < RTL_MEM_TAG_MAX, "Memory tag %u is out of range", tag);
+
+  const rtl_memory_tag_state_t* state = &g_memory_tags[tag];
+  const size_t limit = rtl_atomic_load_relaxed(&state->limit);
+  if (limit == 0) {
+    return true;
+  }
+
+  const size_t bytes = rtl_atomic_load_relaxed(&state->bytes);
+  return bytes <= limit && size <= limit - bytes;
+}
+
+void rtl_memory_tag_get_stats(unsigned tag, rtl_memory_tag_stats_t* stats)
+{
+  rtl_assert(tag < RTL_MEM_TAG_MAX, "Memory tag %u is out of range", tag);
+  rtl_assert(stats != NULL, "Stats cannot be NULL");
+
+  const rtl_memory_tag_state_t* state = &g_memory_tags[tag];
+  stats->bytes = rtl_atomic_load_relaxed(&state->bytes);
+  stats->peak_bytes = rtl_atomic_load_relaxed(&state->peak_bytes);
+  stats->allocations = rtl_atomic_load_relaxed(&state->allocations);
+  stats->limit = rtl_atomic_load_relaxed(&state->limit);
+}
+
+size_t rtl_memory_usage(void)
+{
+  return rtl_atomic_load_relaxed(&g_memory_usage);
+}
+
+void rtl_memory_set_soft_limit(size_t limit)
+{
+  rtl_atomic_store(&g_memory_soft_limit, limit);
+  rtl_atomic_store(&g_memory_over_limit, 0);
+}
+
+size_t rtl_memory_get_soft_limit(void)
+{
+  return rtl_atomic_load_relaxed(&g_memory_soft_limit);
+}
+
+bool rtl_memory_register_pressure_callback(
+  rtl_memory_pressure_callback_t callback, void* user_data)
+{
+  rtl_assert(callback != NULL, "Pressure callback cannot be NULL");
+
+  bool registered = false;
+  rtl_atomic_lock(&g_pressure_lock);
+  if (g_pressure_callback_count < RTL_MEMORY_MAX_PRESSURE_CALLBACKS) {
+    g_pressure_callbacks[g_pressure_callback_count].callback = callback;
+    g_pressure_callbacks[g_pressure_callback_count].user_data = user_data;
+    g_pressure_callback_count++;
+    registered = true;
+  }
+  rtl_atomic_unlock(&g_pressure_lock);
+
+  return registered;
+}
+
+void rtl_memory_unregister_pressure_callback(
+  rtl_memory_pressure_callback_t callback, void* user_data)
+{
+  rtl_atomic_lock(&g_pressure_lock);
+  for (unsigned long i = 0; i < g_pressure_callback_count; i++) {
+    if (g_pressure_callbacks[i].callback == callback &&
+        g_pressure_callbacks[i].user_data == user_data) {
+      g_pressure_callbacks[i] = g_pressure_callbacks[--g_pressure_callback_count];
+      break;
+    }
+  }
+  rtl_atomic_unlock(&g_pressure_lock);
+}
+
+#ifdef __linux__
+/**
+ * @internal
+ * @brief Reads a byte count from a cgroupfs file, "max" reads as 0 (unlimited).
+ */
+static bool _rtl_memory_read_cgroup_value(const char* path, size_t* value)
+{
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+
+  char buffer[64];
+  const bool read = fgets(buffer, sizeof(buffer), file) != NULL;
+  fclose(file);
+  if (!read) {
+    return false;
+  }
+
+  if (strncmp(buffer, "max", 3) == 0) {
+    *value = 0;
+    return true;
+  }
+
+  char* end;
+  const unsigned long long parsed = strtoull(buffer, &end, 10);
+  if (end == buffer) {
+    return false;
+  }
+
+  // cgroup v1 reports "unlimited" as a page-rounded LLONG_MAX
+  *value = parsed >= (1ULL << 62) ? 0 : (size_t)parsed;
+  return true;
+}
+#endif
+
+bool rtl_memory_read_cgroup(size_t* usage, size_t* limit)
+{
+  rtl_assert(usage != NULL, "Usage cannot be NULL");
+
+#ifdef __linux__
+  size_t max = 0;
+  char path[512];
+
+  // cgroup v2: "0::/path" in /proc/self/cgroup names our directory
+  FILE* file = fopen("/proc/self/cgroup", "r");
+  if (file != NULL) {
+    char line[384];
+    while (fgets(line, sizeof(line), file) != NULL) {
+      if (strncmp(line, "0::", 3) == 0) {
+        line[strcspn(line, "\n")] = '\0';
+        snprintf(path, sizeof(path), "/sys/fs/cgroup%s/memory.current", &line[3]);
+        if (_rtl_memory_read_cgroup_value(path, usage)) {
+          snprintf(path, sizeof(path), "/sys/fs/cgroup%s/memory.max", &line[3]);
+          _rtl_memory_read_cgroup_value(path, &max);
+          fclose(file);
+          if (limit) {
+            *limit = max;
+          }
+          return true;
+        }
+      }
+    }
+    fclose(file);
+  }
+
+  if (_rtl_memory_read_cgroup_value("/sys/fs/cgroup/memory/memory.usage_in_bytes", usage)) {
+    _rtl_memory_read_cgroup_value("/sys/fs/cgroup/memory/memory.limit_in_bytes", &max);
+    if (limit) {
+      *limit = max;
+    }
+    return true;
+  }
 #else
-  g_free_func(data);
+  (void)limit;
 #endif
+
+  return false;
+}
+
+bool rtl_memory_check_cgroup_pressure(unsigned percent)
+{
+  size_t usage;
+  size_t limit;
+  if (!rtl_memory_read_cgroup(&usage, &limit) || limit == 0) {
+    return false;
+  }
+
+  const size_t threshold = limit / 100 * percent;
+  if (usage < threshold) {
+    return false;
+  }
+
+  _rtl_memory_signal_pressure(usage, threshold);
+  return true;
+}
+
+/**
+ * @internal
+ * @brief Chunk of the per-thread scratch stack, its data follows the header.
+ */
+typedef struct rtl_scratch_chunk_t
+{
+  struct rtl_scratch_chunk_t* prev; /**< Chunk below this one on the stack */
+  char* data;                       /**< Aligned start of the usable bytes */
+  size_t capacity;                  /**< Number of usable bytes */
+  size_t used;                      /**< Number of bytes handed out */
+} rtl_scratch_chunk_t;
+
+/**
+ * @internal
+ * @brief Top of the calling thread's scratch stack.
+ */
+static RTL_THREAD_LOCAL rtl_scratch_chunk_t* g_scratch_top = NULL;
+
+/**
+ * @internal
+ * @brief Most recently popped chunk, kept so a push/pop cycle across a chunk
+ *        boundary doesn't hit the allocator every time.
+ */
+static RTL_THREAD_LOCAL rtl_scratch_chunk_t* g_scratch_spare = NULL;
+
+/**
+ * @internal
+ * @brief Maps a new scratch chunk able to hold at least size bytes.
+ */
+static rtl_scratch_chunk_t* _rtl_scratch_chunk_create(size_t size)
+{
+  const size_t capacity = size > RTL_SCRATCH_CHUNK_SIZE ? size : RTL_SCRATCH_CHUNK_SIZE;
+  // Chunks bypass rtl_malloc(), they are per-thread and never tracked as leaks,
+  // their memory is accounted to the scratch tag directly
+  rtl_scratch_chunk_t* chunk =
+    g_malloc_func(sizeof(rtl_scratch_chunk_t) + RTL_SCRATCH_ALIGNMENT + capacity);
+  if (chunk == NULL) {
+    return NULL;
+  }
+  _rtl_memory_tag_add(RTL_MEM_TAG_SCRATCH, capacity);
+
+  const uintptr_t data = (uintptr_t)(chunk + 1);
+  chunk->data =
+    (char*)((data + RTL_SCRATCH_ALIGNMENT - 1) & ~(uintptr_t)(RTL_SCRATCH_ALIGNMENT - 1));
+  chunk->capacity = capacity;
+  chunk->used = 0;
+  chunk->prev = NULL;
+  return chunk;
+}
+
+/**
+ * @internal
+ * @brief Returns a scratch chunk to the allocator.
+ */
+static void _rtl_scratch_chunk_destroy(rtl_scratch_chunk_t* chunk)
+{
+  _rtl_memory_tag_sub(RTL_MEM_TAG_SCRATCH, chunk->capacity);
+  g_free_func(chunk);
+}
+
+rtl_scratch_marker_t rtl_scratch_push(void)
+{
+  rtl_scratch_marker_t marker;
+  marker.chunk = g_scratch_top;
+  marker.offset = g_scratch_top ? g_scratch_top->used : 0;
+  return marker;
+}
+
+void* rtl_scratch_alloc(size_t size)
+{
+  const size_t aligned_size =
+    (size + RTL_SCRATCH_ALIGNMENT - 1) & ~(size_t)(RTL_SCRATCH_ALIGNMENT - 1);
+
+  rtl_scratch_chunk_t* chunk = g_scratch_top;
+  if (chunk == NULL || chunk->capacity - chunk->used < aligned_size) {
+    if (g_scratch_spare != NULL && g_scratch_spare->capacity >= aligned_size) {
+      chunk = g_scratch_spare;
+      g_scratch_spare = NULL;
+    } else {
+      chunk = _rtl_scratch_chunk_create(aligned_size);
+      if (chunk == NULL) {
+        return NULL;
+      }
+    }
+    chunk->used = 0;
+    chunk->prev = g_scratch_top;
+    g_scratch_top = chunk;
+  }
+
+  void* ptr = chunk->data + chunk->used;
+  chunk->used += aligned_size;
+  return ptr;
+}
+
+void rtl_scratch_pop(rtl_scratch_marker_t marker)
+{
+  while (g_scratch_top != NULL && g_scratch_top != marker.chunk) {
+    rtl_scratch_chunk_t* chunk = g_scratch_top;
+    g_scratch_top = chunk->prev;
+
+    // Keep the larger of the two chunks around for the next overflow
+    if (g_scratch_spare == NULL || g_scratch_spare->capacity < chunk->capacity) {
+      rtl_scratch_chunk_t* replaced = g_scratch_spare;
+      g_scratch_spare = chunk;
+      chunk = replaced;
+    }
+    if (chunk != NULL) {
+      _rtl_scratch_chunk_destroy(chunk);
+    }
+  }
+
+  if (g_scratch_top != NULL) {
+    g_scratch_top->used = marker.offset;
+  }
+}
+
+void rtl_scratch_release(void)
+{
+  const rtl_scratch_marker_t bottom = { NULL, 0 };
+  rtl_scratch_pop(bottom);
+
+  if (g_scratch_spare != NULL) {
+    _rtl_scratch_chunk_destroy(g_scratch_spare);
+    g_scratch_spare = NULL;
+  }
 }
 
 void rtl_memory_init(rtl_malloc_func_t malloc_func, rtl_free_func_t free_func)
@@ -127,6 +618,20 @@ void rtl_memory_init(rtl_malloc_func_t malloc_func, rtl_free_func_t free_func)
   // Set custom allocators or default to standard malloc/free wrappers
   g_malloc_func = malloc_func ? malloc_func : default_malloc_wrapper;
   g_free_func = free_func ? free_func : default_free_wrapper;
+  g_header_func = NULL;
+
+  memset(g_memory_tags, 0, sizeof(g_memory_tags));
+  rtl_atomic_store(&g_memory_usage, 0);
+  rtl_atomic_store(&g_memory_soft_limit, 0);
+  rtl_atomic_store(&g_memory_over_limit, 0);
+  g_pressure_callback_count = 0;
+  g_memory_tags[RTL_MEM_TAG_USER].name = "user";
+  g_memory_tags[RTL_MEM_TAG_HASH].name = "hash";
+  g_memory_tags[RTL_MEM_TAG_RECLAIM].name = "reclaim";
+  g_memory_tags[RTL_MEM_TAG_SCRATCH].name = "scratch";
+  g_memory_tags[RTL_MEM_TAG_QUEUE].name = "queue";
+  g_memory_tags[RTL_MEM_TAG_SKIPLIST].name = "skiplist";
+  g_memory_tags[RTL_MEM_TAG_VECTOR].name = "vector";
 
 #ifdef RTL_DEBUG_BUILD
   rtl_list_init(&rtl_memory_allocations);
@@ -135,16 +640,34 @@ void rtl_memory_init(rtl_malloc_func_t malloc_func, rtl_free_func_t free_func)
 
 void rtl_memory_cleanup()
 {
+  rtl_scratch_release();
+
 #ifdef RTL_DEBUG_BUILD
   rtl_list_entry_t* entry;
   rtl_list_entry_t* safe;
   rtl_list_for_each_safe(entry, safe, &rtl_memory_allocations)
   {
     rtl_memory_header_t* header = rtl_list_record(entry, rtl_memory_header_t, link);
-    rtl_log_err("Leaked memory, file: %s, line: %lu, size: %lu", header->source_location.file,
-      header->source_location.line, header->size);
+    const char* tag_name = g_memory_tags[header->tag].name;
+    rtl_log_err("Leaked memory, file: %s, line: %lu, size: %lu, tag: %s",
+      header->source_location.file, header->source_location.line, header->size,
+      tag_name ? tag_name : "unnamed");
     rtl_list_remove(&header->link);
-    g_free_func(header);
+    // Out-of-line headers do not lead back to their blocks, those stay with the allocator
+    if (!g_header_func) {
+      g_free_func(header);
+    }
   }
 #endif
 }
+
+void rtl_memory_set_header_func(rtl_memory_header_func_t header_func)
+{
+  uintptr_t allocations = 0;
+  for (unsigned tag = 0; tag < RTL_MEM_TAG_MAX; tag++) {
+    allocations += rtl_atomic_load(&g_memory_tags[tag].allocations);
+  }
+  rtl_assert(allocations == 0, "Header function cannot change with %lu live allocations",
+    (unsigned long)allocations);
+  g_header_func = header_func;
+}
@@ -0,0 +1,276 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "rtl_mpmc.h"
+
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Number of failed attempts a blocking operation spins through before sleeping.
+ */
+#define RTL_MPMC_SPIN_COUNT 64
+
+/**
+ * @internal
+ * @brief Gets the sequence word of the cell for a position.
+ */
+static rtl_atomic_word_t* _rtl_mpmc_cell(const rtl_mpmc_t* queue, uintptr_t position)
+{
+  return (rtl_atomic_word_t*)(queue->cells + (position & queue->mask) * queue->cell_size);
+}
+
+/**
+ * @internal
+ * @brief Sleeps until the word no longer holds the expected value or a wake-up arrives.
+ */
+static void _rtl_mpmc_wait(rtl_atomic_u32_t* word, uint32_t expected)
+{
+#if defined(__linux__)
+  syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#elif defined(_WIN32)
+  (void)word;
+  (void)expected;
+  SwitchToThread();
+#else
+  (void)word;
+  (void)expected;
+  sched_yield();
+#endif
+}
+
+/**
+ * @internal
+ * @brief Bumps an event word and wakes one thread sleeping on it, if any wait.
+ *        Every element pushed or popped notifies once, so one sleeper per element is
+ *        enough; a woken thread that loses the race simply sleeps again.
+ */
+static void _rtl_mpmc_notify(rtl_atomic_u32_t* word, rtl_atomic_word_t* waiting)
+{
+  // Order the cell update before reading the waiter count, pairing with the
+  // waiter registering itself before its final retry
+  rtl_atomic_fence();
+  if (rtl_atomic_load_relaxed(waiting) == 0) {
+    return;
+  }
+
+  rtl_atomic_fetch_add_u32(word, 1);
+#if defined(__linux__)
+  syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+}
+
+bool rtl_mpmc_init(rtl_mpmc_t* queue, size_t capacity, size_t element_size)
+{
+  rtl_assert(queue != NULL, "Queue cannot be NULL");
+  rtl_assert(element_size > 0, "Element size must be greater than 0");
+
+  size_t rounded = 2;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+
+  // Keep every cell's sequence word aligned
+  const size_t cell_size = (sizeof(rtl_atomic_word_t) + element_size + sizeof(uintptr_t) - 1) &
+    ~(sizeof(uintptr_t) - 1);
+  queue->cells = rtl_malloc_tagged(RTL_MEM_TAG_QUEUE, rounded * cell_size);
+  if (!queue->cells) {
+    return false;
+  }
+
+  queue->mask = rounded - 1;
+  queue->element_size = element_size;
+  queue->cell_size = cell_size;
+
+  // A cell is free for the producer whose position equals its sequence
+  for (size_t i = 0; i < rounded; i++) {
+    rtl_atomic_store_relaxed(_rtl_mpmc_cell(queue, i), i);
+  }
+
+  rtl_atomic_store_relaxed(&queue->enqueue_pos, 0);
+  rtl_atomic_store_relaxed(&queue->dequeue_pos, 0);
+  rtl_atomic_store_relaxed(&queue->producers_waiting, 0);
+  rtl_atomic_store_relaxed(&queue->consumers_waiting, 0);
+  queue->not_full = 0;
+  queue->not_empty = 0;
+  rtl_atomic_fence();
+  return true;
+}
+
+void rtl_mpmc_cleanup(rtl_mpmc_t* queue)
+{
+  if (!queue) {
+    return;
+  }
+
+  rtl_free(queue->cells);
+  queue->cells = NULL;
+  queue->mask = 0;
+}
+
+size_t rtl_mpmc_capacity(const rtl_mpmc_t* queue)
+{
+  return queue->mask + 1;
+}
+
+/**
+ * @internal
+ * @brief Claims a position and copies an element into its cell.
+ */
+static bool _rtl_mpmc_try_push(rtl_mpmc_t* queue, const void* element)
+{
+  uintptr_t position = rtl_atomic_load_relaxed(&queue->enqueue_pos);
+  rtl_atomic_word_t* cell;
+
+  for (;;) {
+    cell = _rtl_mpmc_cell(queue, position);
+    const intptr_t diff = (intptr_t)rtl_atomic_load(cell) - (intptr_t)position;
+    if (diff == 0) {
+      if (rtl_atomic_cas(&queue->enqueue_pos, &position, position + 1)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;  // The cell still holds the element from one lap ago
+    } else {
+      position = rtl_atomic_load_relaxed(&queue->enqueue_pos);
+    }
+  }
+
+  memcpy((char*)cell + sizeof(rtl_atomic_word_t), element, queue->element_size);
+  rtl_atomic_store(cell, position + 1);
+  return true;
+}
+
+/**
+ * @internal
+ * @brief Claims a position and copies the element out of its cell.
+ */
+static bool _rtl_mpmc_try_pop(rtl_mpmc_t* queue, void* element)
+{
+  uintptr_t position = rtl_atomic_load_relaxed(&queue->dequeue_pos);
+  rtl_atomic_word_t* cell;
+
+  for (;;) {
+    cell = _rtl_mpmc_cell(queue, position);
+    const intptr_t diff = (intptr_t)rtl_atomic_load(cell) - (intptr_t)(position + 1);
+    if (diff == 0) {
+      if (rtl_atomic_cas(&queue->dequeue_pos, &position, position + 1)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;  // The producer for this position hasn't filled the cell yet
+    } else {
+      position = rtl_atomic_load_relaxed(&queue->dequeue_pos);
+    }
+  }
+
+  memcpy(element, (char*)cell + sizeof(rtl_atomic_word_t), queue->element_size);
+  rtl_atomic_store(cell, position + queue->mask + 1);
+  return true;
+}
+
+bool rtl_mpmc_try_push(rtl_mpmc_t* queue, const void* element)
+{
+  if (!_rtl_mpmc_try_push(queue, element)) {
+    return false;
+  }
+
+  _rtl_mpmc_notify(&queue->not_empty, &queue->consumers_waiting);
+  return true;
+}
+
+bool rtl_mpmc_try_pop(rtl_mpmc_t* queue, void* element)
+{
+  if (!_rtl_mpmc_try_pop(queue, element)) {
+    return false;
+  }
+
+  _rtl_mpmc_notify(&queue->not_full, &queue->producers_waiting);
+  return true;
+}
+
+void rtl_mpmc_push(rtl_mpmc_t* queue, const void* element)
+{
+  for (unsigned spin = 0; spin < RTL_MPMC_SPIN_COUNT; spin++) {
+    if (rtl_mpmc_try_push(queue, element)) {
+      return;
+    }
+    rtl_atomic_pause();
+  }
+
+  for (;;) {
+    // Register before the final retry so a consumer freeing a cell after it sees us
+    rtl_atomic_fetch_add(&queue->producers_waiting, 1);
+    const uint32_t event = rtl_atomic_load_u32(&queue->not_full);
+    if (_rtl_mpmc_try_push(queue, element)) {
+      rtl_atomic_fetch_add(&queue->producers_waiting, (uintptr_t)-1);
+      _rtl_mpmc_notify(&queue->not_empty, &queue->consumers_waiting);
+      return;
+    }
+
+    _rtl_mpmc_wait(&queue->not_full, event);
+    rtl_atomic_fetch_add(&queue->producers_waiting, (uintptr_t)-1);
+  }
+}
+
+void rtl_mpmc_pop(rtl_mpmc_t* queue, void* element)
+{
+  for (unsigned spin = 0; spin < RTL_MPMC_SPIN_COUNT; spin++) {
+    if (rtl_mpmc_try_pop(queue, element)) {
+      return;
+    }
+    rtl_atomic_pause();
+  }
+
+  for (;;) {
+    // Register before the final retry so a producer filling a cell after it sees us
+    rtl_atomic_fetch_add(&queue->consumers_waiting, 1);
+    const uint32_t event = rtl_atomic_load_u32(&queue->not_empty);
+    if (_rtl_mpmc_try_pop(queue, element)) {
+      rtl_atomic_fetch_add(&queue->consumers_waiting, (uintptr_t)-1);
+      _rtl_mpmc_notify(&queue->not_full, &queue->producers_waiting);
+      return;
+    }
+
+    _rtl_mpmc_wait(&queue->not_empty, event);
+    rtl_atomic_fetch_add(&queue->consumers_waiting, (uintptr_t)-1);
+  }
+}
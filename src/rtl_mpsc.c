@@ -0,0 +1,90 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_mpsc.h"
+
+#include <stddef.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+
+void rtl_mpsc_init(rtl_mpsc_t* queue)
+{
+  rtl_assert(queue != NULL, "Queue cannot be NULL");
+
+  rtl_atomic_store_ptr(&queue->stub.next, NULL);
+  rtl_atomic_store_ptr(&queue->head, &queue->stub);
+  queue->tail = &queue->stub;
+}
+
+void rtl_mpsc_push(rtl_mpsc_t* queue, rtl_mpsc_node_t* node)
+{
+  rtl_atomic_store_relaxed((rtl_atomic_word_t*)&node->next, 0);
+
+  // Claim the head, then link the previous head to us; the consumer can't see the
+  // node until the second step, which is why pop may briefly miss it
+  rtl_mpsc_node_t* prev = rtl_atomic_exchange_ptr(&queue->head, node);
+  rtl_atomic_store_ptr(&prev->next, node);
+}
+
+rtl_mpsc_node_t* rtl_mpsc_pop(rtl_mpsc_t* queue)
+{
+  rtl_mpsc_node_t* tail = queue->tail;
+  rtl_mpsc_node_t* next = rtl_atomic_load_ptr(&tail->next);
+
+  // Skip over the stub
+  if (tail == &queue->stub) {
+    if (next == NULL) {
+      return NULL;
+    }
+    queue->tail = next;
+    tail = next;
+    next = rtl_atomic_load_ptr(&next->next);
+  }
+
+  if (next != NULL) {
+    queue->tail = next;
+    return tail;
+  }
+
+  // The tail is the last linked node; if a producer is mid-push, wait for it
+  if (tail != rtl_atomic_load_ptr(&queue->head)) {
+    return NULL;
+  }
+
+  // Put the stub back behind the last node so it can be handed out
+  rtl_mpsc_push(queue, &queue->stub);
+  next = rtl_atomic_load_ptr(&tail->next);
+  if (next != NULL) {
+    queue->tail = next;
+    return tail;
+  }
+
+  return NULL;
+}
+
+bool rtl_mpsc_empty(const rtl_mpsc_t* queue)
+{
+  const rtl_mpsc_node_t* tail = queue->tail;
+  return tail == &queue->stub && rtl_atomic_load_ptr(&tail->next) == NULL;
+}
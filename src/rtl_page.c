@@ -0,0 +1,398 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "rtl_page.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "rtl_atomic.h"
+#include "rtl_list.h"
+
+#if !defined(_WIN32) && !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#if !defined(_WIN32) && !defined(MAP_NORESERVE)
+#define MAP_NORESERVE 0
+#endif
+
+/**
+ * @internal
+ * @brief Huge page size used when the platform can't report one.
+ */
+#define RTL_PAGE_DEFAULT_HUGE_SIZE (2UL * 1024UL * 1024UL)
+
+/**
+ * @internal
+ * @brief Record of a mapping handed out by rtl_huge_malloc().
+ *        Kept out of line so the block starts on the mapping and a request of
+ *        whole huge pages maps exactly that many.
+ */
+typedef struct rtl_huge_block_t
+{
+  rtl_list_entry_t link; /**< Link in g_huge_blocks */
+  void* ptr;             /**< Start of the mapping, returned to the caller */
+  size_t size;           /**< Size passed to rtl_page_alloc() */
+  unsigned flags;        /**< Flags the mapping was created with */
+} rtl_huge_block_t;
+
+/**
+ * @internal
+ * @brief Live rtl_huge_malloc() mappings. They are few and large, so a list suffices.
+ */
+static rtl_list_entry_t g_huge_blocks = { &g_huge_blocks, &g_huge_blocks };
+
+/**
+ * @internal
+ * @brief Spinlock guarding g_huge_blocks.
+ */
+static rtl_atomic_word_t g_huge_blocks_lock;
+
+/**
+ * @internal
+ * @brief Rounds size up to a multiple of alignment (must be a power of two).
+ */
+static size_t _rtl_page_round_up(size_t size, size_t alignment)
+{
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @internal
+ * @brief Rounds a requested size to the granularity used for the given flags.
+ */
+static size_t _rtl_page_mapping_size(size_t size, unsigned flags)
+{
+#ifdef _WIN32
+  // Large pages back both flags and only come in whole pages
+  if (flags & (RTL_PAGE_HUGE | RTL_PAGE_HUGETLB)) {
+    return _rtl_page_round_up(size, rtl_page_huge_size());
+  }
+#else
+  // hugetlbfs maps whole huge pages, transparent huge pages need no rounding
+  if (flags & RTL_PAGE_HUGETLB) {
+    return _rtl_page_round_up(size, rtl_page_huge_size());
+  }
+#endif
+
+  return _rtl_page_round_up(size, rtl_page_size());
+}
+
+size_t rtl_page_size(void)
+{
+  static size_t page_size = 0;
+  if (page_size == 0) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    page_size = info.dwPageSize;
+#else
+    const long result = sysconf(_SC_PAGESIZE);
+    page_size = result > 0 ? (size_t)result : 4096;
+#endif
+  }
+
+  return page_size;
+}
+
+size_t rtl_page_huge_size(void)
+{
+  static size_t huge_size = 0;
+  if (huge_size == 0) {
+#if defined(_WIN32)
+    const size_t large_page_size = GetLargePageMinimum();
+    huge_size = large_page_size ? large_page_size : RTL_PAGE_DEFAULT_HUGE_SIZE;
+#elif defined(__linux__)
+    // The default hugetlb size, which MAP_HUGETLB without a size flag maps with
+    unsigned long kilobytes = 0;
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo) {
+      char line[128];
+      while (fgets(line, sizeof(line), meminfo)) {
+        if (sscanf(line, "Hugepagesize: %lu kB", &kilobytes) == 1) {
+          break;
+        }
+      }
+      fclose(meminfo);
+    }
+    huge_size = kilobytes ? (size_t)kilobytes * 1024 : RTL_PAGE_DEFAULT_HUGE_SIZE;
+#else
+    huge_size = RTL_PAGE_DEFAULT_HUGE_SIZE;
+#endif
+  }
+
+  return huge_size;
+}
+
+#ifdef _WIN32
+
+void* rtl_page_alloc(size_t size, unsigned flags)
+{
+  const size_t mapping_size = _rtl_page_mapping_size(size, flags);
+
+  if (flags & (RTL_PAGE_HUGE | RTL_PAGE_HUGETLB)) {
+    // Large pages require SeLockMemoryPrivilege, fall back silently without it
+    void* ptr = VirtualAlloc(
+      NULL, mapping_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    if (ptr != NULL) {
+      return ptr;
+    }
+  }
+
+  return VirtualAlloc(NULL, mapping_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void rtl_page_free(void* ptr, size_t size, unsigned flags)
+{
+  (void)size;
+  (void)flags;
+
+  if (ptr != NULL) {
+    VirtualFree(ptr, 0, MEM_RELEASE);
+  }
+}
+
+void* rtl_page_reserve(size_t size)
+{
+  return VirtualAlloc(NULL, _rtl_page_round_up(size, rtl_page_size()), MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool rtl_page_commit(void* ptr, size_t size)
+{
+  return VirtualAlloc(ptr, _rtl_page_round_up(size, rtl_page_size()), MEM_COMMIT, PAGE_READWRITE) !=
+    NULL;
+}
+
+void rtl_page_decommit(void* ptr, size_t size)
+{
+  VirtualFree(ptr, _rtl_page_round_up(size, rtl_page_size()), MEM_DECOMMIT);
+}
+
+void rtl_page_release(void* ptr, size_t size)
+{
+  (void)size;
+
+  if (ptr != NULL) {
+    VirtualFree(ptr, 0, MEM_RELEASE);
+  }
+}
+
+#else
+
+/**
+ * @internal
+ * @brief Gets the size transparent huge pages collapse to, the PMD size.
+ *        It differs from rtl_page_huge_size() when the default hugetlb size is
+ *        changed, e.g. with default_hugepagesz=1G.
+ */
+static size_t _rtl_page_transparent_huge_size(void)
+{
+  static size_t thp_size = 0;
+  if (thp_size == 0) {
+    unsigned long bytes = 0;
+#if defined(__linux__)
+    FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+    if (file) {
+      if (fscanf(file, "%lu", &bytes) != 1) {
+        bytes = 0;
+      }
+      fclose(file);
+    }
+#endif
+    // Anything that isn't a power-of-two number of pages can't be used for alignment
+    if (bytes < rtl_page_size() || (bytes & (bytes - 1)) != 0) {
+      bytes = RTL_PAGE_DEFAULT_HUGE_SIZE;
+    }
+    thp_size = (size_t)bytes;
+  }
+
+  return thp_size;
+}
+
+/**
+ * @internal
+ * @brief Maps an anonymous region aligned to the transparent huge page size and
+ *        asks the kernel to back it with transparent huge pages.
+ *        Over-maps by one huge page and trims the unaligned head and tail,
+ *        because khugepaged only collapses huge page aligned ranges.
+ */
+static void* _rtl_page_alloc_transparent_huge(size_t mapping_size)
+{
+  const size_t huge_size = _rtl_page_transparent_huge_size();
+  char* raw = mmap(NULL, mapping_size + huge_size, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) {
+    return NULL;
+  }
+
+  char* aligned = (char*)_rtl_page_round_up((uintptr_t)raw, huge_size);
+  const size_t head = (size_t)(aligned - raw);
+  const size_t tail = huge_size - head;
+  if (head > 0) {
+    munmap(raw, head);
+  }
+  if (tail > 0) {
+    munmap(aligned + mapping_size, tail);
+  }
+
+#ifdef MADV_HUGEPAGE
+  // Only a hint, the mapping stays usable with regular pages if it fails
+  madvise(aligned, mapping_size, MADV_HUGEPAGE);
+#endif
+
+  return aligned;
+}
+
+void* rtl_page_alloc(size_t size, unsigned flags)
+{
+  const size_t mapping_size = _rtl_page_mapping_size(size, flags);
+
+#ifdef MAP_HUGETLB
+  if (flags & RTL_PAGE_HUGETLB) {
+    // Fails unless huge pages were reserved through vm.nr_hugepages
+    void* ptr = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+      return ptr;
+    }
+  }
+#endif
+
+  if (flags & (RTL_PAGE_HUGE | RTL_PAGE_HUGETLB)) {
+    void* ptr = _rtl_page_alloc_transparent_huge(mapping_size);
+    if (ptr != NULL) {
+      return ptr;
+    }
+  }
+
+  void* ptr =
+    mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return ptr != MAP_FAILED ? ptr : NULL;
+}
+
+void rtl_page_free(void* ptr, size_t size, unsigned flags)
+{
+  if (ptr != NULL) {
+    munmap(ptr, _rtl_page_mapping_size(size, flags));
+  }
+}
+
+void* rtl_page_reserve(size_t size)
+{
+  // MAP_NORESERVE keeps untouched reservations out of the overcommit accounting
+  void* ptr = mmap(NULL, _rtl_page_round_up(size, rtl_page_size()), PROT_NONE,
+    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  return ptr != MAP_FAILED ? ptr : NULL;
+}
+
+bool rtl_page_commit(void* ptr, size_t size)
+{
+  return mprotect(ptr, _rtl_page_round_up(size, rtl_page_size()), PROT_READ | PROT_WRITE) == 0;
+}
+
+void rtl_page_decommit(void* ptr, size_t size)
+{
+  const size_t length = _rtl_page_round_up(size, rtl_page_size());
+  // Drop the physical pages first, then make the range inaccessible again
+  madvise(ptr, length, MADV_DONTNEED);
+  mprotect(ptr, length, PROT_NONE);
+}
+
+void rtl_page_release(void* ptr, size_t size)
+{
+  if (ptr != NULL) {
+    munmap(ptr, _rtl_page_round_up(size, rtl_page_size()));
+  }
+}
+
+#endif
+
+void* rtl_huge_malloc(size_t size)
+{
+  // Smaller blocks would waste most of a huge page
+  if (size < RTL_HUGE_MALLOC_THRESHOLD || size < rtl_page_huge_size()) {
+    return malloc(size);
+  }
+
+  rtl_huge_block_t* block = malloc(sizeof(rtl_huge_block_t));
+  if (block == NULL) {
+    return NULL;
+  }
+
+  block->flags = RTL_PAGE_HUGETLB;
+  block->size = size;
+  block->ptr = rtl_page_alloc(size, block->flags);
+  if (block->ptr == NULL) {
+    free(block);
+    return NULL;
+  }
+
+  rtl_atomic_lock(&g_huge_blocks_lock);
+  rtl_list_add_head(&g_huge_blocks, &block->link);
+  rtl_atomic_unlock(&g_huge_blocks_lock);
+  return block->ptr;
+}
+
+void rtl_huge_free(void* ptr)
+{
+  if (ptr == NULL) {
+    return;
+  }
+
+  // Mappings are page aligned, anything else came from malloc()
+  rtl_huge_block_t* found = NULL;
+  if (((uintptr_t)ptr & (rtl_page_size() - 1)) == 0) {
+    rtl_atomic_lock(&g_huge_blocks_lock);
+    rtl_list_entry_t* entry;
+    rtl_list_for_each(entry, &g_huge_blocks)
+    {
+      rtl_huge_block_t* block = rtl_list_record(entry, rtl_huge_block_t, link);
+      if (block->ptr == ptr) {
+        rtl_list_remove(&block->link);
+        found = block;
+        break;
+      }
+    }
+    rtl_atomic_unlock(&g_huge_blocks_lock);
+  }
+
+  if (found) {
+    rtl_page_free(found->ptr, found->size, found->flags);
+    free(found);
+  } else {
+    free(ptr);
+  }
+}
@@ -0,0 +1,374 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_rbtree.h"
+
+#include "rtl.h"
+#include "rtl_log.h"
+
+/**
+ * @internal
+ * @brief Checks a node's color, NULL leaves are black.
+ */
+static RTL_INLINE bool _rtl_rbtree_is_red(const rtl_rb_node_t* node)
+{
+  return node && node->red;
+}
+
+/**
+ * @internal
+ * @brief Makes replacement take old's place under old's parent.
+ */
+static void _rtl_rbtree_replace(
+  rtl_rbtree_t* tree, rtl_rb_node_t* old, rtl_rb_node_t* replacement, rtl_rb_node_t* parent)
+{
+  if (!parent) {
+    tree->root = replacement;
+  } else if (parent->left == old) {
+    parent->left = replacement;
+  } else {
+    parent->right = replacement;
+  }
+}
+
+/**
+ * @internal
+ * @brief Rotates a node's right child up into its place.
+ */
+static void _rtl_rbtree_rotate_left(rtl_rbtree_t* tree, rtl_rb_node_t* node)
+{
+  rtl_rb_node_t* pivot = node->right;
+
+  node->right = pivot->left;
+  if (pivot->left) {
+    pivot->left->parent = node;
+  }
+
+  pivot->parent = node->parent;
+  _rtl_rbtree_replace(tree, node, pivot, node->parent);
+  pivot->left = node;
+  node->parent = pivot;
+}
+
+/**
+ * @internal
+ * @brief Rotates a node's left child up into its place.
+ */
+static void _rtl_rbtree_rotate_right(rtl_rbtree_t* tree, rtl_rb_node_t* node)
+{
+  rtl_rb_node_t* pivot = node->left;
+
+  node->left = pivot->right;
+  if (pivot->right) {
+    pivot->right->parent = node;
+  }
+
+  pivot->parent = node->parent;
+  _rtl_rbtree_replace(tree, node, pivot, node->parent);
+  pivot->right = node;
+  node->parent = pivot;
+}
+
+/**
+ * @internal
+ * @brief Restores the red-black properties after linking a red node.
+ */
+static void _rtl_rbtree_insert_fixup(rtl_rbtree_t* tree, rtl_rb_node_t* node)
+{
+  rtl_rb_node_t* parent;
+
+  while ((parent = node->parent) && parent->red) {
+    // A red parent is never the root, so the grandparent exists
+    rtl_rb_node_t* grandparent = parent->parent;
+
+    if (parent == grandparent->left) {
+      rtl_rb_node_t* uncle = grandparent->right;
+      if (_rtl_rbtree_is_red(uncle)) {
+        parent->red = false;
+        uncle->red = false;
+        grandparent->red = true;
+        node = grandparent;
+        continue;
+      }
+
+      if (node == parent->right) {
+        _rtl_rbtree_rotate_left(tree, parent);
+        node = parent;
+        parent = node->parent;
+      }
+      parent->red = false;
+      grandparent->red = true;
+      _rtl_rbtree_rotate_right(tree, grandparent);
+    } else {
+      rtl_rb_node_t* uncle = grandparent->left;
+      if (_rtl_rbtree_is_red(uncle)) {
+        parent->red = false;
+        uncle->red = false;
+        grandparent->red = true;
+        node = grandparent;
+        continue;
+      }
+
+      if (node == parent->left) {
+        _rtl_rbtree_rotate_right(tree, parent);
+        node = parent;
+        parent = node->parent;
+      }
+      parent->red = false;
+      grandparent->red = true;
+      _rtl_rbtree_rotate_left(tree, grandparent);
+    }
+  }
+
+  tree->root->red = false;
+}
+
+/**
+ * @internal
+ * @brief Restores the red-black properties after unlinking a black node.
+ *        node is the possibly NULL child that took its place under parent.
+ */
+static void _rtl_rbtree_erase_fixup(rtl_rbtree_t* tree, rtl_rb_node_t* node, rtl_rb_node_t* parent)
+{
+  while (node != tree->root && !_rtl_rbtree_is_red(node)) {
+    // The side that lost a black node always has a sibling
+    if (node == parent->left) {
+      rtl_rb_node_t* sibling = parent->right;
+      if (sibling->red) {
+        sibling->red = false;
+        parent->red = true;
+        _rtl_rbtree_rotate_left(tree, parent);
+        sibling = parent->right;
+      }
+
+      if (!_rtl_rbtree_is_red(sibling->left) && !_rtl_rbtree_is_red(sibling->right)) {
+        sibling->red = true;
+        node = parent;
+        parent = node->parent;
+        continue;
+      }
+
+      if (!_rtl_rbtree_is_red(sibling->right)) {
+        sibling->left->red = false;
+        sibling->red = true;
+        _rtl_rbtree_rotate_right(tree, sibling);
+        sibling = parent->right;
+      }
+      sibling->red = parent->red;
+      parent->red = false;
+      sibling->right->red = false;
+      _rtl_rbtree_rotate_left(tree, parent);
+    } else {
+      rtl_rb_node_t* sibling = parent->left;
+      if (sibling->red) {
+        sibling->red = false;
+        parent->red = true;
+        _rtl_rbtree_rotate_right(tree, parent);
+        sibling = parent->left;
+      }
+
+      if (!_rtl_rbtree_is_red(sibling->left) && !_rtl_rbtree_is_red(sibling->right)) {
+        sibling->red = true;
+        node = parent;
+        parent = node->parent;
+        continue;
+      }
+
+      if (!_rtl_rbtree_is_red(sibling->left)) {
+        sibling->right->red = false;
+        sibling->red = true;
+        _rtl_rbtree_rotate_left(tree, sibling);
+        sibling = parent->left;
+      }
+      sibling->red = parent->red;
+      parent->red = false;
+      sibling->left->red = false;
+      _rtl_rbtree_rotate_right(tree, parent);
+    }
+
+    node = tree->root;
+  }
+
+  if (node) {
+    node->red = false;
+  }
+}
+
+void rtl_rbtree_init(rtl_rbtree_t* tree, rtl_rbtree_compare_t compare)
+{
+  rtl_assert(tree != NULL, "Tree cannot be NULL");
+  rtl_assert(compare != NULL, "Compare function cannot be NULL");
+
+  tree->root = NULL;
+  tree->leftmost = NULL;
+  tree->compare = compare;
+}
+
+rtl_rb_node_t* rtl_rbtree_last(const rtl_rbtree_t* tree)
+{
+  rtl_rb_node_t* node = tree->root;
+  while (node && node->right) {
+    node = node->right;
+  }
+  return node;
+}
+
+rtl_rb_node_t* rtl_rbtree_next(const rtl_rb_node_t* node)
+{
+  if (node->right) {
+    node = node->right;
+    while (node->left) {
+      node = node->left;
+    }
+    return (rtl_rb_node_t*)node;
+  }
+
+  while (node->parent && node == node->parent->right) {
+    node = node->parent;
+  }
+  return node->parent;
+}
+
+rtl_rb_node_t* rtl_rbtree_prev(const rtl_rb_node_t* node)
+{
+  if (node->left) {
+    node = node->left;
+    while (node->right) {
+      node = node->right;
+    }
+    return (rtl_rb_node_t*)node;
+  }
+
+  while (node->parent && node == node->parent->left) {
+    node = node->parent;
+  }
+  return node->parent;
+}
+
+void rtl_rbtree_insert(rtl_rbtree_t* tree, rtl_rb_node_t* node)
+{
+  rtl_assert(tree != NULL, "Tree cannot be NULL");
+  rtl_assert(node != NULL, "Node cannot be NULL");
+
+  rtl_rb_node_t* parent = NULL;
+  rtl_rb_node_t** link = &tree->root;
+  bool leftmost = true;
+
+  // Equal nodes go right so they stay in insertion order
+  while (*link) {
+    parent = *link;
+    if (tree->compare(node, parent) < 0) {
+      link = &parent->left;
+    } else {
+      link = &parent->right;
+      leftmost = false;
+    }
+  }
+
+  node->parent = parent;
+  node->left = NULL;
+  node->right = NULL;
+  node->red = true;
+  *link = node;
+
+  if (leftmost) {
+    tree->leftmost = node;
+  }
+  _rtl_rbtree_insert_fixup(tree, node);
+}
+
+void rtl_rbtree_erase(rtl_rbtree_t* tree, rtl_rb_node_t* node)
+{
+  rtl_assert(tree != NULL, "Tree cannot be NULL");
+  rtl_assert(node != NULL, "Node cannot be NULL");
+
+  if (tree->leftmost == node) {
+    tree->leftmost = rtl_rbtree_next(node);
+  }
+
+  rtl_rb_node_t* child;
+  rtl_rb_node_t* parent;
+  bool removed_red;
+
+  if (!node->left || !node->right) {
+    // At most one child, which takes the node's place
+    child = node->left ? node->left : node->right;
+    parent = node->parent;
+    removed_red = node->red;
+    _rtl_rbtree_replace(tree, node, child, parent);
+    if (child) {
+      child->parent = parent;
+    }
+  } else {
+    // Two children, the successor moves into the node's place
+    rtl_rb_node_t* successor = node->right;
+    while (successor->left) {
+      successor = successor->left;
+    }
+
+    child = successor->right;
+    removed_red = successor->red;
+
+    if (successor->parent == node) {
+      parent = successor;
+    } else {
+      parent = successor->parent;
+      parent->left = child;
+      if (child) {
+        child->parent = parent;
+      }
+      successor->right = node->right;
+      successor->right->parent = successor;
+    }
+
+    _rtl_rbtree_replace(tree, node, successor, node->parent);
+    successor->parent = node->parent;
+    successor->left = node->left;
+    successor->left->parent = successor;
+    successor->red = node->red;
+  }
+
+  if (!removed_red) {
+    _rtl_rbtree_erase_fixup(tree, child, parent);
+  }
+}
+
+rtl_rb_node_t* rtl_rbtree_lower_bound(
+  const rtl_rbtree_t* tree, const void* key, rtl_rbtree_key_compare_t compare)
+{
+  rtl_assert(tree != NULL, "Tree cannot be NULL");
+  rtl_assert(compare != NULL, "Compare function cannot be NULL");
+
+  rtl_rb_node_t* node = tree->root;
+  rtl_rb_node_t* result = NULL;
+
+  while (node) {
+    if (compare(key, node) <= 0) {
+      result = node;
+      node = node->left;
+    } else {
+      node = node->right;
+    }
+  }
+  return result;
+}
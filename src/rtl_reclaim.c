@@ -0,0 +1,94 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_reclaim.h"
+
+static void _rtl_reclaim_ebr_begin(void* thread)
+{
+  rtl_ebr_enter(thread);
+}
+
+static void _rtl_reclaim_ebr_end(void* thread)
+{
+  rtl_ebr_leave(thread);
+}
+
+static void* _rtl_reclaim_ebr_protect(void* thread, unsigned slot, rtl_atomic_ptr_t* source)
+{
+  (void)thread;
+  (void)slot;
+
+  // Being inside the critical section is all the protection epochs need
+  return rtl_atomic_load_ptr(source);
+}
+
+static bool _rtl_reclaim_ebr_retire(void* thread, void* ptr)
+{
+  return rtl_ebr_retire(thread, ptr);
+}
+
+static void _rtl_reclaim_hazard_begin(void* thread)
+{
+  (void)thread;
+}
+
+static void _rtl_reclaim_hazard_end(void* thread)
+{
+  rtl_hazard_clear_all(thread);
+}
+
+static void* _rtl_reclaim_hazard_protect(void* thread, unsigned slot, rtl_atomic_ptr_t* source)
+{
+  return rtl_hazard_protect(thread, slot, source);
+}
+
+static bool _rtl_reclaim_hazard_retire(void* thread, void* ptr)
+{
+  return rtl_hazard_retire(thread, ptr);
+}
+
+const rtl_reclaim_ops_t rtl_reclaim_ebr_ops = {
+  _rtl_reclaim_ebr_begin,
+  _rtl_reclaim_ebr_end,
+  _rtl_reclaim_ebr_protect,
+  _rtl_reclaim_ebr_retire,
+};
+
+const rtl_reclaim_ops_t rtl_reclaim_hazard_ops = {
+  _rtl_reclaim_hazard_begin,
+  _rtl_reclaim_hazard_end,
+  _rtl_reclaim_hazard_protect,
+  _rtl_reclaim_hazard_retire,
+};
+
+void rtl_reclaim_init_ebr(rtl_reclaim_t* reclaim, rtl_ebr_thread_t* thread)
+{
+  reclaim->ops = &rtl_reclaim_ebr_ops;
+  reclaim->thread = thread;
+}
+
+void rtl_reclaim_init_hazard(rtl_reclaim_t* reclaim, rtl_hazard_thread_t* thread)
+{
+  reclaim->ops = &rtl_reclaim_hazard_ops;
+  reclaim->thread = thread;
+}
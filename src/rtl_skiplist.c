@@ -0,0 +1,389 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_skiplist.h"
+
+#include <string.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Low bit of a link, set once the node owning the link is being removed.
+ */
+#define RTL_SKIPLIST_MARK ((uintptr_t)1)
+
+/**
+ * @internal
+ * @brief Source of per-thread seeds for tower heights.
+ */
+static rtl_atomic_word_t g_skiplist_seed;
+static RTL_THREAD_LOCAL uint32_t g_skiplist_random = 0;
+
+/**
+ * @internal
+ * @brief Strips the mark from a link.
+ */
+static RTL_INLINE rtl_skiplist_node_t* _rtl_skiplist_ptr(uintptr_t link)
+{
+  return (rtl_skiplist_node_t*)(link & ~RTL_SKIPLIST_MARK);
+}
+
+/**
+ * @internal
+ * @brief Gets the key stored after a node's tower.
+ */
+static RTL_INLINE const void* _rtl_skiplist_key(const rtl_skiplist_node_t* node)
+{
+  return (const void*)&node->next[node->height];
+}
+
+/**
+ * @internal
+ * @brief Picks a tower height, each level promoted with probability 1/4.
+ */
+static uintptr_t _rtl_skiplist_random_height(void)
+{
+  uint32_t x = g_skiplist_random;
+  if (x == 0) {
+    x = (uint32_t)rtl_atomic_fetch_add(&g_skiplist_seed, 0x9E3779B9u) | 1u;
+  }
+
+  // xorshift32
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  g_skiplist_random = x;
+
+  uintptr_t height = 1;
+  while (height < RTL_SKIPLIST_MAX_HEIGHT && (x & 3) == 0) {
+    height++;
+    x >>= 2;
+  }
+  return height;
+}
+
+/**
+ * @internal
+ * @brief Allocates a node with its tower and key in one block.
+ */
+static rtl_skiplist_node_t* _rtl_skiplist_node_alloc(
+  const rtl_skiplist_t* list, uintptr_t height, const void* key)
+{
+  rtl_skiplist_node_t* node = rtl_malloc_tagged(RTL_MEM_TAG_SKIPLIST,
+    sizeof(rtl_skiplist_node_t) + height * sizeof(rtl_atomic_word_t) + list->key_size);
+  if (!node) {
+    return NULL;
+  }
+
+  node->height = height;
+  for (uintptr_t level = 0; level < height; level++) {
+    rtl_atomic_store_relaxed(&node->next[level], 0);
+  }
+  if (key) {
+    memcpy((void*)_rtl_skiplist_key(node), key, list->key_size);
+  }
+  return node;
+}
+
+/**
+ * @internal
+ * @brief Drops a reference, retiring the node when both the inserter and the
+ *        remover are done with it, which guarantees it is unlinked on every level.
+ */
+static void _rtl_skiplist_release(rtl_ebr_thread_t* thread, rtl_skiplist_node_t* node)
+{
+  if (rtl_atomic_fetch_add(&node->refs, (uintptr_t)-1) == 1 && !rtl_ebr_retire(thread, node)) {
+    rtl_log_err("Cannot retire skip list node %p, leaking it", (void*)node);
+  }
+}
+
+/**
+ * @internal
+ * @brief Locates the predecessors and successors of a key on every level,
+ *        unlinking marked nodes met on the way.
+ * @return true if an unmarked node with the key follows the level 0 predecessor.
+ */
+static bool _rtl_skiplist_search(const rtl_skiplist_t* list, const void* key,
+  rtl_skiplist_node_t** preds, rtl_skiplist_node_t** succs)
+{
+retry:;
+  rtl_skiplist_node_t* pred = list->head;
+  rtl_skiplist_node_t* curr = NULL;
+
+  for (int level = RTL_SKIPLIST_MAX_HEIGHT - 1; level >= 0; level--) {
+    curr = _rtl_skiplist_ptr(rtl_atomic_load(&pred->next[level]));
+    while (curr) {
+      const uintptr_t succ = rtl_atomic_load(&curr->next[level]);
+      if (succ & RTL_SKIPLIST_MARK) {
+        // Help the remover, a failed CAS means pred changed or is being removed itself
+        uintptr_t expected = (uintptr_t)curr;
+        if (!rtl_atomic_cas(&pred->next[level], &expected, succ & ~RTL_SKIPLIST_MARK)) {
+          goto retry;
+        }
+        curr = _rtl_skiplist_ptr(succ);
+        continue;
+      }
+
+      if (list->compare(_rtl_skiplist_key(curr), key) >= 0) {
+        break;
+      }
+      pred = curr;
+      curr = (rtl_skiplist_node_t*)succ;
+    }
+
+    preds[level] = pred;
+    succs[level] = curr;
+  }
+
+  return curr && list->compare(_rtl_skiplist_key(curr), key) == 0;
+}
+
+/**
+ * @internal
+ * @brief Finds the first unmarked node whose key is not below the given one
+ *        without writing to the list.
+ */
+static rtl_skiplist_node_t* _rtl_skiplist_lower_bound(const rtl_skiplist_t* list, const void* key)
+{
+  rtl_skiplist_node_t* pred = list->head;
+  rtl_skiplist_node_t* curr = NULL;
+
+  for (int level = RTL_SKIPLIST_MAX_HEIGHT - 1; level >= 0; level--) {
+    curr = _rtl_skiplist_ptr(rtl_atomic_load(&pred->next[level]));
+    while (curr) {
+      const uintptr_t succ = rtl_atomic_load(&curr->next[level]);
+      if (succ & RTL_SKIPLIST_MARK) {
+        curr = _rtl_skiplist_ptr(succ);
+      } else if (key && list->compare(_rtl_skiplist_key(curr), key) < 0) {
+        pred = curr;
+        curr = (rtl_skiplist_node_t*)succ;
+      } else {
+        break;
+      }
+    }
+  }
+
+  return curr;
+}
+
+bool rtl_skiplist_init(rtl_skiplist_t* list, size_t key_size, rtl_skiplist_compare_t compare)
+{
+  rtl_assert(list != NULL, "List cannot be NULL");
+  rtl_assert(key_size > 0, "Key size must be greater than 0");
+  rtl_assert(compare != NULL, "Compare function cannot be NULL");
+
+  list->key_size = key_size;
+  list->compare = compare;
+  list->head = _rtl_skiplist_node_alloc(list, RTL_SKIPLIST_MAX_HEIGHT, NULL);
+  if (!list->head) {
+    return false;
+  }
+
+  rtl_atomic_store_relaxed(&list->head->refs, 1);
+  rtl_atomic_store_ptr(&list->head->value, NULL);
+  return true;
+}
+
+void rtl_skiplist_cleanup(rtl_skiplist_t* list)
+{
+  if (!list || !list->head) {
+    return;
+  }
+
+  // Removed nodes were unlinked before being retired, everything left is live
+  uintptr_t link = rtl_atomic_load(&list->head->next[0]);
+  while (_rtl_skiplist_ptr(link)) {
+    rtl_skiplist_node_t* node = _rtl_skiplist_ptr(link);
+    link = rtl_atomic_load(&node->next[0]);
+    rtl_free(node);
+  }
+
+  rtl_free(list->head);
+  list->head = NULL;
+}
+
+bool rtl_skiplist_insert(
+  rtl_skiplist_t* list, rtl_ebr_thread_t* thread, const void* key, void* value)
+{
+  rtl_assert(list != NULL, "List cannot be NULL");
+  rtl_assert(key != NULL, "Key cannot be NULL");
+
+  rtl_skiplist_node_t* preds[RTL_SKIPLIST_MAX_HEIGHT];
+  rtl_skiplist_node_t* succs[RTL_SKIPLIST_MAX_HEIGHT];
+
+  rtl_skiplist_node_t* node = _rtl_skiplist_node_alloc(list, _rtl_skiplist_random_height(), key);
+  if (!node) {
+    return false;
+  }
+  rtl_atomic_store_ptr(&node->value, value);
+  rtl_atomic_store_relaxed(&node->refs, 2);
+
+  rtl_ebr_enter(thread);
+
+  // Publishing the node on level 0 is the linearization point
+  for (;;) {
+    if (_rtl_skiplist_search(list, key, preds, succs)) {
+      rtl_ebr_leave(thread);
+      rtl_free(node);
+      return false;
+    }
+
+    for (uintptr_t level = 0; level < node->height; level++) {
+      rtl_atomic_store_relaxed(&node->next[level], (uintptr_t)succs[level]);
+    }
+
+    uintptr_t expected = (uintptr_t)succs[0];
+    if (rtl_atomic_cas(&preds[0]->next[0], &expected, (uintptr_t)node)) {
+      break;
+    }
+  }
+
+  // Link the upper levels, giving up as soon as a remover marks the node
+  for (uintptr_t level = 1; level < node->height; level++) {
+    for (;;) {
+      uintptr_t next = rtl_atomic_load(&node->next[level]);
+      if (next & RTL_SKIPLIST_MARK) {
+        goto linked;
+      }
+      if (next != (uintptr_t)succs[level] &&
+        !rtl_atomic_cas(&node->next[level], &next, (uintptr_t)succs[level])) {
+        goto linked;
+      }
+
+      uintptr_t expected = (uintptr_t)succs[level];
+      if (rtl_atomic_cas(&preds[level]->next[level], &expected, (uintptr_t)node)) {
+        break;
+      }
+      _rtl_skiplist_search(list, key, preds, succs);
+    }
+  }
+
+linked:
+  // A remover may have run its cleanup before we linked some level
+  if (rtl_atomic_load(&node->next[0]) & RTL_SKIPLIST_MARK) {
+    _rtl_skiplist_search(list, key, preds, succs);
+  }
+  _rtl_skiplist_release(thread, node);
+
+  rtl_ebr_leave(thread);
+  return true;
+}
+
+bool rtl_skiplist_remove(
+  rtl_skiplist_t* list, rtl_ebr_thread_t* thread, const void* key, void** value)
+{
+  rtl_assert(list != NULL, "List cannot be NULL");
+  rtl_assert(key != NULL, "Key cannot be NULL");
+
+  rtl_skiplist_node_t* preds[RTL_SKIPLIST_MAX_HEIGHT];
+  rtl_skiplist_node_t* succs[RTL_SKIPLIST_MAX_HEIGHT];
+
+  rtl_ebr_enter(thread);
+
+  if (!_rtl_skiplist_search(list, key, preds, succs)) {
+    rtl_ebr_leave(thread);
+    return false;
+  }
+
+  // Mark top-down so the node disappears from level 0 last
+  rtl_skiplist_node_t* node = succs[0];
+  for (uintptr_t level = node->height - 1; level > 0; level--) {
+    uintptr_t next = rtl_atomic_load(&node->next[level]);
+    while (!(next & RTL_SKIPLIST_MARK) &&
+      !rtl_atomic_cas(&node->next[level], &next, next | RTL_SKIPLIST_MARK)) {
+    }
+  }
+
+  // Whoever marks level 0 owns the removal
+  uintptr_t next = rtl_atomic_load(&node->next[0]);
+  for (;;) {
+    if (next & RTL_SKIPLIST_MARK) {
+      rtl_ebr_leave(thread);
+      return false;
+    }
+    if (rtl_atomic_cas(&node->next[0], &next, next | RTL_SKIPLIST_MARK)) {
+      break;
+    }
+  }
+
+  if (value) {
+    *value = rtl_atomic_load_ptr(&node->value);
+  }
+
+  _rtl_skiplist_search(list, key, preds, succs);
+  _rtl_skiplist_release(thread, node);
+
+  rtl_ebr_leave(thread);
+  return true;
+}
+
+bool rtl_skiplist_find(
+  rtl_skiplist_t* list, rtl_ebr_thread_t* thread, const void* key, void** value)
+{
+  rtl_assert(list != NULL, "List cannot be NULL");
+  rtl_assert(key != NULL, "Key cannot be NULL");
+
+  rtl_ebr_enter(thread);
+
+  const rtl_skiplist_node_t* node = _rtl_skiplist_lower_bound(list, key);
+  const bool found = node && list->compare(_rtl_skiplist_key(node), key) == 0;
+  if (found && value) {
+    *value = rtl_atomic_load_ptr(&node->value);
+  }
+
+  rtl_ebr_leave(thread);
+  return found;
+}
+
+unsigned long rtl_skiplist_for_each_range(rtl_skiplist_t* list, rtl_ebr_thread_t* thread,
+  const void* from, const void* to, rtl_skiplist_callback_t callback, void* user_data)
+{
+  rtl_assert(list != NULL, "List cannot be NULL");
+  rtl_assert(callback != NULL, "Callback cannot be NULL");
+
+  unsigned long count = 0;
+  rtl_ebr_enter(thread);
+
+  rtl_skiplist_node_t* node = _rtl_skiplist_lower_bound(list, from);
+  while (node) {
+    const void* key = _rtl_skiplist_key(node);
+    if (to && list->compare(key, to) >= 0) {
+      break;
+    }
+
+    const uintptr_t next = rtl_atomic_load(&node->next[0]);
+    if (!(next & RTL_SKIPLIST_MARK)) {
+      count++;
+      if (!callback(key, rtl_atomic_load_ptr(&node->value), user_data)) {
+        break;
+      }
+    }
+    node = _rtl_skiplist_ptr(next);
+  }
+
+  rtl_ebr_leave(thread);
+  return count;
+}
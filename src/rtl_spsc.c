@@ -0,0 +1,184 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_spsc.h"
+
+#include <string.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Copies elements into the ring starting at an index, wrapping around the end.
+ */
+static void _rtl_spsc_copy_in(rtl_spsc_t* ring, uintptr_t index, const char* source, size_t count)
+{
+  const size_t offset = index & ring->mask;
+  const size_t first = count < ring->mask + 1 - offset ? count : ring->mask + 1 - offset;
+
+  memcpy(ring->buffer + offset * ring->element_size, source, first * ring->element_size);
+  memcpy(ring->buffer, source + first * ring->element_size, (count - first) * ring->element_size);
+}
+
+/**
+ * @internal
+ * @brief Copies elements out of the ring starting at an index, wrapping around the end.
+ */
+static void _rtl_spsc_copy_out(const rtl_spsc_t* ring, uintptr_t index, char* target, size_t count)
+{
+  const size_t offset = index & ring->mask;
+  const size_t first = count < ring->mask + 1 - offset ? count : ring->mask + 1 - offset;
+
+  memcpy(target, ring->buffer + offset * ring->element_size, first * ring->element_size);
+  memcpy(target + first * ring->element_size, ring->buffer, (count - first) * ring->element_size);
+}
+
+bool rtl_spsc_init(rtl_spsc_t* ring, size_t capacity, size_t element_size)
+{
+  rtl_assert(ring != NULL, "Ring cannot be NULL");
+  rtl_assert(capacity > 0, "Capacity must be greater than 0");
+  rtl_assert(element_size > 0, "Element size must be greater than 0");
+
+  size_t rounded = 1;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+
+  ring->buffer = rtl_malloc_tagged(RTL_MEM_TAG_QUEUE, rounded * element_size);
+  if (!ring->buffer) {
+    return false;
+  }
+
+  ring->mask = rounded - 1;
+  ring->element_size = element_size;
+  rtl_atomic_store_relaxed(&ring->head, 0);
+  rtl_atomic_store_relaxed(&ring->tail, 0);
+  ring->cached_head = 0;
+  ring->cached_tail = 0;
+  return true;
+}
+
+void rtl_spsc_cleanup(rtl_spsc_t* ring)
+{
+  if (!ring) {
+    return;
+  }
+
+  rtl_free(ring->buffer);
+  ring->buffer = NULL;
+  ring->mask = 0;
+}
+
+size_t rtl_spsc_capacity(const rtl_spsc_t* ring)
+{
+  return ring->mask + 1;
+}
+
+size_t rtl_spsc_size(const rtl_spsc_t* ring)
+{
+  // Head first: tail only grows, so the difference can't go negative
+  const uintptr_t head = rtl_atomic_load(&ring->head);
+  const uintptr_t tail = rtl_atomic_load(&ring->tail);
+  return (size_t)(tail - head);
+}
+
+bool rtl_spsc_push(rtl_spsc_t* ring, const void* element)
+{
+  const uintptr_t tail = rtl_atomic_load_relaxed(&ring->tail);
+
+  if (tail - ring->cached_head > ring->mask) {
+    ring->cached_head = rtl_atomic_load(&ring->head);
+    if (tail - ring->cached_head > ring->mask) {
+      return false;
+    }
+  }
+
+  memcpy(ring->buffer + (tail & ring->mask) * ring->element_size, element, ring->element_size);
+  rtl_atomic_store(&ring->tail, tail + 1);
+  return true;
+}
+
+bool rtl_spsc_pop(rtl_spsc_t* ring, void* element)
+{
+  const uintptr_t head = rtl_atomic_load_relaxed(&ring->head);
+
+  if (ring->cached_tail == head) {
+    ring->cached_tail = rtl_atomic_load(&ring->tail);
+    if (ring->cached_tail == head) {
+      return false;
+    }
+  }
+
+  memcpy(element, ring->buffer + (head & ring->mask) * ring->element_size, ring->element_size);
+  rtl_atomic_store(&ring->head, head + 1);
+  return true;
+}
+
+size_t rtl_spsc_push_batch(rtl_spsc_t* ring, const void* elements, size_t count)
+{
+  const uintptr_t tail = rtl_atomic_load_relaxed(&ring->tail);
+  const size_t capacity = ring->mask + 1;
+
+  // Only refresh the consumer's index when the cached one says there's no room
+  size_t space = capacity - (size_t)(tail - ring->cached_head);
+  if (space < count) {
+    ring->cached_head = rtl_atomic_load(&ring->head);
+    space = capacity - (size_t)(tail - ring->cached_head);
+  }
+
+  if (count > space) {
+    count = space;
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  _rtl_spsc_copy_in(ring, tail, elements, count);
+  rtl_atomic_store(&ring->tail, tail + count);
+  return count;
+}
+
+size_t rtl_spsc_pop_batch(rtl_spsc_t* ring, void* elements, size_t count)
+{
+  const uintptr_t head = rtl_atomic_load_relaxed(&ring->head);
+
+  // Only refresh the producer's index when the cached one says there's too little
+  size_t available = (size_t)(ring->cached_tail - head);
+  if (available < count) {
+    ring->cached_tail = rtl_atomic_load(&ring->tail);
+    available = (size_t)(ring->cached_tail - head);
+  }
+
+  if (count > available) {
+    count = available;
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  _rtl_spsc_copy_out(ring, head, elements, count);
+  rtl_atomic_store(&ring->head, head + count);
+  return count;
+}
@@ -0,0 +1,287 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "rtl_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include "rtl.h"
+#include "rtl_atomic.h"
+#include "rtl_log.h"
+#include "rtl_platform.h"
+
+/**
+ * @internal
+ * @brief Set while a trace is being recorded, checked before claiming a slot.
+ */
+static rtl_atomic_word_t g_trace_active;
+
+/**
+ * @internal
+ * @brief Spinlock serializing rtl_trace_start(), rtl_trace_stop() and rtl_trace_flush().
+ *        The allocation path never takes it.
+ */
+static rtl_atomic_word_t g_trace_lock;
+
+/**
+ * @internal
+ * @brief Bit of g_trace_head that refuses new records outside of a trace.
+ */
+#define RTL_TRACE_CLOSED ((uintptr_t)1 << (sizeof(uintptr_t) * 8 - 1))
+
+/**
+ * @internal
+ * @brief Sequence number of the next record, with RTL_TRACE_CLOSED while no trace runs.
+ *        Record n goes to slot n % RTL_TRACE_BUFFER_RECORDS of buffer
+ *        (n / RTL_TRACE_BUFFER_RECORDS) % RTL_TRACE_BUFFERS.
+ */
+static rtl_atomic_word_t g_trace_head = RTL_TRACE_CLOSED;
+
+/**
+ * @internal
+ * @brief Number of buffer laps written to the file, buffers are written in sequence order.
+ */
+static rtl_atomic_word_t g_trace_written;
+
+/**
+ * @internal
+ * @brief Number of records filled in each buffer during its current lap.
+ */
+static rtl_atomic_word_t g_trace_committed[RTL_TRACE_BUFFERS];
+
+/**
+ * @internal
+ * @brief Set when a buffer could not be written to the file.
+ */
+static rtl_atomic_word_t g_trace_failed;
+
+/**
+ * @internal
+ * @brief Trace file and the ring of record buffers waiting to be written to it.
+ */
+static FILE* g_trace_file = NULL;
+static rtl_trace_record_t g_trace_ring[RTL_TRACE_BUFFERS][RTL_TRACE_BUFFER_RECORDS];
+
+/**
+ * @internal
+ * @brief Clock reading taken when the trace was started.
+ */
+static uint64_t g_trace_start_time = 0;
+
+/**
+ * @internal
+ * @brief Source of per-thread identifiers, and the calling thread's identifier (0 if unset).
+ */
+static rtl_atomic_word_t g_trace_next_thread;
+static RTL_THREAD_LOCAL uint32_t g_trace_thread = 0;
+
+/**
+ * @internal
+ * @brief Reads a monotonic clock in nanoseconds.
+ */
+static uint64_t _rtl_trace_now(void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER counter;
+  LARGE_INTEGER frequency;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&frequency);
+  return (uint64_t)(counter.QuadPart / frequency.QuadPart * 1000000000ULL +
+    counter.QuadPart % frequency.QuadPart * 1000000000ULL / frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @internal
+ * @brief Gives up the CPU while waiting on another thread's trace write.
+ */
+static void _rtl_trace_yield(void)
+{
+#ifdef _WIN32
+  SwitchToThread();
+#else
+  sched_yield();
+#endif
+}
+
+/**
+ * @internal
+ * @brief Writes the first count records of a buffer lap once every earlier lap is
+ *        in the file, then hands the buffer back to the appenders.
+ */
+static void _rtl_trace_write(uintptr_t lap, uintptr_t count)
+{
+  while (rtl_atomic_load(&g_trace_written) != lap) {
+    _rtl_trace_yield();
+  }
+
+  const rtl_trace_record_t* records = g_trace_ring[lap % RTL_TRACE_BUFFERS];
+  if (fwrite(records, sizeof(rtl_trace_record_t), count, g_trace_file) != count) {
+    rtl_atomic_store(&g_trace_failed, 1);
+    rtl_log_err("Failed to write allocation trace records");
+  }
+
+  rtl_atomic_store(&g_trace_committed[lap % RTL_TRACE_BUFFERS], 0);
+  rtl_atomic_store(&g_trace_written, lap + 1);
+}
+
+bool rtl_trace_start(const char* path)
+{
+  rtl_assert(path != NULL, "Trace path cannot be NULL");
+
+  rtl_atomic_lock(&g_trace_lock);
+  if (g_trace_file != NULL) {
+    rtl_atomic_unlock(&g_trace_lock);
+    rtl_log_wrn("Allocation trace is already running");
+    return false;
+  }
+
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    rtl_atomic_unlock(&g_trace_lock);
+    rtl_log_err("Failed to open trace file %s", path);
+    return false;
+  }
+
+  rtl_trace_file_header_t header;
+  memcpy(header.magic, RTL_TRACE_MAGIC, sizeof(header.magic));
+  header.version = RTL_TRACE_VERSION;
+  header.record_size = sizeof(rtl_trace_record_t);
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    fclose(file);
+    rtl_atomic_unlock(&g_trace_lock);
+    rtl_log_err("Failed to write trace file header to %s", path);
+    return false;
+  }
+
+  g_trace_file = file;
+  g_trace_start_time = _rtl_trace_now();
+  rtl_atomic_store(&g_trace_written, 0);
+  rtl_atomic_store(&g_trace_failed, 0);
+  for (unsigned i = 0; i < RTL_TRACE_BUFFERS; i++) {
+    rtl_atomic_store(&g_trace_committed[i], 0);
+  }
+  rtl_atomic_store(&g_trace_head, 0);
+  rtl_atomic_store(&g_trace_active, 1);
+  rtl_atomic_unlock(&g_trace_lock);
+  return true;
+}
+
+void rtl_trace_stop(void)
+{
+  rtl_atomic_lock(&g_trace_lock);
+  rtl_atomic_store(&g_trace_active, 0);
+  if (g_trace_file != NULL) {
+    // Close the sequence so no record can be claimed after the ones counted here
+    uintptr_t head = rtl_atomic_load(&g_trace_head);
+    while (!rtl_atomic_cas(&g_trace_head, &head, head | RTL_TRACE_CLOSED)) {
+    }
+
+    // Full buffers are written by the threads completing them, the partial one is ours
+    const uintptr_t lap = head / RTL_TRACE_BUFFER_RECORDS;
+    const uintptr_t partial = head % RTL_TRACE_BUFFER_RECORDS;
+    if (partial != 0) {
+      while (rtl_atomic_load(&g_trace_committed[lap % RTL_TRACE_BUFFERS]) != partial) {
+        _rtl_trace_yield();
+      }
+      _rtl_trace_write(lap, partial);
+    }
+    while (rtl_atomic_load(&g_trace_written) != lap + (partial != 0)) {
+      _rtl_trace_yield();
+    }
+
+    fclose(g_trace_file);
+    g_trace_file = NULL;
+  }
+  rtl_atomic_unlock(&g_trace_lock);
+}
+
+bool rtl_trace_flush(void)
+{
+  rtl_atomic_lock(&g_trace_lock);
+  const bool result = g_trace_file != NULL && !rtl_atomic_load(&g_trace_failed) &&
+    fflush(g_trace_file) == 0;
+  rtl_atomic_unlock(&g_trace_lock);
+  return result;
+}
+
+bool rtl_trace_active(void)
+{
+  return rtl_atomic_load_relaxed(&g_trace_active) != 0;
+}
+
+void _rtl_trace_record(unsigned op, unsigned tag, size_t size, const void* ptr)
+{
+  if (!rtl_atomic_load_relaxed(&g_trace_active)) {
+    return;
+  }
+
+  if (g_trace_thread == 0) {
+    g_trace_thread = (uint32_t)(rtl_atomic_fetch_add(&g_trace_next_thread, 1) + 1);
+  }
+
+  // Claim a slot, unless the trace stopped meanwhile
+  uintptr_t head = rtl_atomic_load_relaxed(&g_trace_head);
+  do {
+    if (head & RTL_TRACE_CLOSED) {
+      return;
+    }
+  } while (!rtl_atomic_cas(&g_trace_head, &head, head + 1));
+
+  // Only waits when every buffer is full and the file can't keep up
+  const uintptr_t lap = head / RTL_TRACE_BUFFER_RECORDS;
+  while (lap >= rtl_atomic_load(&g_trace_written) + RTL_TRACE_BUFFERS) {
+    _rtl_trace_yield();
+  }
+
+  rtl_trace_record_t* record =
+    &g_trace_ring[lap % RTL_TRACE_BUFFERS][head % RTL_TRACE_BUFFER_RECORDS];
+  record->timestamp = _rtl_trace_now() - g_trace_start_time;
+  record->ptr_id = (uint64_t)(uintptr_t)ptr;
+  record->size = size;
+  record->thread = g_trace_thread;
+  record->op = (uint16_t)op;
+  record->tag = (uint16_t)tag;
+
+  // The thread filling the last slot of a buffer writes it out
+  if (rtl_atomic_fetch_add(&g_trace_committed[lap % RTL_TRACE_BUFFERS], 1) + 1 ==
+    RTL_TRACE_BUFFER_RECORDS) {
+    _rtl_trace_write(lap, RTL_TRACE_BUFFER_RECORDS);
+  }
+}
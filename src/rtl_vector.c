@@ -0,0 +1,272 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_vector.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_memory.h"
+
+/**
+ * @internal
+ * @brief Moves the elements into new storage of the given capacity, 0 frees the storage.
+ */
+static bool _rtl_vector_reallocate(rtl_vector_t* vector, size_t capacity)
+{
+  if (capacity == 0) {
+    rtl_free(vector->allocation);
+    vector->allocation = NULL;
+    vector->data = NULL;
+    vector->capacity = 0;
+    return true;
+  }
+
+  if (capacity > (SIZE_MAX - RTL_VECTOR_ALIGNMENT) / vector->element_size) {
+    return false;
+  }
+
+  // Over-allocate so the first element can start on an aligned address
+  void* allocation = rtl_malloc_tagged(
+    RTL_MEM_TAG_VECTOR, capacity * vector->element_size + RTL_VECTOR_ALIGNMENT - 1);
+  if (!allocation) {
+    return false;
+  }
+  char* data = (char*)(((uintptr_t)allocation + RTL_VECTOR_ALIGNMENT - 1) &
+    ~(uintptr_t)(RTL_VECTOR_ALIGNMENT - 1));
+
+  if (vector->count) {
+    memcpy(data, vector->data, vector->count * vector->element_size);
+  }
+  rtl_free(vector->allocation);
+
+  vector->allocation = allocation;
+  vector->data = data;
+  vector->capacity = capacity;
+  return true;
+}
+
+/**
+ * @internal
+ * @brief Makes room for extra elements, at least doubling the capacity when it grows.
+ */
+static bool _rtl_vector_grow(rtl_vector_t* vector, size_t extra)
+{
+  if (extra > SIZE_MAX - vector->count) {
+    return false;
+  }
+
+  const size_t needed = vector->count + extra;
+  if (needed <= vector->capacity) {
+    return true;
+  }
+
+  size_t capacity = vector->capacity ? vector->capacity : RTL_VECTOR_INITIAL_CAPACITY;
+  while (capacity < needed) {
+    capacity = capacity > SIZE_MAX / 2 ? needed : capacity * 2;
+  }
+  return _rtl_vector_reallocate(vector, capacity);
+}
+
+/**
+ * @internal
+ * @brief Checks whether a source range lies inside the vector's elements.
+ * @return true with the byte offset of the range if it does, false otherwise.
+ */
+static bool _rtl_vector_aliases(const rtl_vector_t* vector, const void* source, size_t* offset)
+{
+  const uintptr_t begin = (uintptr_t)vector->data;
+  const uintptr_t address = (uintptr_t)source;
+  if (vector->data == NULL || address < begin ||
+    address >= begin + vector->count * vector->element_size) {
+    return false;
+  }
+
+  *offset = (size_t)(address - begin);
+  return true;
+}
+
+void rtl_vector_init(rtl_vector_t* vector, size_t element_size)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+  rtl_assert(element_size > 0, "Element size must be greater than 0");
+
+  vector->allocation = NULL;
+  vector->data = NULL;
+  vector->count = 0;
+  vector->capacity = 0;
+  vector->element_size = element_size;
+}
+
+void rtl_vector_cleanup(rtl_vector_t* vector)
+{
+  if (!vector) {
+    return;
+  }
+
+  rtl_free(vector->allocation);
+  vector->allocation = NULL;
+  vector->data = NULL;
+  vector->count = 0;
+  vector->capacity = 0;
+}
+
+bool rtl_vector_reserve(rtl_vector_t* vector, size_t capacity)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+
+  if (capacity <= vector->capacity) {
+    return true;
+  }
+  return _rtl_vector_reallocate(vector, capacity);
+}
+
+bool rtl_vector_shrink(rtl_vector_t* vector)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+
+  if (vector->count == vector->capacity) {
+    return true;
+  }
+  return _rtl_vector_reallocate(vector, vector->count);
+}
+
+bool rtl_vector_push_back(rtl_vector_t* vector, const void* element)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+  rtl_assert(element != NULL, "Element cannot be NULL");
+
+  // The element may be one of ours, find it again after a reallocation
+  size_t offset;
+  const bool aliased = _rtl_vector_aliases(vector, element, &offset);
+  if (vector->count == vector->capacity && !_rtl_vector_grow(vector, 1)) {
+    return false;
+  }
+  if (aliased) {
+    element = vector->data + offset;
+  }
+
+  memcpy(rtl_vector_at(vector, vector->count), element, vector->element_size);
+  vector->count++;
+  return true;
+}
+
+bool rtl_vector_pop_back(rtl_vector_t* vector, void* element)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+
+  if (vector->count == 0) {
+    return false;
+  }
+
+  vector->count--;
+  if (element) {
+    memcpy(element, rtl_vector_at(vector, vector->count), vector->element_size);
+  }
+  return true;
+}
+
+bool rtl_vector_insert(rtl_vector_t* vector, size_t index, const void* elements, size_t count)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+  rtl_assert(index <= vector->count, "Index %lu is past the end of the vector",
+    (unsigned long)index);
+  rtl_assert(elements != NULL || count == 0, "Elements cannot be NULL");
+
+  if (count == 0) {
+    return true;
+  }
+
+  // Copying a range of the vector onto itself is allowed, so remember where it
+  // starts relative to the storage before growing moves it
+  size_t offset = 0;
+  const bool aliased = _rtl_vector_aliases(vector, elements, &offset);
+  if (!_rtl_vector_grow(vector, count)) {
+    return false;
+  }
+
+  const size_t bytes = count * vector->element_size;
+  const size_t split = index * vector->element_size;
+  memmove(vector->data + split + bytes, vector->data + split,
+    vector->count * vector->element_size - split);
+
+  if (!aliased) {
+    memcpy(vector->data + split, elements, bytes);
+  } else {
+    // Source bytes below the insertion point stayed put, the rest moved up by bytes
+    size_t low = 0;
+    if (offset < split) {
+      low = split - offset < bytes ? split - offset : bytes;
+      memcpy(vector->data + split, vector->data + offset, low);
+    }
+    memcpy(vector->data + split + low, vector->data + offset + low + bytes, bytes - low);
+  }
+
+  vector->count += count;
+  return true;
+}
+
+void rtl_vector_erase(rtl_vector_t* vector, size_t index, size_t count)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+  rtl_assert(index <= vector->count && count <= vector->count - index,
+    "Range %lu+%lu is outside the vector", (unsigned long)index, (unsigned long)count);
+
+  if (count == 0) {
+    return;
+  }
+
+  memmove(rtl_vector_at(vector, index), rtl_vector_at(vector, index + count),
+    (vector->count - index - count) * vector->element_size);
+  vector->count -= count;
+}
+
+bool rtl_vector_append(rtl_vector_t* vector, const void* elements, size_t count)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+
+  return rtl_vector_insert(vector, vector->count, elements, count);
+}
+
+bool rtl_vector_append_iter(
+  rtl_vector_t* vector, rtl_vector_iterator_t iterator, void* user_data, size_t size_hint)
+{
+  rtl_assert(vector != NULL, "Vector cannot be NULL");
+  rtl_assert(iterator != NULL, "Iterator cannot be NULL");
+
+  if (size_hint && !_rtl_vector_grow(vector, size_hint)) {
+    return false;
+  }
+
+  for (;;) {
+    if (vector->count == vector->capacity && !_rtl_vector_grow(vector, 1)) {
+      return false;
+    }
+    if (!iterator(rtl_vector_at(vector, vector->count), user_data)) {
+      return true;
+    }
+    vector->count++;
+  }
+}
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rtl_vmbuf.h"
+
+#include "rtl.h"
+#include "rtl_log.h"
+#include "rtl_page.h"
+
+/**
+ * @internal
+ * @brief Rounds size up to a multiple of the system page size.
+ */
+static size_t _rtl_vmbuf_page_round_up(size_t size)
+{
+  const size_t page_size = rtl_page_size();
+  return (size + page_size - 1) & ~(page_size - 1);
+}
+
+bool rtl_vmbuf_init(rtl_vmbuf_t* buf, size_t max_size)
+{
+  rtl_assert(buf != NULL, "Buffer cannot be NULL");
+  rtl_assert(max_size > 0, "Maximum size must be greater than 0");
+
+  const size_t reserved = _rtl_vmbuf_page_round_up(max_size);
+  buf->data = rtl_page_reserve(reserved);
+  if (!buf->data) {
+    return false;
+  }
+
+  buf->size = 0;
+  buf->committed = 0;
+  buf->reserved = reserved;
+  return true;
+}
+
+void rtl_vmbuf_cleanup(rtl_vmbuf_t* buf)
+{
+  if (!buf) {
+    return;
+  }
+
+  rtl_page_release(buf->data, buf->reserved);
+  buf->data = NULL;
+  buf->size = 0;
+  buf->committed = 0;
+  buf->reserved = 0;
+}
+
+bool rtl_vmbuf_reserve(rtl_vmbuf_t* buf, size_t capacity)
+{
+  rtl_assert(buf != NULL, "Buffer cannot be NULL");
+
+  if (capacity <= buf->committed) {
+    return true;
+  }
+
+  if (capacity > buf->reserved) {
+    return false;
+  }
+
+  // Commit geometrically so a stream of small pushes costs few system calls
+  size_t target = buf->committed * 2;
+  if (target < RTL_VMBUF_COMMIT_GRANULARITY) {
+    target = RTL_VMBUF_COMMIT_GRANULARITY;
+  }
+  if (target < capacity) {
+    target = capacity;
+  }
+  target = _rtl_vmbuf_page_round_up(target);
+  if (target > buf->reserved) {
+    target = buf->reserved;
+  }
+
+  if (!rtl_page_commit(buf->data + buf->committed, target - buf->committed)) {
+    return false;
+  }
+
+  buf->committed = target;
+  return true;
+}
+
+bool rtl_vmbuf_resize(rtl_vmbuf_t* buf, size_t size)
+{
+  if (!rtl_vmbuf_reserve(buf, size)) {
+    return false;
+  }
+
+  buf->size = size;
+  return true;
+}
+
+void* rtl_vmbuf_push(rtl_vmbuf_t* buf, size_t size)
+{
+  rtl_assert(buf != NULL, "Buffer cannot be NULL");
+
+  const size_t offset = buf->size;
+  if (size > buf->reserved - offset || !rtl_vmbuf_resize(buf, offset + size)) {
+    return NULL;
+  }
+
+  return buf->data + offset;
+}
+
+void rtl_vmbuf_shrink(rtl_vmbuf_t* buf)
+{
+  rtl_assert(buf != NULL, "Buffer cannot be NULL");
+
+  const size_t keep = _rtl_vmbuf_page_round_up(buf->size);
+  if (keep < buf->committed) {
+    rtl_page_decommit(buf->data + keep, buf->committed - keep);
+    buf->committed = keep;
+  }
+}
@@ -20,14 +20,41 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "rtl.h"
+#include "rtl_buddy.h"
+#include "rtl_deque.h"
+#include "rtl_ebr.h"
 #include "rtl_hash.h"
+#include "rtl_hazard.h"
+#include "rtl_heap.h"
+#include "rtl_ilist.h"
+#include "rtl_lfstack.h"
 #include "rtl_list.h"
 #include "rtl_log.h"
 #include "rtl_memory.h"
+#include "rtl_mpmc.h"
+#include "rtl_mpsc.h"
+#include "rtl_page.h"
+#include "rtl_rbtree.h"
+#include "rtl_reclaim.h"
+#include "rtl_skiplist.h"
+#include "rtl_spsc.h"
+#include "rtl_trace.h"
+#include "rtl_vector.h"
+#include "rtl_vmbuf.h"
 
 #include "unity.h"
 
@@ -1225,65 +1252,3166 @@ void test_hash_key_compare_functions(void)
   TEST_ASSERT_NOT_EQUAL(0, result);
 }
 
-int main(void)
+// Page tests
+
+// Test mapping and unmapping regular pages
+void test_page_alloc_free(void)
 {
-  UNITY_BEGIN();
+  const size_t size = rtl_page_size() * 3 + 1;
+  unsigned char* data = rtl_page_alloc(size, RTL_PAGE_DEFAULT);
+  TEST_ASSERT_NOT_NULL(data);
 
-  // Assert tests
-  RUN_TEST(test_rtl_assert_success);
+  // Fresh mappings are zero-filled
+  TEST_ASSERT_EQUAL(0, data[0]);
+  TEST_ASSERT_EQUAL(0, data[size - 1]);
 
-  // Memory tests
-  RUN_TEST(test_memory_allocation);
-  RUN_TEST(test_zero_allocation);
-  RUN_TEST(test_multiple_allocations);
-  RUN_TEST(test_different_sizes);
-  RUN_TEST(test_reallocation_after_free);
-  RUN_TEST(test_memory_stress);
-  RUN_TEST(test_custom_allocators);
+  memset(data, 0xAB, size);
+  TEST_ASSERT_EQUAL(0xAB, data[size - 1]);
 
-  // List tests
-  RUN_TEST(test_list_init);
-  RUN_TEST(test_list_first_empty);
-  RUN_TEST(test_list_first_single_element);
-  RUN_TEST(test_list_first_multiple_elements);
-  RUN_TEST(test_list_next_null_current);
-  RUN_TEST(test_list_next_single_element);
-  RUN_TEST(test_list_next_multiple_elements);
-  RUN_TEST(test_list_iteration_with_first_and_next);
-  RUN_TEST(test_list_add_head);
-  RUN_TEST(test_list_add_tail);
-  RUN_TEST(test_list_remove_with_iteration);
-  RUN_TEST(test_list_length_empty);
-  RUN_TEST(test_list_length_single_element);
-  RUN_TEST(test_list_length_multiple_elements_head);
-  RUN_TEST(test_list_length_multiple_elements_tail);
-  RUN_TEST(test_list_length_after_remove);
-  RUN_TEST(test_list_length_stress);
-  RUN_TEST(test_list_for_each_indexed_empty);
-  RUN_TEST(test_list_for_each_indexed_single_element);
-  RUN_TEST(test_list_for_each_indexed_multiple_elements);
-  RUN_TEST(test_list_for_each_indexed_head_insertion_order);
-  RUN_TEST(test_list_for_each_indexed_stress);
-  RUN_TEST(test_list_for_each_callback_empty);
-  RUN_TEST(test_list_for_each_callback_null_callback);
-  RUN_TEST(test_list_for_each_callback_single_element);
-  RUN_TEST(test_list_for_each_callback_multiple_elements);
-  RUN_TEST(test_list_for_each_callback_early_stop);
-  RUN_TEST(test_list_for_each_callback_user_data);
+  rtl_page_free(data, size, RTL_PAGE_DEFAULT);
+}
 
-  // Hash table tests
-  RUN_TEST(test_hash_table_init_cleanup);
-  RUN_TEST(test_hash_table_insert);
-  RUN_TEST(test_hash_table_find);
-  RUN_TEST(test_hash_table_update);
-  RUN_TEST(test_hash_table_remove);
-  RUN_TEST(test_hash_table_multiple_entries);
-  RUN_TEST(test_hash_table_string_keys);
-  RUN_TEST(test_hash_table_collisions);
-  RUN_TEST(test_hash_table_load_factor);
-  RUN_TEST(test_hash_table_different_value_sizes);
-  RUN_TEST(test_hash_fnv1a_function);
-  RUN_TEST(test_hash_key_compare_functions);
+// Test huge page mappings fall back to something usable
+void test_page_alloc_huge(void)
+{
+  // Whatever the system reports, it is a power-of-two multiple of the base page
+  const size_t huge_size = rtl_page_huge_size();
+  TEST_ASSERT_EQUAL(0, huge_size & (huge_size - 1));
+  TEST_ASSERT_EQUAL(0, huge_size % rtl_page_size());
+
+  const size_t size = huge_size * 2;
+  unsigned char* data = rtl_page_alloc(size, RTL_PAGE_HUGE);
+  TEST_ASSERT_NOT_NULL(data);
+  memset(data, 0x5A, size);
+  TEST_ASSERT_EQUAL(0x5A, data[size / 2]);
+  rtl_page_free(data, size, RTL_PAGE_HUGE);
+
+  data = rtl_page_alloc(size, RTL_PAGE_HUGETLB);
+  TEST_ASSERT_NOT_NULL(data);
+  memset(data, 0x5A, size);
+  TEST_ASSERT_EQUAL(0x5A, data[size - 1]);
+  rtl_page_free(data, size, RTL_PAGE_HUGETLB);
+}
+
+// Test huge malloc with blocks below and above the threshold
+void test_huge_malloc_sizes(void)
+{
+  char* small = rtl_huge_malloc(64);
+  TEST_ASSERT_NOT_NULL(small);
+  memset(small, 1, 64);
+
+  char* large = rtl_huge_malloc(RTL_HUGE_MALLOC_THRESHOLD * 3);
+  TEST_ASSERT_NOT_NULL(large);
+  TEST_ASSERT_EQUAL(0, (size_t)large % 16);
+  memset(large, 2, RTL_HUGE_MALLOC_THRESHOLD * 3);
+  TEST_ASSERT_EQUAL(2, large[RTL_HUGE_MALLOC_THRESHOLD * 3 - 1]);
+
+  // Whole huge pages are mapped as is, nothing sits in front of the block
+  const size_t huge_size = rtl_page_huge_size() > RTL_HUGE_MALLOC_THRESHOLD
+    ? rtl_page_huge_size()
+    : RTL_HUGE_MALLOC_THRESHOLD;
+  char* exact = rtl_huge_malloc(huge_size);
+  TEST_ASSERT_NOT_NULL(exact);
+  TEST_ASSERT_EQUAL(0, (size_t)exact % rtl_page_size());
+  memset(exact, 3, huge_size);
+
+  rtl_huge_free(small);
+  rtl_huge_free(large);
+  rtl_huge_free(exact);
+  rtl_huge_free(NULL);
+}
+
+// Test hash table bucket arrays placed on huge pages through the allocator hooks
+void test_huge_malloc_hash_table(void)
+{
+  rtl_cleanup();
+  rtl_init(rtl_huge_malloc, rtl_huge_free);
+
+  // 128K buckets is well above the huge malloc threshold
+  rtl_hash_table_t table;
+  bool result = rtl_hash_table_init(&table, 128 * 1024, rtl_hash_fnv1a, rtl_hash_key_compare_bytes);
+  TEST_ASSERT_TRUE(result);
+
+  for (int i = 0; i < 1000; i++) {
+    int value = i * 2;
+    result = rtl_hash_table_insert(&table, &i, sizeof(i), &value, sizeof(value));
+    TEST_ASSERT_TRUE(result);
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    const int* found_value = rtl_hash_table_find(&table, &i, sizeof(i), NULL);
+    TEST_ASSERT_NOT_NULL(found_value);
+    TEST_ASSERT_EQUAL(i * 2, *found_value);
+  }
+
+  rtl_hash_table_cleanup(&table);
+  rtl_cleanup();
+
+  // Re-initialize with default allocators for other tests
+  rtl_init(NULL, NULL);
+}
+
+// Virtual memory buffer tests
+
+// Test growing a buffer keeps data in place
+void test_vmbuf_push_stable(void)
+{
+  rtl_vmbuf_t buf;
+  TEST_ASSERT_TRUE(rtl_vmbuf_init(&buf, 256UL * 1024UL * 1024UL));
+  TEST_ASSERT_EQUAL(0, buf.size);
+  TEST_ASSERT_EQUAL(0, buf.committed);
+
+  char* const data = buf.data;
+  for (int i = 0; i < 100000; i++) {
+    int* slot = rtl_vmbuf_push(&buf, sizeof(int));
+    TEST_ASSERT_NOT_NULL(slot);
+    *slot = i;
+  }
+
+  // Growth never moves the data
+  TEST_ASSERT_EQUAL_PTR(data, buf.data);
+  TEST_ASSERT_EQUAL(100000 * sizeof(int), buf.size);
+  TEST_ASSERT_TRUE(buf.committed >= buf.size);
+
+  const int* values = (const int*)buf.data;
+  for (int i = 0; i < 100000; i++) {
+    TEST_ASSERT_EQUAL(i, values[i]);
+  }
+
+  rtl_vmbuf_cleanup(&buf);
+  TEST_ASSERT_NULL(buf.data);
+}
+
+// Test the reservation bounds growth
+void test_vmbuf_reservation_limit(void)
+{
+  rtl_vmbuf_t buf;
+  TEST_ASSERT_TRUE(rtl_vmbuf_init(&buf, 1));
+  TEST_ASSERT_EQUAL(rtl_page_size(), buf.reserved);
+
+  TEST_ASSERT_NOT_NULL(rtl_vmbuf_push(&buf, rtl_page_size()));
+  TEST_ASSERT_NULL(rtl_vmbuf_push(&buf, 1));
+  TEST_ASSERT_FALSE(rtl_vmbuf_reserve(&buf, rtl_page_size() + 1));
+  TEST_ASSERT_EQUAL(rtl_page_size(), buf.size);
+
+  rtl_vmbuf_cleanup(&buf);
+}
+
+// Test shrinking decommits unused pages and regrowing reads zeros
+void test_vmbuf_shrink(void)
+{
+  rtl_vmbuf_t buf;
+  TEST_ASSERT_TRUE(rtl_vmbuf_init(&buf, 16UL * 1024UL * 1024UL));
+
+  const size_t large = 4UL * 1024UL * 1024UL;
+  TEST_ASSERT_TRUE(rtl_vmbuf_resize(&buf, large));
+  memset(buf.data, 0xCD, large);
+
+  TEST_ASSERT_TRUE(rtl_vmbuf_resize(&buf, 10));
+  rtl_vmbuf_shrink(&buf);
+  TEST_ASSERT_EQUAL(rtl_page_size(), buf.committed);
+  TEST_ASSERT_EQUAL(0xCD, (unsigned char)buf.data[9]);
+
+  TEST_ASSERT_TRUE(rtl_vmbuf_resize(&buf, large));
+  TEST_ASSERT_EQUAL(0, buf.data[large - 1]);
+
+  rtl_vmbuf_cleanup(&buf);
+}
+
+// Epoch-based reclamation tests
+
+// Test retired pointers are freed once the epoch moves on
+void test_ebr_retire_and_flush(void)
+{
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t thread;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &thread);
+
+  rtl_ebr_enter(&thread);
+  TEST_ASSERT_TRUE(rtl_ebr_retire(&thread, rtl_malloc(32)));
+  TEST_ASSERT_TRUE(rtl_ebr_retire(&thread, rtl_malloc(32)));
+  rtl_ebr_leave(&thread);
+
+  // With no active readers a couple of flushes advance the epoch far enough
+  unsigned long pending = 0;
+  for (int i = 0; i < 3; i++) {
+    pending = rtl_ebr_flush(&thread);
+  }
+  TEST_ASSERT_EQUAL(0, pending);
+
+  rtl_ebr_thread_unregister(&thread);
+  rtl_ebr_cleanup(&ebr);
+}
+
+// Test an active reader holds back reclamation until it leaves
+void test_ebr_active_reader_blocks(void)
+{
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t writer;
+  rtl_ebr_thread_t reader;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &writer);
+  rtl_ebr_thread_register(&ebr, &reader);
+
+  rtl_ebr_enter(&reader);
+
+  rtl_ebr_enter(&writer);
+  TEST_ASSERT_TRUE(rtl_ebr_retire(&writer, rtl_malloc(16)));
+  rtl_ebr_leave(&writer);
+
+  for (int i = 0; i < 5; i++) {
+    TEST_ASSERT_EQUAL(1, rtl_ebr_flush(&writer));
+  }
+
+  rtl_ebr_leave(&reader);
+
+  unsigned long pending = 1;
+  for (int i = 0; i < 3; i++) {
+    pending = rtl_ebr_flush(&writer);
+  }
+  TEST_ASSERT_EQUAL(0, pending);
+
+  rtl_ebr_thread_unregister(&reader);
+  rtl_ebr_thread_unregister(&writer);
+  rtl_ebr_cleanup(&ebr);
+}
+
+// Test full batches trigger reclamation without explicit flushes
+void test_ebr_batches(void)
+{
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t thread;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &thread);
+
+  for (int i = 0; i < RTL_EBR_BATCH_SIZE * 10; i++) {
+    rtl_ebr_enter(&thread);
+    TEST_ASSERT_TRUE(rtl_ebr_retire(&thread, rtl_malloc(8)));
+    rtl_ebr_leave(&thread);
+  }
+
+  // Only the most recent batches can still be waiting
+  unsigned long pending = 0;
+  for (const rtl_ebr_batch_t* batch = thread.pending; batch; batch = batch->next) {
+    pending += batch->count;
+  }
+  TEST_ASSERT_TRUE(pending <= RTL_EBR_BATCH_SIZE * 2);
+
+  rtl_ebr_thread_unregister(&thread);
+  rtl_ebr_cleanup(&ebr);
+}
+
+// Test nested critical sections and orphaned batches freed at cleanup
+void test_ebr_nesting_and_orphans(void)
+{
+  rtl_memory_tag_stats_t user;
+  rtl_memory_tag_stats_t reclaim;
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &user);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_RECLAIM, &reclaim);
+  const size_t user_allocations = user.allocations;
+  const size_t reclaim_allocations = reclaim.allocations;
+
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t reader;
+  rtl_ebr_thread_t writer;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &reader);
+  rtl_ebr_thread_register(&ebr, &writer);
+
+  rtl_ebr_enter(&reader);
+  rtl_ebr_enter(&reader);
+  rtl_ebr_leave(&reader);
+  TEST_ASSERT_EQUAL(1, reader.state & 1);
+
+  TEST_ASSERT_TRUE(rtl_ebr_retire(&writer, rtl_malloc(64)));
+  rtl_ebr_thread_unregister(&writer);
+  TEST_ASSERT_NOT_NULL(ebr.orphans);
+
+  rtl_ebr_leave(&reader);
+  TEST_ASSERT_EQUAL(0, reader.state & 1);
+
+  // The orphaned pointer and every batch are freed by cleanup at the latest
+  rtl_ebr_thread_unregister(&reader);
+  rtl_ebr_cleanup(&ebr);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &user);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_RECLAIM, &reclaim);
+  TEST_ASSERT_EQUAL(user_allocations, user.allocations);
+  TEST_ASSERT_EQUAL(reclaim_allocations, reclaim.allocations);
+}
+
+#if defined(__linux__)
+// Reader thread state: 1 once inside its critical section, 2 when told to leave
+typedef struct test_ebr_reader
+{
+  rtl_ebr_t* ebr;
+  rtl_atomic_word_t step;
+} test_ebr_reader_t;
+
+static void* ebr_reader_thread(void* arg)
+{
+  test_ebr_reader_t* reader = arg;
+  rtl_ebr_thread_t thread;
+  rtl_ebr_thread_register(reader->ebr, &thread);
+
+  rtl_ebr_enter(&thread);
+  rtl_atomic_store(&reader->step, 1);
+  while (rtl_atomic_load(&reader->step) != 2) {
+    sched_yield();
+  }
+  rtl_ebr_leave(&thread);
+
+  rtl_ebr_thread_unregister(&thread);
+  return NULL;
+}
+
+// Test a thread pinned in an epoch stalls reclamation by another thread until it leaves
+void test_ebr_threads(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &stats);
+  const size_t allocations = stats.allocations;
+
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t writer;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &writer);
+
+  test_ebr_reader_t reader = { &ebr, 0 };
+  pthread_t thread;
+  TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, ebr_reader_thread, &reader));
+  while (rtl_atomic_load(&reader.step) != 1) {
+    sched_yield();
+  }
+
+  // The epoch moves at most once past the reader, so nothing retired now is freed
+  const uintptr_t epoch = rtl_atomic_load(&ebr.epoch);
+  TEST_ASSERT_TRUE(rtl_ebr_retire(&writer, rtl_malloc(16)));
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_EQUAL(1, rtl_ebr_flush(&writer));
+  }
+  TEST_ASSERT_TRUE(rtl_atomic_load(&ebr.epoch) - epoch <= 1);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &stats);
+  TEST_ASSERT_EQUAL(allocations + 1, stats.allocations);
+
+  rtl_atomic_store(&reader.step, 2);
+  TEST_ASSERT_EQUAL(0, pthread_join(thread, NULL));
+
+  unsigned long pending = 1;
+  for (int i = 0; i < 3 && pending != 0; i++) {
+    pending = rtl_ebr_flush(&writer);
+  }
+  TEST_ASSERT_EQUAL(0, pending);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &stats);
+  TEST_ASSERT_EQUAL(allocations, stats.allocations);
+
+  rtl_ebr_thread_unregister(&writer);
+  rtl_ebr_cleanup(&ebr);
+}
+#endif
+
+// Hazard pointer tests
+
+// Test unprotected retired pointers are freed by a scan
+void test_hazard_retire_and_scan(void)
+{
+  rtl_hazard_t domain;
+  rtl_hazard_thread_t thread;
+  rtl_hazard_init(&domain);
+  rtl_hazard_thread_register(&domain, &thread);
+
+  TEST_ASSERT_TRUE(rtl_hazard_retire(&thread, rtl_malloc(32)));
+  TEST_ASSERT_TRUE(rtl_hazard_retire(&thread, rtl_malloc(32)));
+  TEST_ASSERT_EQUAL(2, thread.retired_count);
+  TEST_ASSERT_EQUAL(0, rtl_hazard_scan(&thread));
+
+  rtl_hazard_thread_unregister(&thread);
+  rtl_hazard_cleanup(&domain);
+}
+
+// Test a protected pointer survives scans until its slot is cleared
+void test_hazard_protect_blocks(void)
+{
+  rtl_hazard_t domain;
+  rtl_hazard_thread_t reader;
+  rtl_hazard_thread_t writer;
+  rtl_hazard_init(&domain);
+  rtl_hazard_thread_register(&domain, &reader);
+  rtl_hazard_thread_register(&domain, &writer);
+
+  int* value = rtl_malloc(sizeof(int));
+  *value = 7;
+  rtl_atomic_ptr_t shared = value;
+
+  int* protected_value = rtl_hazard_protect(&reader, 1, &shared);
+  TEST_ASSERT_EQUAL_PTR(value, protected_value);
+
+  // Unlink and retire while the reader still holds it
+  rtl_atomic_store_ptr(&shared, NULL);
+  TEST_ASSERT_TRUE(rtl_hazard_retire(&writer, value));
+  TEST_ASSERT_EQUAL(1, rtl_hazard_scan(&writer));
+  TEST_ASSERT_EQUAL(7, *protected_value);
+
+  rtl_hazard_clear(&reader, 1);
+  TEST_ASSERT_EQUAL(0, rtl_hazard_scan(&writer));
+
+  rtl_hazard_thread_unregister(&reader);
+  rtl_hazard_thread_unregister(&writer);
+  rtl_hazard_cleanup(&domain);
+}
+
+// Test retiring past the threshold scans automatically
+void test_hazard_scan_threshold(void)
+{
+  rtl_hazard_t domain;
+  rtl_hazard_thread_t thread;
+  rtl_hazard_init(&domain);
+  rtl_hazard_thread_register(&domain, &thread);
+
+  for (int i = 0; i < RTL_HAZARD_SCAN_THRESHOLD * 4; i++) {
+    TEST_ASSERT_TRUE(rtl_hazard_retire(&thread, rtl_malloc(8)));
+    TEST_ASSERT_TRUE(thread.retired_count < RTL_HAZARD_SCAN_THRESHOLD);
+  }
+
+  rtl_hazard_thread_unregister(&thread);
+  rtl_hazard_cleanup(&domain);
+}
+
+// Test pointers still protected at unregister are adopted by the domain
+void test_hazard_orphans(void)
+{
+  rtl_hazard_t domain;
+  rtl_hazard_thread_t reader;
+  rtl_hazard_thread_t writer;
+  rtl_hazard_init(&domain);
+  rtl_hazard_thread_register(&domain, &reader);
+  rtl_hazard_thread_register(&domain, &writer);
+
+  rtl_atomic_ptr_t shared = rtl_malloc(16);
+  void* node = rtl_hazard_protect(&reader, 0, &shared);
+  TEST_ASSERT_TRUE(rtl_hazard_retire(&writer, node));
+  rtl_hazard_thread_unregister(&writer);
+  TEST_ASSERT_EQUAL(1, domain.orphan_count);
+
+  // The reader's next scan adopts and frees it once unprotected
+  rtl_hazard_clear_all(&reader);
+  TEST_ASSERT_EQUAL(0, rtl_hazard_scan(&reader));
+  TEST_ASSERT_EQUAL(0, domain.orphan_count);
+
+  rtl_hazard_thread_unregister(&reader);
+  rtl_hazard_cleanup(&domain);
+}
+
+// Shared helper that works with any reclamation scheme
+static int test_reclaim_swap(const rtl_reclaim_t* reclaim, rtl_atomic_ptr_t* shared, int next)
+{
+  rtl_reclaim_begin(reclaim);
+  const int* current = rtl_reclaim_protect(reclaim, 0, shared);
+  const int previous = *current;
+
+  int* replacement = rtl_malloc(sizeof(int));
+  *replacement = next;
+  void* old = rtl_atomic_exchange_ptr(shared, replacement);
+  rtl_reclaim_end(reclaim);
+
+  TEST_ASSERT_TRUE(rtl_reclaim_retire(reclaim, old));
+  return previous;
+}
+
+// Test the common interface drives both schemes
+void test_reclaim_interface(void)
+{
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t ebr_thread;
+  rtl_hazard_t hazard;
+  rtl_hazard_thread_t hazard_thread;
+  rtl_reclaim_t reclaims[2];
+
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &ebr_thread);
+  rtl_hazard_init(&hazard);
+  rtl_hazard_thread_register(&hazard, &hazard_thread);
+  rtl_reclaim_init_ebr(&reclaims[0], &ebr_thread);
+  rtl_reclaim_init_hazard(&reclaims[1], &hazard_thread);
+
+  for (int r = 0; r < 2; r++) {
+    int* initial = rtl_malloc(sizeof(int));
+    *initial = 0;
+    rtl_atomic_ptr_t shared = initial;
+
+    for (int i = 1; i <= 100; i++) {
+      TEST_ASSERT_EQUAL(i - 1, test_reclaim_swap(&reclaims[r], &shared, i));
+    }
+
+    rtl_free(shared);
+  }
+
+  rtl_ebr_thread_unregister(&ebr_thread);
+  rtl_ebr_cleanup(&ebr);
+  rtl_hazard_thread_unregister(&hazard_thread);
+  rtl_hazard_cleanup(&hazard);
+}
+
+// Scratch allocator tests
+
+// Test scratch allocations are aligned and rewound by pop
+void test_scratch_push_pop(void)
+{
+  const rtl_scratch_marker_t marker = rtl_scratch_push();
+
+  char* first = rtl_scratch_alloc(3);
+  char* second = rtl_scratch_alloc(5);
+  TEST_ASSERT_NOT_NULL(first);
+  TEST_ASSERT_NOT_NULL(second);
+  TEST_ASSERT_EQUAL(0, (size_t)first % RTL_SCRATCH_ALIGNMENT);
+  TEST_ASSERT_EQUAL(0, (size_t)second % RTL_SCRATCH_ALIGNMENT);
+  TEST_ASSERT_EQUAL_PTR(first + RTL_SCRATCH_ALIGNMENT, second);
+
+  rtl_scratch_pop(marker);
+
+  // Popping hands the same memory out again
+  TEST_ASSERT_EQUAL_PTR(first, rtl_scratch_alloc(8));
+  rtl_scratch_pop(marker);
+}
+
+// Test nested markers release memory in LIFO order
+void test_scratch_nested_markers(void)
+{
+  const rtl_scratch_marker_t outer = rtl_scratch_push();
+  int* values = rtl_scratch_alloc(4 * sizeof(int));
+  for (int i = 0; i < 4; i++) {
+    values[i] = i;
+  }
+
+  const rtl_scratch_marker_t inner = rtl_scratch_push();
+  char* temp = rtl_scratch_alloc(100);
+  memset(temp, 0xFF, 100);
+  rtl_scratch_pop(inner);
+
+  // The outer allocation is untouched by the inner scope
+  for (int i = 0; i < 4; i++) {
+    TEST_ASSERT_EQUAL(i, values[i]);
+  }
+
+  rtl_scratch_pop(outer);
+}
+
+// Test overflowing a chunk and oversized requests grow the stack
+void test_scratch_overflow(void)
+{
+  const rtl_scratch_marker_t marker = rtl_scratch_push();
+
+  char* blocks[8];
+  for (int i = 0; i < 8; i++) {
+    blocks[i] = rtl_scratch_alloc(RTL_SCRATCH_CHUNK_SIZE / 3);
+    TEST_ASSERT_NOT_NULL(blocks[i]);
+    memset(blocks[i], i, RTL_SCRATCH_CHUNK_SIZE / 3);
+  }
+
+  char* huge = rtl_scratch_alloc(RTL_SCRATCH_CHUNK_SIZE * 4);
+  TEST_ASSERT_NOT_NULL(huge);
+  memset(huge, 0xEE, RTL_SCRATCH_CHUNK_SIZE * 4);
+
+  for (int i = 0; i < 8; i++) {
+    TEST_ASSERT_EQUAL(i, blocks[i][RTL_SCRATCH_CHUNK_SIZE / 3 - 1]);
+  }
+
+  rtl_scratch_pop(marker);
+  rtl_scratch_release();
+}
+
+// Memory tag tests
+
+// Test tagged allocations are accounted per tag
+void test_memory_tag_accounting(void)
+{
+  const unsigned tag = RTL_MEM_TAG_USER_FIRST;
+  rtl_memory_tag_stats_t stats;
+
+  void* first = rtl_malloc_tagged(tag, 100);
+  void* second = rtl_malloc_tagged(tag, 50);
+  rtl_memory_tag_get_stats(tag, &stats);
+  TEST_ASSERT_EQUAL(150, stats.bytes);
+  TEST_ASSERT_EQUAL(150, stats.peak_bytes);
+  TEST_ASSERT_EQUAL(2, stats.allocations);
+
+  rtl_free(first);
+  rtl_memory_tag_get_stats(tag, &stats);
+  TEST_ASSERT_EQUAL(50, stats.bytes);
+  TEST_ASSERT_EQUAL(150, stats.peak_bytes);
+  TEST_ASSERT_EQUAL(1, stats.allocations);
+
+  rtl_free(second);
+  rtl_memory_tag_get_stats(tag, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+  TEST_ASSERT_EQUAL(0, stats.allocations);
+
+  // Plain allocations land on the user tag
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &stats);
+  const size_t user_bytes = stats.bytes;
+  void* plain = rtl_malloc(10);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &stats);
+  TEST_ASSERT_EQUAL(user_bytes + 10, stats.bytes);
+  rtl_free(plain);
+}
+
+// Test tag names and soft limits
+void test_memory_tag_limits(void)
+{
+  const unsigned tag = RTL_MEM_TAG_USER_FIRST + 1;
+  rtl_memory_tag_set_name(tag, "sessions");
+  TEST_ASSERT_EQUAL_STRING("sessions", rtl_memory_tag_name(tag));
+  TEST_ASSERT_EQUAL_STRING("hash", rtl_memory_tag_name(RTL_MEM_TAG_HASH));
+
+  TEST_ASSERT_TRUE(rtl_memory_tag_within_limit(tag, 1000000));
+  rtl_memory_tag_set_limit(tag, 64);
+  TEST_ASSERT_TRUE(rtl_memory_tag_within_limit(tag, 64));
+  TEST_ASSERT_FALSE(rtl_memory_tag_within_limit(tag, 65));
+
+  // Soft limits never make the allocation itself fail
+  void* data = rtl_malloc_tagged(tag, 100);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_FALSE(rtl_memory_tag_within_limit(tag, 0));
+  rtl_free(data);
+
+  rtl_memory_tag_set_limit(tag, 0);
+  TEST_ASSERT_TRUE(rtl_memory_tag_within_limit(tag, 1000000));
+}
+
+// Test the hash table refuses to grow past its tag budget
+void test_hash_table_tag_limit(void)
+{
+  rtl_hash_table_t table;
+  TEST_ASSERT_TRUE(rtl_hash_table_init(&table, 16, rtl_hash_fnv1a, rtl_hash_key_compare_bytes));
+
+  rtl_memory_tag_stats_t stats;
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_HASH, &stats);
+  TEST_ASSERT_EQUAL(16 * sizeof(rtl_list_entry_t), stats.bytes);
+
+  // Leave room for exactly one more entry
+  const size_t entry_bytes = sizeof(rtl_hash_entry_t) + 2 * sizeof(int);
+  rtl_memory_tag_set_limit(RTL_MEM_TAG_HASH, stats.bytes + entry_bytes);
+
+  int key = 1;
+  int value = 10;
+  TEST_ASSERT_TRUE(rtl_hash_table_insert(&table, &key, sizeof(key), &value, sizeof(value)));
+  key = 2;
+  TEST_ASSERT_FALSE(rtl_hash_table_insert(&table, &key, sizeof(key), &value, sizeof(value)));
+  TEST_ASSERT_EQUAL(1, rtl_hash_table_size(&table));
+
+  // Updates only need room for their net growth
+  key = 1;
+  value = 11;
+  TEST_ASSERT_TRUE(rtl_hash_table_insert(&table, &key, sizeof(key), &value, sizeof(value)));
+  const int64_t wide_value = 12;
+  TEST_ASSERT_FALSE(
+    rtl_hash_table_insert(&table, &key, sizeof(key), &wide_value, sizeof(wide_value)));
+  key = 2;
+
+  rtl_memory_tag_set_limit(RTL_MEM_TAG_HASH, 0);
+  TEST_ASSERT_TRUE(rtl_hash_table_insert(&table, &key, sizeof(key), &value, sizeof(value)));
+
+  rtl_hash_table_cleanup(&table);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_HASH, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+}
+
+// Memory pressure tests
+
+// Pressure callback state for testing
+static int pressure_call_count = 0;
+static void* pressure_cache = NULL;
+
+// Pressure callback that drops a cached block
+static void test_pressure_release_cache(size_t usage, size_t limit, void* user_data)
+{
+  TEST_ASSERT_TRUE(usage >= limit);
+  (*(int*)user_data)++;
+  rtl_free(pressure_cache);
+  pressure_cache = NULL;
+}
+
+// Test crossing the soft limit invokes callbacks once per crossing
+void test_memory_soft_limit_callbacks(void)
+{
+  pressure_call_count = 0;
+  TEST_ASSERT_TRUE(
+    rtl_memory_register_pressure_callback(test_pressure_release_cache, &pressure_call_count));
+
+  const size_t base = rtl_memory_usage();
+  rtl_memory_set_soft_limit(base + 1000);
+  TEST_ASSERT_EQUAL(base + 1000, rtl_memory_get_soft_limit());
+
+  pressure_cache = rtl_malloc(600);
+  TEST_ASSERT_EQUAL(0, pressure_call_count);
+
+  // Crossing the limit makes the callback drop the cache
+  void* data = rtl_malloc(600);
+  TEST_ASSERT_EQUAL(1, pressure_call_count);
+  TEST_ASSERT_NULL(pressure_cache);
+  TEST_ASSERT_EQUAL(base + 600, rtl_memory_usage());
+
+  // Back below the limit, the next crossing signals again
+  void* more = rtl_malloc(600);
+  TEST_ASSERT_EQUAL(2, pressure_call_count);
+  rtl_free(more);
+  rtl_free(data);
+
+  rtl_memory_unregister_pressure_callback(test_pressure_release_cache, &pressure_call_count);
+  rtl_memory_set_soft_limit(0);
+}
+
+// Allocator that fails while armed
+static int failing_malloc_armed = 0;
+
+static void* test_failing_malloc(size_t size)
+{
+  return failing_malloc_armed ? NULL : malloc(size);
+}
+
+// Pressure callback that makes the failing allocator succeed again
+static void test_pressure_disarm(size_t usage, size_t limit, void* user_data)
+{
+  (void)usage;
+  (void)limit;
+  (*(int*)user_data)++;
+  failing_malloc_armed = 0;
+}
+
+// Test allocator failures run the callbacks and retry
+void test_memory_pressure_on_failure(void)
+{
+  rtl_cleanup();
+  rtl_init(test_failing_malloc, NULL);
+
+  pressure_call_count = 0;
+  rtl_memory_register_pressure_callback(test_pressure_disarm, &pressure_call_count);
+
+  failing_malloc_armed = 1;
+  void* data = rtl_malloc(64);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_EQUAL(1, pressure_call_count);
+  rtl_free(data);
+
+  rtl_cleanup();
+  rtl_init(NULL, NULL);
+}
+
+// Test reading the cgroup is consistent when available
+void test_memory_read_cgroup(void)
+{
+  size_t usage = 0;
+  size_t limit = 0;
+  if (rtl_memory_read_cgroup(&usage, &limit)) {
+    TEST_ASSERT_TRUE(usage > 0);
+    TEST_ASSERT_TRUE(limit == 0 || limit >= usage / 2);
+  } else {
+    TEST_ASSERT_FALSE(rtl_memory_check_cgroup_pressure(0));
+  }
+}
+
+// Buddy allocator tests
+
+// Test blocks are rounded to powers of two and aligned to their size
+void test_buddy_alloc_alignment(void)
+{
+  rtl_buddy_t buddy;
+  TEST_ASSERT_TRUE(rtl_buddy_init(&buddy, 1024 * 1024, 64, RTL_PAGE_DEFAULT));
+  TEST_ASSERT_EQUAL(1024 * 1024, buddy.size);
+
+  char* a = rtl_buddy_alloc(&buddy, 100);
+  char* b = rtl_buddy_alloc(&buddy, 4096);
+  char* c = rtl_buddy_alloc(&buddy, 1);
+  TEST_ASSERT_NOT_NULL(a);
+  TEST_ASSERT_NOT_NULL(b);
+  TEST_ASSERT_NOT_NULL(c);
+
+  TEST_ASSERT_EQUAL(128, rtl_buddy_block_size(&buddy, a));
+  TEST_ASSERT_EQUAL(4096, rtl_buddy_block_size(&buddy, b));
+  TEST_ASSERT_EQUAL(64, rtl_buddy_block_size(&buddy, c));
+  TEST_ASSERT_EQUAL(0, (size_t)(a - buddy.base) % 128);
+  TEST_ASSERT_EQUAL(0, (size_t)(b - buddy.base) % 4096);
+  TEST_ASSERT_EQUAL(128 + 4096 + 64, buddy.used);
+
+  memset(b, 0xAB, 4096);
+  TEST_ASSERT_TRUE(rtl_buddy_owns(&buddy, b + 4095));
+  TEST_ASSERT_FALSE(rtl_buddy_owns(&buddy, &buddy));
+
+  rtl_buddy_free(&buddy, a);
+  rtl_buddy_free(&buddy, b);
+  rtl_buddy_free(&buddy, c);
+  rtl_buddy_free(&buddy, NULL);
+  TEST_ASSERT_EQUAL(0, buddy.used);
+
+  rtl_buddy_cleanup(&buddy);
+}
+
+// Test freed blocks coalesce back into the whole region
+void test_buddy_coalescing(void)
+{
+  rtl_buddy_t buddy;
+  TEST_ASSERT_TRUE(rtl_buddy_init(&buddy, 64 * 1024, 1024, RTL_PAGE_DEFAULT));
+
+  // Fill the region with the smallest blocks
+  void* blocks[64];
+  for (int i = 0; i < 64; i++) {
+    blocks[i] = rtl_buddy_alloc(&buddy, 1024);
+    TEST_ASSERT_NOT_NULL(blocks[i]);
+  }
+  TEST_ASSERT_NULL(rtl_buddy_alloc(&buddy, 1));
+
+  // Free in an interleaved order so merges happen late
+  for (int i = 0; i < 64; i += 2) {
+    rtl_buddy_free(&buddy, blocks[i]);
+  }
+  TEST_ASSERT_NULL(rtl_buddy_alloc(&buddy, 2048));
+  for (int i = 1; i < 64; i += 2) {
+    rtl_buddy_free(&buddy, blocks[i]);
+  }
+
+  // Everything merged, so the whole region is available again
+  void* whole = rtl_buddy_alloc(&buddy, 64 * 1024);
+  TEST_ASSERT_EQUAL_PTR(buddy.base, whole);
+  rtl_buddy_free(&buddy, whole);
+
+  rtl_buddy_cleanup(&buddy);
+}
+
+// Test requests larger than the region fail cleanly
+void test_buddy_exhaustion(void)
+{
+  rtl_buddy_t buddy;
+  TEST_ASSERT_TRUE(rtl_buddy_init(&buddy, 32 * 1024, 32, RTL_PAGE_DEFAULT));
+
+  TEST_ASSERT_NULL(rtl_buddy_alloc(&buddy, 64 * 1024));
+
+  void* half = rtl_buddy_alloc(&buddy, 16 * 1024);
+  TEST_ASSERT_NOT_NULL(half);
+  TEST_ASSERT_NULL(rtl_buddy_alloc(&buddy, 32 * 1024));
+  void* other = rtl_buddy_alloc(&buddy, 16 * 1024);
+  TEST_ASSERT_NOT_NULL(other);
+  TEST_ASSERT_NULL(rtl_buddy_alloc(&buddy, 32));
+
+  rtl_buddy_free(&buddy, half);
+  rtl_buddy_free(&buddy, other);
+  rtl_buddy_cleanup(&buddy);
+}
+
+// Test the buddy allocator as the rtl_malloc backend
+void test_buddy_malloc_hooks(void)
+{
+  rtl_buddy_t buddy;
+  TEST_ASSERT_TRUE(rtl_buddy_init(&buddy, 256 * 1024, 64, RTL_PAGE_DEFAULT));
+
+  rtl_cleanup();
+  TEST_ASSERT_TRUE(rtl_buddy_bind(&buddy));
+  rtl_init(rtl_buddy_malloc, rtl_buddy_free_hook);
+  rtl_memory_set_header_func(rtl_buddy_header);
+
+  char* data = rtl_malloc(1000);
+  TEST_ASSERT_NOT_NULL(data);
+  TEST_ASSERT_TRUE(rtl_buddy_owns(&buddy, data));
+  memset(data, 1, 1000);
+
+  // Headers live out of line, so a power-of-two request fills exactly one block
+  char* page = rtl_malloc(4096);
+  TEST_ASSERT_NOT_NULL(page);
+  TEST_ASSERT_EQUAL(4096, rtl_buddy_block_size(&buddy, page));
+  TEST_ASSERT_EQUAL(0, (size_t)(page - buddy.base) % 4096);
+  TEST_ASSERT_EQUAL(1024 + 4096, buddy.used);
+  memset(page, 2, 4096);
+
+  // Larger than the region, so it falls back to malloc
+  char* large = rtl_malloc(512 * 1024);
+  TEST_ASSERT_NOT_NULL(large);
+  TEST_ASSERT_FALSE(rtl_buddy_owns(&buddy, large));
+
+  rtl_memory_tag_stats_t stats;
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_USER, &stats);
+  TEST_ASSERT_EQUAL(1000 + 4096 + 512 * 1024, stats.bytes);
+  TEST_ASSERT_EQUAL(3, stats.allocations);
+
+  // Outstanding blocks keep the allocator bound and mapped
+  TEST_ASSERT_FALSE(rtl_buddy_bind(NULL));
+  rtl_buddy_cleanup(&buddy);
+  TEST_ASSERT_NOT_NULL(buddy.base);
+
+  rtl_free(data);
+  rtl_free(page);
+  rtl_free(large);
+  TEST_ASSERT_EQUAL(0, buddy.used);
+
+  rtl_cleanup();
+  TEST_ASSERT_TRUE(rtl_buddy_bind(NULL));
+  rtl_buddy_cleanup(&buddy);
+  TEST_ASSERT_NULL(buddy.base);
+
+  // Re-initialize with default allocators for other tests
+  rtl_init(NULL, NULL);
+}
+
+// Allocation trace tests
+
+// Builds a path in the system's temporary directory
+static const char* trace_temp_path(char* buffer, size_t size, const char* name)
+{
+  const char* dir = getenv("TMPDIR");
+  if (dir == NULL) {
+    dir = getenv("TEMP");
+  }
+  if (dir == NULL) {
+    dir = getenv("TMP");
+  }
+  if (dir == NULL) {
+#ifdef _WIN32
+    dir = ".";
+#else
+    dir = "/tmp";
+#endif
+  }
+
+  snprintf(buffer, size, "%s/%s", dir, name);
+  return buffer;
+}
+
+// Test allocations and frees are written to the trace file in order
+void test_trace_records(void)
+{
+  char buffer[512];
+  const char* path = trace_temp_path(buffer, sizeof(buffer), "rtl_trace_test.bin");
+  TEST_ASSERT_FALSE(rtl_trace_active());
+  TEST_ASSERT_TRUE(rtl_trace_start(path));
+  TEST_ASSERT_TRUE(rtl_trace_active());
+  TEST_ASSERT_FALSE(rtl_trace_start(path));
+
+  void* a = rtl_malloc(100);
+  void* b = rtl_malloc_tagged(RTL_MEM_TAG_HASH, 200);
+  rtl_free(a);
+  rtl_free(b);
+  rtl_trace_stop();
+  TEST_ASSERT_FALSE(rtl_trace_active());
+
+  // Not recorded once stopped
+  rtl_free(rtl_malloc(300));
+
+  FILE* file = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL(file);
+
+  rtl_trace_file_header_t header;
+  TEST_ASSERT_EQUAL(1, fread(&header, sizeof(header), 1, file));
+  TEST_ASSERT_EQUAL_MEMORY(RTL_TRACE_MAGIC, header.magic, sizeof(header.magic));
+  TEST_ASSERT_EQUAL(RTL_TRACE_VERSION, header.version);
+  TEST_ASSERT_EQUAL(sizeof(rtl_trace_record_t), header.record_size);
+
+  rtl_trace_record_t records[5];
+  TEST_ASSERT_EQUAL(4, fread(records, sizeof(rtl_trace_record_t), 5, file));
+  fclose(file);
+  remove(path);
+
+  TEST_ASSERT_EQUAL(RTL_TRACE_OP_MALLOC, records[0].op);
+  TEST_ASSERT_EQUAL(100, records[0].size);
+  TEST_ASSERT_EQUAL(RTL_MEM_TAG_USER, records[0].tag);
+  TEST_ASSERT_EQUAL(RTL_TRACE_OP_MALLOC, records[1].op);
+  TEST_ASSERT_EQUAL(RTL_MEM_TAG_HASH, records[1].tag);
+  TEST_ASSERT_EQUAL(RTL_TRACE_OP_FREE, records[2].op);
+  TEST_ASSERT_EQUAL(100, records[2].size);
+  TEST_ASSERT_EQUAL(RTL_TRACE_OP_FREE, records[3].op);
+
+  TEST_ASSERT_TRUE(records[0].ptr_id == (uint64_t)(uintptr_t)a);
+  TEST_ASSERT_TRUE(records[2].ptr_id == records[0].ptr_id);
+  TEST_ASSERT_TRUE(records[3].ptr_id == (uint64_t)(uintptr_t)b);
+  TEST_ASSERT_NOT_EQUAL(0, records[0].thread);
+  TEST_ASSERT_EQUAL(records[0].thread, records[3].thread);
+  TEST_ASSERT_TRUE(records[0].timestamp <= records[3].timestamp);
+}
+
+// Test completed buffers reach the file before the trace stops
+void test_trace_buffer_flush(void)
+{
+  char buffer[512];
+  const char* path = trace_temp_path(buffer, sizeof(buffer), "rtl_trace_flush_test.bin");
+  TEST_ASSERT_TRUE(rtl_trace_start(path));
+  for (int i = 0; i < RTL_TRACE_BUFFER_RECORDS; i++) {
+    rtl_free(rtl_malloc(16));
+  }
+  TEST_ASSERT_TRUE(rtl_trace_flush());
+
+  FILE* file = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL(file);
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fclose(file);
+
+  rtl_trace_stop();
+  remove(path);
+
+  TEST_ASSERT_EQUAL(
+    sizeof(rtl_trace_file_header_t) + 2 * RTL_TRACE_BUFFER_RECORDS * sizeof(rtl_trace_record_t),
+    size);
+}
+
+// Static storage hash table tests
+
+// Test a static table never touches the allocator
+void test_hash_table_static_no_alloc(void)
+{
+  static char storage[4096];
+  const size_t required = rtl_hash_table_static_size(16, 32, sizeof(int), sizeof(int));
+  TEST_ASSERT_TRUE(required <= sizeof(storage));
+
+  const size_t usage = rtl_memory_usage();
+
+  rtl_hash_table_t table;
+  bool result = rtl_hash_table_init_static(&table, 16, 32, sizeof(int), sizeof(int), storage,
+    sizeof(storage), rtl_hash_fnv1a, rtl_hash_key_compare_bytes);
+  TEST_ASSERT_TRUE(result);
+
+  for (int i = 0; i < 32; i++) {
+    int value = i * 3;
+    TEST_ASSERT_TRUE(rtl_hash_table_insert(&table, &i, sizeof(i), &value, sizeof(value)));
+  }
+  TEST_ASSERT_EQUAL(32, rtl_hash_table_size(&table));
+
+  for (int i = 0; i < 32; i++) {
+    const int* found_value = rtl_hash_table_find(&table, &i, sizeof(i), NULL);
+    TEST_ASSERT_NOT_NULL(found_value);
+    TEST_ASSERT_EQUAL(i * 3, *found_value);
+  }
+
+  // Updates are done in place
+  int key = 5;
+  int value = 500;
+  TEST_ASSERT_TRUE(rtl_hash_table_insert(&table, &key, sizeof(key), &value, sizeof(value)));
+  TEST_ASSERT_EQUAL(500, *(int*)rtl_hash_table_find(&table, &key, sizeof(key), NULL));
+  TEST_ASSERT_EQUAL(32, rtl_hash_table_size(&table));
+
+  TEST_ASSERT_EQUAL(usage, rtl_memory_usage());
+  rtl_hash_table_cleanup(&table);
+  TEST_ASSERT_EQUAL(usage, rtl_memory_usage());
+}
+
+// Test insert fails when full and succeeds again after a remove
+void test_hash_table_static_full(void)
+{
+  char storage[1024];
+  rtl_hash_table_t table;
+  bool result = rtl_hash_table_init_static(&table, 4, 4, sizeof(int), sizeof(int), storage,
+    sizeof(storage), rtl_hash_fnv1a, rtl_hash_key_compare_bytes);
+  TEST_ASSERT_TRUE(result);
+
+  for (int i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(rtl_hash_table_insert(&table, &i, sizeof(i), &i, sizeof(i)));
+  }
+
+  int key = 4;
+  TEST_ASSERT_FALSE(rtl_hash_table_insert(&table, &key, sizeof(key), &key, sizeof(key)));
+  TEST_ASSERT_NULL(rtl_hash_table_find(&table, &key, sizeof(key), NULL));
+  TEST_ASSERT_EQUAL(4, rtl_hash_table_size(&table));
+
+  int removed = 2;
+  TEST_ASSERT_TRUE(rtl_hash_table_remove(&table, &removed, sizeof(removed)));
+  TEST_ASSERT_TRUE(rtl_hash_table_insert(&table, &key, sizeof(key), &key, sizeof(key)));
+  TEST_ASSERT_EQUAL(4, *(int*)rtl_hash_table_find(&table, &key, sizeof(key), NULL));
+  TEST_ASSERT_NULL(rtl_hash_table_find(&table, &removed, sizeof(removed), NULL));
+
+  rtl_hash_table_cleanup(&table);
+}
+
+// Test keys and values larger than the fixed capacities are refused
+void test_hash_table_static_capacity(void)
+{
+  char storage[2048];
+  rtl_hash_table_t table;
+  bool result = rtl_hash_table_init_static(&table, 8, 8, 16, 8, storage, sizeof(storage),
+    rtl_hash_fnv1a, rtl_hash_key_compare_string);
+  TEST_ASSERT_TRUE(result);
+
+  const char* short_key = "short";
+  const char* long_key = "this key is far too long";
+  double value = 1.5;
+  char big_value[16] = {0};
+
+  TEST_ASSERT_TRUE(
+    rtl_hash_table_insert(&table, short_key, strlen(short_key) + 1, &value, sizeof(value)));
+  TEST_ASSERT_FALSE(
+    rtl_hash_table_insert(&table, long_key, strlen(long_key) + 1, &value, sizeof(value)));
+  TEST_ASSERT_FALSE(rtl_hash_table_insert(
+    &table, short_key, strlen(short_key) + 1, big_value, sizeof(big_value)));
+
+  // The failed update left the old value alone
+  const double* found_value = rtl_hash_table_find(&table, "short", 6, NULL);
+  TEST_ASSERT_NOT_NULL(found_value);
+  TEST_ASSERT_TRUE(*found_value == 1.5);
+  TEST_ASSERT_EQUAL(0, (uintptr_t)found_value % RTL_HASH_STATIC_ALIGNMENT);
+
+  rtl_hash_table_cleanup(&table);
+}
+
+// Test initialization fails when the storage is too small
+void test_hash_table_static_storage_too_small(void)
+{
+  char storage[64];
+  rtl_hash_table_t table;
+  bool result = rtl_hash_table_init_static(&table, 16, 16, 8, 8, storage, sizeof(storage),
+    rtl_hash_fnv1a, rtl_hash_key_compare_bytes);
+  TEST_ASSERT_FALSE(result);
+}
+
+// Counted list tests
+
+// Test the count follows adds and removes
+void test_counted_list_length(void)
+{
+  rtl_counted_list_t list;
+  test_node_t nodes[5];
+
+  rtl_counted_list_init(&list);
+  TEST_ASSERT_TRUE(rtl_counted_list_empty(&list));
+  TEST_ASSERT_EQUAL(0, rtl_counted_list_length(&list));
+
+  for (int i = 0; i < 5; i++) {
+    nodes[i].value = i;
+    if (i % 2 == 0) {
+      rtl_counted_list_add_tail(&list, &nodes[i].list_entry);
+    } else {
+      rtl_counted_list_add_head(&list, &nodes[i].list_entry);
+    }
+  }
+  TEST_ASSERT_EQUAL(5, rtl_counted_list_length(&list));
+  TEST_ASSERT_EQUAL(rtl_list_length(&list.head), rtl_counted_list_length(&list));
+
+  rtl_counted_list_remove(&list, &nodes[2].list_entry);
+  rtl_counted_list_remove(&list, &nodes[3].list_entry);
+  TEST_ASSERT_EQUAL(3, rtl_counted_list_length(&list));
+  TEST_ASSERT_EQUAL(rtl_list_length(&list.head), rtl_counted_list_length(&list));
+  TEST_ASSERT_FALSE(rtl_counted_list_empty(&list));
+}
+
+// Test the head works with the generic iteration macros
+void test_counted_list_iteration(void)
+{
+  rtl_counted_list_t list;
+  test_node_t nodes[4];
+
+  rtl_counted_list_init(&list);
+  for (int i = 0; i < 4; i++) {
+    nodes[i].value = i * 10;
+    rtl_counted_list_add_tail(&list, &nodes[i].list_entry);
+  }
+
+  int index;
+  rtl_list_entry_t* position;
+  rtl_list_for_each_indexed(index, position, &list.head)
+  {
+    TEST_ASSERT_EQUAL(index * 10, rtl_list_record(position, test_node_t, list_entry)->value);
+  }
+
+  // Remove odd values while iterating
+  rtl_list_entry_t* next;
+  rtl_list_for_each_safe(position, next, &list.head)
+  {
+    if (rtl_list_record(position, test_node_t, list_entry)->value % 20 != 0) {
+      rtl_counted_list_remove(&list, position);
+    }
+  }
+  TEST_ASSERT_EQUAL(2, rtl_counted_list_length(&list));
+}
+
+// Test popping entries from the front
+void test_counted_list_pop_head(void)
+{
+  rtl_counted_list_t list;
+  test_node_t nodes[3];
+
+  rtl_counted_list_init(&list);
+  TEST_ASSERT_NULL(rtl_counted_list_pop_head(&list));
+
+  for (int i = 0; i < 3; i++) {
+    nodes[i].value = i;
+    rtl_counted_list_add_tail(&list, &nodes[i].list_entry);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    rtl_list_entry_t* entry = rtl_counted_list_pop_head(&list);
+    TEST_ASSERT_EQUAL_PTR(&nodes[i].list_entry, entry);
+    TEST_ASSERT_EQUAL(2 - i, rtl_counted_list_length(&list));
+  }
+
+  TEST_ASSERT_NULL(rtl_counted_list_pop_head(&list));
+  TEST_ASSERT_TRUE(rtl_list_empty(&list.head));
+}
+
+// List sort tests
+
+// Sort node ordered by key, with a sequence number to check stability
+typedef struct test_sort_node
+{
+  int key;
+  int sequence;
+  rtl_list_entry_t list_entry;
+} test_sort_node_t;
+
+static int test_sort_compare(const rtl_list_entry_t* a, const rtl_list_entry_t* b)
+{
+  const int key_a = rtl_list_record(a, test_sort_node_t, list_entry)->key;
+  const int key_b = rtl_list_record(b, test_sort_node_t, list_entry)->key;
+  return (key_a > key_b) - (key_a < key_b);
+}
+
+// Checks order, stability and prev links of a sorted list
+static void test_sort_verify(rtl_list_entry_t* head, unsigned long expected_length)
+{
+  TEST_ASSERT_EQUAL(expected_length, rtl_list_length(head));
+
+  rtl_list_entry_t* position;
+  const test_sort_node_t* previous = NULL;
+  rtl_list_for_each(position, head)
+  {
+    TEST_ASSERT_EQUAL_PTR(position, position->prev->next);
+    const test_sort_node_t* node = rtl_list_record(position, test_sort_node_t, list_entry);
+    if (previous != NULL) {
+      TEST_ASSERT_TRUE(previous->key <= node->key);
+      if (previous->key == node->key) {
+        TEST_ASSERT_TRUE(previous->sequence < node->sequence);
+      }
+    }
+    previous = node;
+  }
+  TEST_ASSERT_EQUAL_PTR(head, head->prev->next);
+}
+
+// Test sorting empty and single entry lists
+void test_list_sort_trivial(void)
+{
+  rtl_list_entry_t head;
+  rtl_list_init(&head);
+  rtl_list_sort(&head, test_sort_compare);
+  TEST_ASSERT_TRUE(rtl_list_empty(&head));
+
+  test_sort_node_t node = {7, 0, {NULL, NULL}};
+  rtl_list_add_tail(&head, &node.list_entry);
+  rtl_list_sort(&head, test_sort_compare);
+  TEST_ASSERT_EQUAL_PTR(&node.list_entry, head.next);
+  TEST_ASSERT_EQUAL_PTR(&node.list_entry, head.prev);
+}
+
+// Test a large pseudo-random list with many duplicate keys sorts stably
+void test_list_sort_stable(void)
+{
+  static test_sort_node_t nodes[1000];
+  rtl_list_entry_t head;
+  rtl_list_init(&head);
+
+  unsigned seed = 12345;
+  for (int i = 0; i < 1000; i++) {
+    seed = seed * 1103515245 + 12345;
+    nodes[i].key = (int)((seed >> 16) % 50);
+    nodes[i].sequence = i;
+    rtl_list_add_tail(&head, &nodes[i].list_entry);
+  }
+
+  rtl_list_sort(&head, test_sort_compare);
+  test_sort_verify(&head, 1000);
+
+  // Sorting an already sorted list keeps it intact
+  rtl_list_sort(&head, test_sort_compare);
+  test_sort_verify(&head, 1000);
+}
+
+// Test sorting a reversed list
+void test_list_sort_reversed(void)
+{
+  test_sort_node_t nodes[37];
+  rtl_list_entry_t head;
+  rtl_list_init(&head);
+
+  for (int i = 0; i < 37; i++) {
+    nodes[i].key = 37 - i;
+    nodes[i].sequence = i;
+    rtl_list_add_tail(&head, &nodes[i].list_entry);
+  }
+
+  rtl_list_sort(&head, test_sort_compare);
+  test_sort_verify(&head, 37);
+  TEST_ASSERT_EQUAL_PTR(&nodes[36].list_entry, head.next);
+  TEST_ASSERT_EQUAL_PTR(&nodes[0].list_entry, head.prev);
+}
+
+// Test merging two sorted lists keeps the receiving list's entries first on ties
+void test_list_merge(void)
+{
+  const int keys[9] = {1, 3, 5, 5, 0, 3, 5, 6, 9};
+  test_sort_node_t nodes[9];
+  rtl_list_entry_t head;
+  rtl_list_entry_t other;
+  rtl_list_init(&head);
+  rtl_list_init(&other);
+
+  // The first four keys go to head, the rest to other
+  for (int i = 0; i < 9; i++) {
+    nodes[i].key = keys[i];
+    nodes[i].sequence = i;
+    rtl_list_add_tail(i < 4 ? &head : &other, &nodes[i].list_entry);
+  }
+
+  rtl_list_merge(&head, &other, test_sort_compare);
+  TEST_ASSERT_TRUE(rtl_list_empty(&other));
+  test_sort_verify(&head, 9);
+
+  // Merging an empty list changes nothing
+  rtl_list_merge(&head, &other, test_sort_compare);
+  test_sort_verify(&head, 9);
+}
+
+// List splice tests
+
+// Collects node values of a list into an array, returns the count
+static int test_list_values(rtl_list_entry_t* head, int* values)
+{
+  int count = 0;
+  rtl_list_entry_t* position;
+  rtl_list_for_each(position, head)
+  {
+    TEST_ASSERT_EQUAL_PTR(position, position->next->prev);
+    values[count++] = rtl_list_record(position, test_node_t, list_entry)->value;
+  }
+  TEST_ASSERT_EQUAL_PTR(head, head->next->prev);
+  return count;
+}
+
+// Test splicing a list onto the front and back of another
+void test_list_splice(void)
+{
+  test_node_t nodes[6];
+  rtl_list_entry_t head;
+  rtl_list_entry_t batch;
+  rtl_list_init(&head);
+  rtl_list_init(&batch);
+
+  for (int i = 0; i < 6; i++) {
+    nodes[i].value = i;
+  }
+  rtl_list_add_tail(&head, &nodes[2].list_entry);
+  rtl_list_add_tail(&head, &nodes[3].list_entry);
+  rtl_list_add_tail(&batch, &nodes[0].list_entry);
+  rtl_list_add_tail(&batch, &nodes[1].list_entry);
+
+  rtl_list_splice_head(&head, &batch);
+  TEST_ASSERT_TRUE(rtl_list_empty(&batch));
+
+  rtl_list_add_tail(&batch, &nodes[4].list_entry);
+  rtl_list_add_tail(&batch, &nodes[5].list_entry);
+  rtl_list_splice_tail(&head, &batch);
+  TEST_ASSERT_TRUE(rtl_list_empty(&batch));
+
+  // Splicing an empty list is a no-op
+  rtl_list_splice_tail(&head, &batch);
+  rtl_list_splice_head(&head, &batch);
+
+  int values[6];
+  TEST_ASSERT_EQUAL(6, test_list_values(&head, values));
+  for (int i = 0; i < 6; i++) {
+    TEST_ASSERT_EQUAL(i, values[i]);
+  }
+}
+
+// Test cutting the front of a list into another list
+void test_list_cut_position(void)
+{
+  test_node_t nodes[5];
+  rtl_list_entry_t head;
+  rtl_list_entry_t front;
+  rtl_list_init(&head);
+
+  for (int i = 0; i < 5; i++) {
+    nodes[i].value = i;
+    rtl_list_add_tail(&head, &nodes[i].list_entry);
+  }
+
+  rtl_list_cut_position(&front, &head, &nodes[2].list_entry);
+
+  int values[5];
+  TEST_ASSERT_EQUAL(3, test_list_values(&front, values));
+  TEST_ASSERT_EQUAL(0, values[0]);
+  TEST_ASSERT_EQUAL(2, values[2]);
+  TEST_ASSERT_EQUAL(2, test_list_values(&head, values));
+  TEST_ASSERT_EQUAL(3, values[0]);
+  TEST_ASSERT_EQUAL(4, values[1]);
+
+  // Cutting at the head moves nothing
+  rtl_list_cut_position(&front, &head, &head);
+  TEST_ASSERT_TRUE(rtl_list_empty(&front));
+  TEST_ASSERT_EQUAL(2, rtl_list_length(&head));
+
+  // Cutting at the last entry moves everything
+  rtl_list_cut_position(&front, &head, head.prev);
+  TEST_ASSERT_TRUE(rtl_list_empty(&head));
+  TEST_ASSERT_EQUAL(2, test_list_values(&front, values));
+}
+
+// Test handing a whole list over to a new head
+void test_list_replace_init(void)
+{
+  test_node_t nodes[3];
+  rtl_list_entry_t producer;
+  rtl_list_entry_t consumer;
+  rtl_list_init(&producer);
+  rtl_list_init(&consumer);
+
+  for (int i = 0; i < 3; i++) {
+    nodes[i].value = i;
+    rtl_list_add_tail(&producer, &nodes[i].list_entry);
+  }
+
+  rtl_list_replace_init(&producer, &consumer);
+  TEST_ASSERT_TRUE(rtl_list_empty(&producer));
+
+  int values[3];
+  TEST_ASSERT_EQUAL(3, test_list_values(&consumer, values));
+  TEST_ASSERT_EQUAL(0, values[0]);
+  TEST_ASSERT_EQUAL(2, values[2]);
+
+  // Handing the entries back leaves both heads consistent
+  rtl_list_replace_init(&consumer, &producer);
+  TEST_ASSERT_TRUE(rtl_list_empty(&consumer));
+  TEST_ASSERT_EQUAL(3, test_list_values(&producer, values));
+  TEST_ASSERT_EQUAL(0, values[0]);
+  TEST_ASSERT_EQUAL(2, values[2]);
+
+  // An empty list hands over nothing
+  rtl_list_entry_t spare;
+  rtl_list_init(&spare);
+  rtl_list_replace_init(&consumer, &spare);
+  TEST_ASSERT_TRUE(rtl_list_empty(&consumer));
+  TEST_ASSERT_TRUE(rtl_list_empty(&spare));
+}
+
+// Prefetching iteration tests
+
+// Test prefetching iteration visits the same entries in order, including short lists
+void test_list_for_each_prefetch(void)
+{
+  test_node_t nodes[50];
+  rtl_list_entry_t head;
+
+  for (int length = 0; length <= 50; length += 1 + length / 2) {
+    rtl_list_init(&head);
+    for (int i = 0; i < length; i++) {
+      nodes[i].value = i;
+      rtl_list_add_tail(&head, &nodes[i].list_entry);
+    }
+
+    int count = 0;
+    rtl_list_entry_t* position;
+    rtl_list_entry_t* ahead;
+    rtl_list_for_each_prefetch(position, ahead, &head)
+    {
+      TEST_ASSERT_EQUAL(count, rtl_list_record(position, test_node_t, list_entry)->value);
+      count++;
+    }
+    TEST_ASSERT_EQUAL(length, count);
+
+    count = 0;
+    rtl_list_for_each_prefetch_record(position, ahead, &head, test_node_t, list_entry)
+    {
+      TEST_ASSERT_EQUAL(count, rtl_list_record(position, test_node_t, list_entry)->value);
+      count++;
+    }
+    TEST_ASSERT_EQUAL(length, count);
+  }
+}
+
+// Test the safe prefetching variant allows removing the current entry
+void test_list_for_each_safe_prefetch(void)
+{
+  test_node_t nodes[20];
+  rtl_list_entry_t head;
+  rtl_list_init(&head);
+
+  for (int i = 0; i < 20; i++) {
+    nodes[i].value = i;
+    rtl_list_add_tail(&head, &nodes[i].list_entry);
+  }
+
+  rtl_list_entry_t* position;
+  rtl_list_entry_t* next;
+  rtl_list_entry_t* ahead;
+  rtl_list_for_each_safe_prefetch(position, next, ahead, &head)
+  {
+    if (rtl_list_record(position, test_node_t, list_entry)->value % 3 != 0) {
+      rtl_list_remove(position);
+    }
+  }
+
+  TEST_ASSERT_EQUAL(7, rtl_list_length(&head));
+  rtl_list_for_each(position, &head)
+  {
+    TEST_ASSERT_EQUAL(0, rtl_list_record(position, test_node_t, list_entry)->value % 3);
+  }
+}
+
+// Test the prefetching callback iteration matches the plain one
+void test_list_for_each_callback_prefetch(void)
+{
+  test_node_t nodes[10];
+  rtl_list_entry_t head;
+  rtl_list_init(&head);
+
+  for (int i = 0; i < 10; i++) {
+    nodes[i].value = i;
+    rtl_list_add_tail(&head, &nodes[i].list_entry);
+  }
+
+  int sum = 0;
+  rtl_list_for_each_callback_prefetch(&head, RTL_LIST_PREFETCH_DISTANCE, test_callback_sum, &sum);
+  TEST_ASSERT_EQUAL(45, sum);
+
+  // The validator stops early if indexes and values ever disagree
+  int expected_value = 0;
+  rtl_list_for_each_callback_prefetch(&head, 3, test_callback_validator, &expected_value);
+  TEST_ASSERT_EQUAL(10, expected_value);
+
+  // A distance past the end of the list must stop at the head
+  expected_value = 0;
+  rtl_list_for_each_callback_prefetch(&head, 64, test_callback_validator, &expected_value);
+  TEST_ASSERT_EQUAL(10, expected_value);
+
+  rtl_list_for_each_callback_prefetch(&head, 0, NULL, NULL);
+}
+
+// MPSC queue tests
+
+// Queued item with an embedded MPSC node
+typedef struct test_mpsc_item
+{
+  int value;
+  rtl_mpsc_node_t node;
+} test_mpsc_item_t;
+
+// Test nodes come out in push order
+void test_mpsc_fifo(void)
+{
+  rtl_mpsc_t queue;
+  test_mpsc_item_t items[10];
+  rtl_mpsc_init(&queue);
+
+  TEST_ASSERT_TRUE(rtl_mpsc_empty(&queue));
+  TEST_ASSERT_NULL(rtl_mpsc_pop(&queue));
+
+  for (int i = 0; i < 10; i++) {
+    items[i].value = i;
+    rtl_mpsc_push(&queue, &items[i].node);
+  }
+  TEST_ASSERT_FALSE(rtl_mpsc_empty(&queue));
+
+  for (int i = 0; i < 10; i++) {
+    rtl_mpsc_node_t* node = rtl_mpsc_pop(&queue);
+    TEST_ASSERT_NOT_NULL(node);
+    TEST_ASSERT_EQUAL(i, RTL_CONTAINER_OF(node, test_mpsc_item_t, node)->value);
+  }
+
+  TEST_ASSERT_TRUE(rtl_mpsc_empty(&queue));
+  TEST_ASSERT_NULL(rtl_mpsc_pop(&queue));
+}
+
+// Test interleaved pushes and pops, including draining down to a single node
+void test_mpsc_interleaved(void)
+{
+  rtl_mpsc_t queue;
+  test_mpsc_item_t items[3];
+  rtl_mpsc_init(&queue);
+
+  for (int round = 0; round < 5; round++) {
+    items[0].value = round;
+    rtl_mpsc_push(&queue, &items[0].node);
+    rtl_mpsc_node_t* node = rtl_mpsc_pop(&queue);
+    TEST_ASSERT_EQUAL_PTR(&items[0].node, node);
+    TEST_ASSERT_TRUE(rtl_mpsc_empty(&queue));
+  }
+
+  rtl_mpsc_push(&queue, &items[0].node);
+  rtl_mpsc_push(&queue, &items[1].node);
+  TEST_ASSERT_EQUAL_PTR(&items[0].node, rtl_mpsc_pop(&queue));
+  rtl_mpsc_push(&queue, &items[2].node);
+  TEST_ASSERT_EQUAL_PTR(&items[1].node, rtl_mpsc_pop(&queue));
+  TEST_ASSERT_EQUAL_PTR(&items[2].node, rtl_mpsc_pop(&queue));
+
+  // A popped node can be pushed again
+  rtl_mpsc_push(&queue, &items[1].node);
+  TEST_ASSERT_EQUAL_PTR(&items[1].node, rtl_mpsc_pop(&queue));
+  TEST_ASSERT_NULL(rtl_mpsc_pop(&queue));
+}
+
+#if defined(__linux__)
+#define MPSC_THREAD_PRODUCERS 4
+#define MPSC_THREAD_ITEMS     5000
+
+// Producer thread argument, items carry producer * MPSC_THREAD_ITEMS + sequence
+typedef struct test_mpsc_producer
+{
+  rtl_mpsc_t* queue;
+  int producer;
+  test_mpsc_item_t items[MPSC_THREAD_ITEMS];
+} test_mpsc_producer_t;
+
+static test_mpsc_producer_t g_mpsc_producers[MPSC_THREAD_PRODUCERS];
+
+static void* mpsc_producer_thread(void* arg)
+{
+  test_mpsc_producer_t* producer = arg;
+  for (int i = 0; i < MPSC_THREAD_ITEMS; i++) {
+    test_mpsc_item_t* item = &producer->items[i];
+    item->value = producer->producer * MPSC_THREAD_ITEMS + i;
+    rtl_mpsc_push(producer->queue, &item->node);
+    if (i % 64 == 0) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+// Test several producers against one consumer, each producer's nodes stay in order
+void test_mpsc_threads(void)
+{
+  rtl_mpsc_t queue;
+  rtl_mpsc_init(&queue);
+
+  pthread_t producers[MPSC_THREAD_PRODUCERS];
+  for (int i = 0; i < MPSC_THREAD_PRODUCERS; i++) {
+    g_mpsc_producers[i].queue = &queue;
+    g_mpsc_producers[i].producer = i;
+    TEST_ASSERT_EQUAL(
+      0, pthread_create(&producers[i], NULL, mpsc_producer_thread, &g_mpsc_producers[i]));
+  }
+
+  int next[MPSC_THREAD_PRODUCERS] = { 0 };
+  int received = 0;
+  while (received < MPSC_THREAD_PRODUCERS * MPSC_THREAD_ITEMS) {
+    rtl_mpsc_node_t* node = rtl_mpsc_pop(&queue);
+    if (!node) {
+      sched_yield();
+      continue;
+    }
+    const int value = RTL_CONTAINER_OF(node, test_mpsc_item_t, node)->value;
+    const int producer = value / MPSC_THREAD_ITEMS;
+    TEST_ASSERT_EQUAL(next[producer]++, value % MPSC_THREAD_ITEMS);
+    received++;
+  }
+
+  for (int i = 0; i < MPSC_THREAD_PRODUCERS; i++) {
+    TEST_ASSERT_EQUAL(0, pthread_join(producers[i], NULL));
+    TEST_ASSERT_EQUAL(MPSC_THREAD_ITEMS, next[i]);
+  }
+  TEST_ASSERT_NULL(rtl_mpsc_pop(&queue));
+  TEST_ASSERT_TRUE(rtl_mpsc_empty(&queue));
+}
+#endif
+
+// Lock-free stack tests
+
+// Stacked item with an embedded stack node
+typedef struct test_lfstack_item
+{
+  int value;
+  rtl_lfstack_node_t node;
+} test_lfstack_item_t;
+
+// Test nodes pop in LIFO order
+void test_lfstack_lifo(void)
+{
+  rtl_lfstack_t stack;
+  test_lfstack_item_t items[8];
+  rtl_lfstack_init(&stack);
+
+  TEST_ASSERT_TRUE(rtl_lfstack_empty(&stack));
+  TEST_ASSERT_NULL(rtl_lfstack_pop(&stack));
+
+  for (int i = 0; i < 8; i++) {
+    items[i].value = i;
+    rtl_lfstack_push(&stack, &items[i].node);
+  }
+  TEST_ASSERT_FALSE(rtl_lfstack_empty(&stack));
+
+  for (int i = 7; i >= 0; i--) {
+    rtl_lfstack_node_t* node = rtl_lfstack_pop(&stack);
+    TEST_ASSERT_NOT_NULL(node);
+    TEST_ASSERT_EQUAL(i, RTL_CONTAINER_OF(node, test_lfstack_item_t, node)->value);
+  }
+
+  TEST_ASSERT_TRUE(rtl_lfstack_empty(&stack));
+  TEST_ASSERT_NULL(rtl_lfstack_pop(&stack));
+}
+
+// Test detaching the whole stack and pushing a chain back
+void test_lfstack_pop_all(void)
+{
+  rtl_lfstack_t stack;
+  test_lfstack_item_t items[5];
+  rtl_lfstack_init(&stack);
+
+  TEST_ASSERT_NULL(rtl_lfstack_pop_all(&stack));
+
+  for (int i = 0; i < 5; i++) {
+    items[i].value = i;
+    rtl_lfstack_push(&stack, &items[i].node);
+  }
+
+  rtl_lfstack_node_t* chain = rtl_lfstack_pop_all(&stack);
+  TEST_ASSERT_TRUE(rtl_lfstack_empty(&stack));
+
+  // The chain runs from the top down
+  int expected = 4;
+  rtl_lfstack_node_t* last = NULL;
+  for (rtl_lfstack_node_t* node = chain; node != NULL; node = node->next) {
+    TEST_ASSERT_EQUAL(expected--, RTL_CONTAINER_OF(node, test_lfstack_item_t, node)->value);
+    last = node;
+  }
+  TEST_ASSERT_EQUAL(-1, expected);
+
+  // Pushing the chain back on top of another node restores the same order
+  test_lfstack_item_t bottom = {-1, {NULL}};
+  rtl_lfstack_push(&stack, &bottom.node);
+  rtl_lfstack_push_chain(&stack, chain, last);
+  for (int i = 4; i >= 0; i--) {
+    rtl_lfstack_node_t* node = rtl_lfstack_pop(&stack);
+    TEST_ASSERT_EQUAL(i, RTL_CONTAINER_OF(node, test_lfstack_item_t, node)->value);
+  }
+  TEST_ASSERT_EQUAL_PTR(&bottom.node, rtl_lfstack_pop(&stack));
+  TEST_ASSERT_NULL(rtl_lfstack_pop(&stack));
+}
+
+#if defined(__linux__)
+#define LFSTACK_THREAD_COUNT 4
+#define LFSTACK_THREAD_NODES 64
+#define LFSTACK_THREAD_ROUNDS 20000
+
+// Pooled node with an ownership flag, set while a thread holds it
+typedef struct test_lfstack_pooled
+{
+  rtl_lfstack_node_t node;
+  rtl_atomic_word_t held;
+} test_lfstack_pooled_t;
+
+static test_lfstack_pooled_t g_lfstack_pool[LFSTACK_THREAD_NODES];
+static rtl_atomic_word_t g_lfstack_errors;
+
+// Takes ownership of a popped node, counting an error if another thread holds it
+static void lfstack_take(rtl_lfstack_node_t* node)
+{
+  test_lfstack_pooled_t* pooled = RTL_CONTAINER_OF(node, test_lfstack_pooled_t, node);
+  if (rtl_atomic_exchange(&pooled->held, 1) != 0) {
+    rtl_atomic_fetch_add(&g_lfstack_errors, 1);
+  }
+}
+
+static void lfstack_release(rtl_lfstack_node_t* node)
+{
+  rtl_atomic_store(&RTL_CONTAINER_OF(node, test_lfstack_pooled_t, node)->held, 0);
+}
+
+static void* lfstack_thread(void* arg)
+{
+  rtl_lfstack_t* stack = arg;
+  for (int round = 0; round < LFSTACK_THREAD_ROUNDS; round++) {
+    if (round % 256 == 0) {
+      // Detach everything, own it for a moment, then push the chain back
+      rtl_lfstack_node_t* chain = rtl_lfstack_pop_all(stack);
+      rtl_lfstack_node_t* last = NULL;
+      for (rtl_lfstack_node_t* node = chain; node; node = rtl_atomic_load_ptr(&node->next)) {
+        lfstack_take(node);
+        last = node;
+      }
+      for (rtl_lfstack_node_t* node = chain; node; node = rtl_atomic_load_ptr(&node->next)) {
+        lfstack_release(node);
+      }
+      if (chain) {
+        rtl_lfstack_push_chain(stack, chain, last);
+      }
+      continue;
+    }
+
+    rtl_lfstack_node_t* node = rtl_lfstack_pop(stack);
+    if (!node) {
+      sched_yield();
+      continue;
+    }
+    lfstack_take(node);
+    lfstack_release(node);
+    rtl_lfstack_push(stack, node);
+  }
+  return NULL;
+}
+
+// Test concurrent push, pop and pop_all never hand a node to two threads or lose one
+void test_lfstack_threads(void)
+{
+  rtl_lfstack_t stack;
+  rtl_lfstack_init(&stack);
+  rtl_atomic_store(&g_lfstack_errors, 0);
+  for (int i = 0; i < LFSTACK_THREAD_NODES; i++) {
+    rtl_atomic_store(&g_lfstack_pool[i].held, 0);
+    rtl_lfstack_push(&stack, &g_lfstack_pool[i].node);
+  }
+
+  pthread_t threads[LFSTACK_THREAD_COUNT];
+  for (int i = 0; i < LFSTACK_THREAD_COUNT; i++) {
+    TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, lfstack_thread, &stack));
+  }
+  for (int i = 0; i < LFSTACK_THREAD_COUNT; i++) {
+    TEST_ASSERT_EQUAL(0, pthread_join(threads[i], NULL));
+  }
+  TEST_ASSERT_EQUAL(0, rtl_atomic_load(&g_lfstack_errors));
+
+  // Every node is back exactly once
+  int count = 0;
+  rtl_lfstack_node_t* node;
+  while ((node = rtl_lfstack_pop(&stack)) != NULL) {
+    lfstack_take(node);
+    count++;
+  }
+  TEST_ASSERT_EQUAL(LFSTACK_THREAD_NODES, count);
+  TEST_ASSERT_EQUAL(0, rtl_atomic_load(&g_lfstack_errors));
+}
+#endif
+
+// SPSC ring tests
+
+// Test single pushes and pops, including full and empty rings
+void test_spsc_push_pop(void)
+{
+  rtl_spsc_t ring;
+  TEST_ASSERT_TRUE(rtl_spsc_init(&ring, 5, sizeof(int)));
+  TEST_ASSERT_EQUAL(8, rtl_spsc_capacity(&ring));
+
+  int value;
+  TEST_ASSERT_FALSE(rtl_spsc_pop(&ring, &value));
+
+  for (int i = 0; i < 8; i++) {
+    TEST_ASSERT_TRUE(rtl_spsc_push(&ring, &i));
+  }
+  int extra = 100;
+  TEST_ASSERT_FALSE(rtl_spsc_push(&ring, &extra));
+  TEST_ASSERT_EQUAL(8, rtl_spsc_size(&ring));
+
+  // Wrap around the end of the storage several times
+  for (int i = 0; i < 40; i++) {
+    TEST_ASSERT_TRUE(rtl_spsc_pop(&ring, &value));
+    TEST_ASSERT_EQUAL(i, value);
+    const int next = i + 8;
+    TEST_ASSERT_TRUE(rtl_spsc_push(&ring, &next));
+  }
+
+  for (int i = 40; i < 48; i++) {
+    TEST_ASSERT_TRUE(rtl_spsc_pop(&ring, &value));
+    TEST_ASSERT_EQUAL(i, value);
+  }
+  TEST_ASSERT_FALSE(rtl_spsc_pop(&ring, &value));
+  TEST_ASSERT_EQUAL(0, rtl_spsc_size(&ring));
+
+  rtl_spsc_cleanup(&ring);
+}
+
+// Test batches split across the end of the storage and partial batches
+void test_spsc_batch(void)
+{
+  rtl_spsc_t ring;
+  TEST_ASSERT_TRUE(rtl_spsc_init(&ring, 16, sizeof(uint64_t)));
+
+  uint64_t input[32];
+  uint64_t output[32];
+  for (int i = 0; i < 32; i++) {
+    input[i] = (uint64_t)i * 1000;
+  }
+
+  // Move the indices close to the end first
+  TEST_ASSERT_EQUAL(10, rtl_spsc_push_batch(&ring, input, 10));
+  TEST_ASSERT_EQUAL(10, rtl_spsc_pop_batch(&ring, output, 32));
+
+  // Only 16 fit, and they straddle the wrap point
+  TEST_ASSERT_EQUAL(16, rtl_spsc_push_batch(&ring, input, 32));
+  TEST_ASSERT_EQUAL(0, rtl_spsc_push_batch(&ring, input, 1));
+
+  TEST_ASSERT_EQUAL(5, rtl_spsc_pop_batch(&ring, output, 5));
+  TEST_ASSERT_EQUAL(11, rtl_spsc_pop_batch(&ring, output + 5, 32));
+  TEST_ASSERT_EQUAL_MEMORY(input, output, 16 * sizeof(uint64_t));
+  TEST_ASSERT_EQUAL(0, rtl_spsc_pop_batch(&ring, output, 32));
+
+  rtl_spsc_cleanup(&ring);
+}
+
+#if defined(__linux__)
+#define SPSC_THREAD_ITEMS 100000
+
+static void* spsc_producer_thread(void* arg)
+{
+  rtl_spsc_t* ring = arg;
+  uint64_t batch[7];
+  uint64_t next = 0;
+
+  // Alternate single pushes with batches so both paths race the consumer
+  while (next < SPSC_THREAD_ITEMS) {
+    size_t pushed;
+    if (next % 2 == 0) {
+      pushed = rtl_spsc_push(ring, &next) ? 1 : 0;
+    } else {
+      size_t count = 0;
+      while (count < 7 && next + count < SPSC_THREAD_ITEMS) {
+        batch[count] = next + count;
+        count++;
+      }
+      pushed = rtl_spsc_push_batch(ring, batch, count);
+    }
+    if (pushed == 0) {
+      sched_yield();
+    }
+    next += pushed;
+  }
+  return NULL;
+}
+
+// Test a producer thread and a consumer thread passing elements through a small ring
+void test_spsc_threads(void)
+{
+  rtl_spsc_t ring;
+  TEST_ASSERT_TRUE(rtl_spsc_init(&ring, 16, sizeof(uint64_t)));
+
+  pthread_t producer;
+  TEST_ASSERT_EQUAL(0, pthread_create(&producer, NULL, spsc_producer_thread, &ring));
+
+  uint64_t batch[5];
+  uint64_t expected = 0;
+  while (expected < SPSC_THREAD_ITEMS) {
+    TEST_ASSERT_TRUE(rtl_spsc_size(&ring) <= rtl_spsc_capacity(&ring));
+
+    size_t popped = 0;
+    if (expected % 3 == 0) {
+      popped = rtl_spsc_pop(&ring, batch) ? 1 : 0;
+    } else {
+      popped = rtl_spsc_pop_batch(&ring, batch, 5);
+    }
+    if (popped == 0) {
+      sched_yield();
+    }
+    for (size_t i = 0; i < popped; i++) {
+      TEST_ASSERT_EQUAL_UINT64(expected++, batch[i]);
+    }
+  }
+
+  TEST_ASSERT_EQUAL(0, pthread_join(producer, NULL));
+  TEST_ASSERT_EQUAL(0, rtl_spsc_size(&ring));
+
+  rtl_spsc_cleanup(&ring);
+}
+#endif
+
+// Test ring storage is accounted to the queue tag
+void test_spsc_memory_tag(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_spsc_t ring;
+  TEST_ASSERT_TRUE(rtl_spsc_init(&ring, 64, 32));
+
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL(64 * 32, stats.bytes);
+  TEST_ASSERT_EQUAL_STRING("queue", rtl_memory_tag_name(RTL_MEM_TAG_QUEUE));
+
+  rtl_spsc_cleanup(&ring);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+}
+
+// MPMC queue tests
+
+// Test non-blocking pushes and pops, including full and empty queues
+void test_mpmc_try_push_pop(void)
+{
+  rtl_mpmc_t queue;
+  TEST_ASSERT_TRUE(rtl_mpmc_init(&queue, 3, sizeof(int)));
+  TEST_ASSERT_EQUAL(4, rtl_mpmc_capacity(&queue));
+
+  int value;
+  TEST_ASSERT_FALSE(rtl_mpmc_try_pop(&queue, &value));
+
+  for (int i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(rtl_mpmc_try_push(&queue, &i));
+  }
+  int extra = 100;
+  TEST_ASSERT_FALSE(rtl_mpmc_try_push(&queue, &extra));
+
+  // Go around the cells several times so the sequence numbers advance by laps
+  for (int i = 0; i < 20; i++) {
+    TEST_ASSERT_TRUE(rtl_mpmc_try_pop(&queue, &value));
+    TEST_ASSERT_EQUAL(i, value);
+    const int next = i + 4;
+    TEST_ASSERT_TRUE(rtl_mpmc_try_push(&queue, &next));
+  }
+
+  for (int i = 20; i < 24; i++) {
+    TEST_ASSERT_TRUE(rtl_mpmc_try_pop(&queue, &value));
+    TEST_ASSERT_EQUAL(i, value);
+  }
+  TEST_ASSERT_FALSE(rtl_mpmc_try_pop(&queue, &value));
+
+  rtl_mpmc_cleanup(&queue);
+}
+
+// Test blocking calls that never have to wait, with an odd element size
+void test_mpmc_blocking(void)
+{
+  rtl_mpmc_t queue;
+  TEST_ASSERT_TRUE(rtl_mpmc_init(&queue, 8, 3));
+
+  const char input[8][3] = { "ab", "cd", "ef", "gh", "ij", "kl", "mn", "op" };
+  for (int i = 0; i < 8; i++) {
+    rtl_mpmc_push(&queue, input[i]);
+  }
+  TEST_ASSERT_FALSE(rtl_mpmc_try_push(&queue, input[0]));
+
+  char output[3];
+  for (int i = 0; i < 8; i++) {
+    rtl_mpmc_pop(&queue, output);
+    TEST_ASSERT_EQUAL_MEMORY(input[i], output, 3);
+  }
+  TEST_ASSERT_FALSE(rtl_mpmc_try_pop(&queue, output));
+
+  rtl_mpmc_cleanup(&queue);
+}
+
+#if defined(__linux__)
+#define MPMC_THREAD_ITEMS 2000
+
+static void* mpmc_producer_thread(void* arg)
+{
+  rtl_mpmc_t* queue = arg;
+  for (uint32_t i = 0; i < MPMC_THREAD_ITEMS; i++) {
+    rtl_mpmc_push(queue, &i);
+  }
+  return NULL;
+}
+
+static void* mpmc_consumer_thread(void* arg)
+{
+  rtl_mpmc_t* queue = arg;
+  uint32_t value;
+  rtl_mpmc_pop(queue, &value);
+  return (void*)(uintptr_t)(value + 1);
+}
+
+// Test that producers sleep on a full queue and consumers on an empty one
+void test_mpmc_blocking_threads(void)
+{
+  rtl_mpmc_t queue;
+  TEST_ASSERT_TRUE(rtl_mpmc_init(&queue, 2, sizeof(uint32_t)));
+
+  // Nothing is popped until the producer has given up spinning on the full queue
+  pthread_t producer;
+  TEST_ASSERT_EQUAL(0, pthread_create(&producer, NULL, mpmc_producer_thread, &queue));
+  while (rtl_atomic_load(&queue.producers_waiting) == 0) {
+    sched_yield();
+  }
+  for (uint32_t i = 0; i < MPMC_THREAD_ITEMS; i++) {
+    uint32_t value;
+    rtl_mpmc_pop(&queue, &value);
+    TEST_ASSERT_EQUAL_UINT32(i, value);
+  }
+  TEST_ASSERT_EQUAL(0, pthread_join(producer, NULL));
+
+  // Each element wakes one sleeper, so every consumer must get its own
+  pthread_t consumers[2];
+  for (int i = 0; i < 2; i++) {
+    TEST_ASSERT_EQUAL(0, pthread_create(&consumers[i], NULL, mpmc_consumer_thread, &queue));
+  }
+  while (rtl_atomic_load(&queue.consumers_waiting) < 2) {
+    sched_yield();
+  }
+  const uint32_t values[2] = { 10, 20 };
+  rtl_mpmc_push(&queue, &values[0]);
+  rtl_mpmc_push(&queue, &values[1]);
+
+  uintptr_t sum = 0;
+  for (int i = 0; i < 2; i++) {
+    void* result;
+    TEST_ASSERT_EQUAL(0, pthread_join(consumers[i], &result));
+    sum += (uintptr_t)result;
+  }
+  TEST_ASSERT_EQUAL(11 + 21, sum);
+
+  rtl_mpmc_cleanup(&queue);
+}
+#endif
+
+// Test that the cells are allocated under the queue memory tag
+void test_mpmc_memory_tag(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_mpmc_t queue;
+  TEST_ASSERT_TRUE(rtl_mpmc_init(&queue, 16, sizeof(uint64_t)));
+
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL(16 * (sizeof(rtl_atomic_word_t) + sizeof(uint64_t)), stats.bytes);
+
+  rtl_mpmc_cleanup(&queue);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+}
+
+// Skip list tests
+
+static int skiplist_compare_u64(const void* key1, const void* key2)
+{
+  const uint64_t a = *(const uint64_t*)key1;
+  const uint64_t b = *(const uint64_t*)key2;
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static bool skiplist_collect(const void* key, void* value, void* user_data)
+{
+  uint64_t* keys = (uint64_t*)user_data;
+  keys[keys[0] + 1] = *(const uint64_t*)key;
+  keys[0]++;
+  (void)value;
+  return keys[0] < 8;
+}
+
+// Test insert, lookup and removal, including duplicates and missing keys
+void test_skiplist_insert_find_remove(void)
+{
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t thread;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &thread);
+
+  rtl_skiplist_t list;
+  TEST_ASSERT_TRUE(rtl_skiplist_init(&list, sizeof(uint64_t), skiplist_compare_u64));
+
+  static int values[200];
+  for (uint64_t i = 0; i < 200; i++) {
+    const uint64_t key = (i * 37) % 200;
+    TEST_ASSERT_TRUE(rtl_skiplist_insert(&list, &thread, &key, &values[key]));
+  }
+  const uint64_t duplicate = 42;
+  TEST_ASSERT_FALSE(rtl_skiplist_insert(&list, &thread, &duplicate, NULL));
+
+  void* value = NULL;
+  TEST_ASSERT_TRUE(rtl_skiplist_find(&list, &thread, &duplicate, &value));
+  TEST_ASSERT_EQUAL_PTR(&values[42], value);
+
+  const uint64_t missing = 1000;
+  TEST_ASSERT_FALSE(rtl_skiplist_find(&list, &thread, &missing, NULL));
+  TEST_ASSERT_FALSE(rtl_skiplist_remove(&list, &thread, &missing, NULL));
+
+  for (uint64_t key = 0; key < 200; key += 2) {
+    TEST_ASSERT_TRUE(rtl_skiplist_remove(&list, &thread, &key, &value));
+    TEST_ASSERT_EQUAL_PTR(&values[key], value);
+  }
+  for (uint64_t key = 0; key < 200; key++) {
+    TEST_ASSERT_EQUAL(key % 2 == 1, rtl_skiplist_find(&list, &thread, &key, NULL));
+  }
+
+  // A removed key can be inserted again
+  TEST_ASSERT_TRUE(rtl_skiplist_insert(&list, &thread, &duplicate, &values[0]));
+  TEST_ASSERT_TRUE(rtl_skiplist_find(&list, &thread, &duplicate, &value));
+  TEST_ASSERT_EQUAL_PTR(&values[0], value);
+
+  rtl_skiplist_cleanup(&list);
+  rtl_ebr_thread_unregister(&thread);
+  rtl_ebr_cleanup(&ebr);
+}
+
+// Test range iteration bounds, ordering and early stop
+void test_skiplist_range(void)
+{
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t thread;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &thread);
+
+  rtl_skiplist_t list;
+  TEST_ASSERT_TRUE(rtl_skiplist_init(&list, sizeof(uint64_t), skiplist_compare_u64));
+  for (uint64_t i = 20; i > 0; i--) {
+    const uint64_t key = i * 10;
+    TEST_ASSERT_TRUE(rtl_skiplist_insert(&list, &thread, &key, NULL));
+  }
+
+  // [35, 80) holds 40, 50, 60 and 70
+  uint64_t keys[10] = { 0 };
+  const uint64_t from = 35;
+  const uint64_t to = 80;
+  TEST_ASSERT_EQUAL(4, rtl_skiplist_for_each_range(&list, &thread, &from, &to,
+    skiplist_collect, keys));
+  TEST_ASSERT_EQUAL(4, keys[0]);
+  TEST_ASSERT_EQUAL(40, keys[1]);
+  TEST_ASSERT_EQUAL(70, keys[4]);
+
+  // Unbounded, the callback stops after 8 keys
+  memset(keys, 0, sizeof(keys));
+  TEST_ASSERT_EQUAL(8, rtl_skiplist_for_each_range(&list, &thread, NULL, NULL,
+    skiplist_collect, keys));
+  for (uint64_t i = 0; i < 8; i++) {
+    TEST_ASSERT_EQUAL((i + 1) * 10, keys[i + 1]);
+  }
+
+  rtl_skiplist_cleanup(&list);
+  rtl_ebr_thread_unregister(&thread);
+  rtl_ebr_cleanup(&ebr);
+}
+
+// Test that removed nodes are reclaimed and cleanup frees the rest
+void test_skiplist_reclaim(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_ebr_t ebr;
+  rtl_ebr_thread_t thread;
+  rtl_ebr_init(&ebr);
+  rtl_ebr_thread_register(&ebr, &thread);
+
+  rtl_skiplist_t list;
+  TEST_ASSERT_TRUE(rtl_skiplist_init(&list, sizeof(uint64_t), skiplist_compare_u64));
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_SKIPLIST, &stats);
+  const size_t empty_bytes = stats.bytes;
+
+  for (uint64_t key = 0; key < 100; key++) {
+    TEST_ASSERT_TRUE(rtl_skiplist_insert(&list, &thread, &key, NULL));
+  }
+  for (uint64_t key = 0; key < 100; key++) {
+    TEST_ASSERT_TRUE(rtl_skiplist_remove(&list, &thread, &key, NULL));
+  }
+
+  unsigned long pending = 1;
+  for (int i = 0; i < 3 && pending != 0; i++) {
+    pending = rtl_ebr_flush(&thread);
+  }
+  TEST_ASSERT_EQUAL(0, pending);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_SKIPLIST, &stats);
+  TEST_ASSERT_EQUAL(empty_bytes, stats.bytes);
+  TEST_ASSERT_EQUAL_STRING("skiplist", rtl_memory_tag_name(RTL_MEM_TAG_SKIPLIST));
+
+  rtl_skiplist_cleanup(&list);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_SKIPLIST, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+
+  rtl_ebr_thread_unregister(&thread);
+  rtl_ebr_cleanup(&ebr);
+}
+
+#if defined(__linux__)
+#define SKIPLIST_THREAD_COUNT 4
+#define SKIPLIST_THREAD_KEYS  256
+#define SKIPLIST_THREAD_OPS   20000
+
+// Per-thread argument: successful inserts minus removes per key, and value errors
+typedef struct test_skiplist_worker
+{
+  rtl_skiplist_t* list;
+  rtl_ebr_t* ebr;
+  uint32_t seed;
+  long net[SKIPLIST_THREAD_KEYS];
+  int errors;
+} test_skiplist_worker_t;
+
+static test_skiplist_worker_t g_skiplist_workers[SKIPLIST_THREAD_COUNT];
+
+static void* skiplist_worker_thread(void* arg)
+{
+  test_skiplist_worker_t* worker = arg;
+  rtl_ebr_thread_t thread;
+  rtl_ebr_thread_register(worker->ebr, &thread);
+
+  uint32_t random = worker->seed;
+  for (int i = 0; i < SKIPLIST_THREAD_OPS; i++) {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    const uint64_t key = random % SKIPLIST_THREAD_KEYS;
+
+    void* value = NULL;
+    switch ((random >> 16) % 3) {
+      case 0:
+        if (rtl_skiplist_insert(worker->list, &thread, &key, (void*)(uintptr_t)(key + 1))) {
+          worker->net[key]++;
+        }
+        break;
+      case 1:
+        if (rtl_skiplist_remove(worker->list, &thread, &key, &value)) {
+          worker->net[key]--;
+          worker->errors += (uintptr_t)value != key + 1;
+        }
+        break;
+      default:
+        if (rtl_skiplist_find(worker->list, &thread, &key, &value)) {
+          worker->errors += (uintptr_t)value != key + 1;
+        }
+        break;
+    }
+    if (i % 256 == 0) {
+      sched_yield();
+    }
+  }
+
+  rtl_ebr_thread_unregister(&thread);
+  return NULL;
+}
+
+// Test concurrent inserts, removes and finds, then that every node is freed exactly once
+void test_skiplist_threads(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_ebr_t ebr;
+  rtl_ebr_init(&ebr);
+
+  rtl_skiplist_t list;
+  TEST_ASSERT_TRUE(rtl_skiplist_init(&list, sizeof(uint64_t), skiplist_compare_u64));
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_SKIPLIST, &stats);
+  const size_t empty_allocations = stats.allocations;
+
+  pthread_t threads[SKIPLIST_THREAD_COUNT];
+  for (int i = 0; i < SKIPLIST_THREAD_COUNT; i++) {
+    memset(&g_skiplist_workers[i], 0, sizeof(test_skiplist_worker_t));
+    g_skiplist_workers[i].list = &list;
+    g_skiplist_workers[i].ebr = &ebr;
+    g_skiplist_workers[i].seed = (uint32_t)i * 7919 + 1;
+    TEST_ASSERT_EQUAL(
+      0, pthread_create(&threads[i], NULL, skiplist_worker_thread, &g_skiplist_workers[i]));
+  }
+  for (int i = 0; i < SKIPLIST_THREAD_COUNT; i++) {
+    TEST_ASSERT_EQUAL(0, pthread_join(threads[i], NULL));
+    TEST_ASSERT_EQUAL(0, g_skiplist_workers[i].errors);
+  }
+
+  // Every key is present exactly when its inserts outnumber its removes
+  rtl_ebr_thread_t thread;
+  rtl_ebr_thread_register(&ebr, &thread);
+  size_t present = 0;
+  for (uint64_t key = 0; key < SKIPLIST_THREAD_KEYS; key++) {
+    long net = 0;
+    for (int i = 0; i < SKIPLIST_THREAD_COUNT; i++) {
+      net += g_skiplist_workers[i].net[key];
+    }
+    TEST_ASSERT_TRUE(net == 0 || net == 1);
+    TEST_ASSERT_EQUAL(net == 1, rtl_skiplist_find(&list, &thread, &key, NULL));
+    present += (size_t)net;
+  }
+
+  // Once retired nodes are flushed only live nodes remain: a leaked node would
+  // show up as an extra allocation, a double retirement as a missing one
+  unsigned long pending = 1;
+  for (int i = 0; i < 3 && pending != 0; i++) {
+    pending = rtl_ebr_flush(&thread);
+  }
+  TEST_ASSERT_EQUAL(0, pending);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_SKIPLIST, &stats);
+  TEST_ASSERT_EQUAL(empty_allocations + present, stats.allocations);
+
+  rtl_skiplist_cleanup(&list);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_SKIPLIST, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+  TEST_ASSERT_EQUAL(0, stats.allocations);
+
+  rtl_ebr_thread_unregister(&thread);
+  rtl_ebr_cleanup(&ebr);
+}
+#endif
+
+// Red-black tree tests
+
+typedef struct rbtree_item_t
+{
+  int key;
+  int order;
+  rtl_rb_node_t node;
+} rbtree_item_t;
+
+static int rbtree_item_compare(const rtl_rb_node_t* a, const rtl_rb_node_t* b)
+{
+  const int ka = RTL_CONTAINER_OF(a, rbtree_item_t, node)->key;
+  const int kb = RTL_CONTAINER_OF(b, rbtree_item_t, node)->key;
+  return ka < kb ? -1 : (ka > kb ? 1 : 0);
+}
+
+static int rbtree_key_compare(const void* key, const rtl_rb_node_t* node)
+{
+  const int k = *(const int*)key;
+  const int nk = RTL_CONTAINER_OF(node, rbtree_item_t, node)->key;
+  return k < nk ? -1 : (k > nk ? 1 : 0);
+}
+
+// Returns the black height of a subtree, or -1 if a red-black property is broken
+static int rbtree_check(const rtl_rb_node_t* node, const rtl_rb_node_t* parent)
+{
+  if (!node) {
+    return 1;
+  }
+  if (node->parent != parent || (node->red && parent && parent->red)) {
+    return -1;
+  }
+
+  const int left = rbtree_check(node->left, node);
+  const int right = rbtree_check(node->right, node);
+  if (left < 0 || left != right) {
+    return -1;
+  }
+  return left + (node->red ? 0 : 1);
+}
+
+// Test ordering and balance through scattered inserts and erases
+void test_rbtree_insert_erase(void)
+{
+  static rbtree_item_t items[500];
+  rtl_rbtree_t tree;
+  rtl_rbtree_init(&tree, rbtree_item_compare);
+  TEST_ASSERT_TRUE(rtl_rbtree_empty(&tree));
+  TEST_ASSERT_NULL(rtl_rbtree_first(&tree));
+
+  for (int i = 0; i < 500; i++) {
+    items[i].key = (i * 7919) % 500;
+    rtl_rbtree_insert(&tree, &items[i].node);
+    TEST_ASSERT_TRUE(rbtree_check(tree.root, NULL) > 0);
+  }
+  TEST_ASSERT_EQUAL(0, RTL_CONTAINER_OF(rtl_rbtree_first(&tree), rbtree_item_t, node)->key);
+  TEST_ASSERT_EQUAL(499, RTL_CONTAINER_OF(rtl_rbtree_last(&tree), rbtree_item_t, node)->key);
+
+  // Erase every odd key, checking the cached minimum as the smallest ones go
+  for (int i = 0; i < 500; i++) {
+    if (items[i].key % 2 == 1) {
+      rtl_rbtree_erase(&tree, &items[i].node);
+      TEST_ASSERT_TRUE(rbtree_check(tree.root, NULL) > 0);
+    }
+  }
+  for (int i = 0; i < 500; i++) {
+    if (items[i].key < 100 && items[i].key % 2 == 0) {
+      rtl_rbtree_erase(&tree, &items[i].node);
+    }
+  }
+  TEST_ASSERT_EQUAL(100, RTL_CONTAINER_OF(rtl_rbtree_first(&tree), rbtree_item_t, node)->key);
+
+  rtl_rb_node_t* position;
+  rtl_rb_node_t* n;
+  int expected = 100;
+  rtl_rbtree_for_each(position, &tree) {
+    TEST_ASSERT_EQUAL(expected, RTL_CONTAINER_OF(position, rbtree_item_t, node)->key);
+    expected += 2;
+  }
+  TEST_ASSERT_EQUAL(500, expected);
+
+  // Walk backwards from the end
+  expected = 498;
+  for (position = rtl_rbtree_last(&tree); position; position = rtl_rbtree_prev(position)) {
+    TEST_ASSERT_EQUAL(expected, RTL_CONTAINER_OF(position, rbtree_item_t, node)->key);
+    expected -= 2;
+  }
+
+  rtl_rbtree_for_each_safe(position, n, &tree) {
+    rtl_rbtree_erase(&tree, position);
+  }
+  TEST_ASSERT_TRUE(rtl_rbtree_empty(&tree));
+  TEST_ASSERT_NULL(rtl_rbtree_first(&tree));
+}
+
+// Test lower_bound and that equal keys keep their insertion order
+void test_rbtree_lower_bound(void)
+{
+  rbtree_item_t items[12];
+  rtl_rbtree_t tree;
+  rtl_rbtree_init(&tree, rbtree_item_compare);
+
+  // Keys 0, 10, 20, 30 three times each
+  for (int i = 0; i < 12; i++) {
+    items[i].key = (i % 4) * 10;
+    items[i].order = i;
+    rtl_rbtree_insert(&tree, &items[i].node);
+  }
+
+  int key = 15;
+  rtl_rb_node_t* node = rtl_rbtree_lower_bound(&tree, &key, rbtree_key_compare);
+  TEST_ASSERT_EQUAL_PTR(&items[2].node, node);
+
+  key = 10;
+  node = rtl_rbtree_lower_bound(&tree, &key, rbtree_key_compare);
+  for (int i = 1; i < 12; i += 4) {
+    TEST_ASSERT_EQUAL_PTR(&items[i].node, node);
+    node = rtl_rbtree_next(node);
+  }
+
+  key = 31;
+  TEST_ASSERT_NULL(rtl_rbtree_lower_bound(&tree, &key, rbtree_key_compare));
+  key = -5;
+  TEST_ASSERT_EQUAL_PTR(&items[0].node, rtl_rbtree_lower_bound(&tree, &key, rbtree_key_compare));
+}
+
+// Priority queue tests
+
+typedef struct heap_timer_t
+{
+  int deadline;
+  rtl_pairing_node_t node;
+} heap_timer_t;
+
+static int heap_timer_compare(const rtl_pairing_node_t* a, const rtl_pairing_node_t* b)
+{
+  return RTL_CONTAINER_OF(a, heap_timer_t, node)->deadline -
+    RTL_CONTAINER_OF(b, heap_timer_t, node)->deadline;
+}
+
+static int heap_int_compare(const void* a, const void* b)
+{
+  return *(const int*)a - *(const int*)b;
+}
+
+// Test that a pairing heap pops in order
+void test_pairing_heap_pop_order(void)
+{
+  static heap_timer_t timers[300];
+  rtl_pairing_heap_t heap;
+  rtl_pairing_heap_init(&heap, heap_timer_compare);
+  TEST_ASSERT_TRUE(rtl_pairing_heap_empty(&heap));
+  TEST_ASSERT_NULL(rtl_pairing_heap_pop(&heap));
+
+  for (int i = 0; i < 300; i++) {
+    timers[i].deadline = (i * 131) % 300;
+    rtl_pairing_heap_insert(&heap, &timers[i].node);
+  }
+  TEST_ASSERT_EQUAL(0, RTL_CONTAINER_OF(rtl_pairing_heap_top(&heap), heap_timer_t, node)->deadline);
+
+  for (int i = 0; i < 300; i++) {
+    rtl_pairing_node_t* node = rtl_pairing_heap_pop(&heap);
+    TEST_ASSERT_NOT_NULL(node);
+    TEST_ASSERT_EQUAL(i, RTL_CONTAINER_OF(node, heap_timer_t, node)->deadline);
+  }
+  TEST_ASSERT_TRUE(rtl_pairing_heap_empty(&heap));
+}
+
+// Test decrease-key and removal of nodes deep in a pairing heap
+void test_pairing_heap_decrease_and_remove(void)
+{
+  static heap_timer_t timers[100];
+  rtl_pairing_heap_t heap;
+  rtl_pairing_heap_init(&heap, heap_timer_compare);
+
+  // Deadlines 1000, 1010, ... so decreased keys can go anywhere
+  for (int i = 0; i < 100; i++) {
+    timers[i].deadline = 1000 + i * 10;
+    rtl_pairing_heap_insert(&heap, &timers[i].node);
+  }
+  rtl_pairing_heap_pop(&heap);
+
+  timers[50].deadline = 5;
+  rtl_pairing_heap_decrease_key(&heap, &timers[50].node);
+  timers[70].deadline = 1055;
+  rtl_pairing_heap_decrease_key(&heap, &timers[70].node);
+  rtl_pairing_heap_remove(&heap, &timers[3].node);
+  rtl_pairing_heap_remove(&heap, &timers[99].node);
+
+  TEST_ASSERT_EQUAL_PTR(&timers[50].node, rtl_pairing_heap_pop(&heap));
+
+  int previous = 0;
+  int count = 0;
+  rtl_pairing_node_t* node;
+  while ((node = rtl_pairing_heap_pop(&heap)) != NULL) {
+    heap_timer_t* timer = RTL_CONTAINER_OF(node, heap_timer_t, node);
+    TEST_ASSERT_TRUE(timer->deadline >= previous);
+    TEST_ASSERT_TRUE(timer != &timers[3] && timer != &timers[99]);
+    previous = timer->deadline;
+    count++;
+  }
+  TEST_ASSERT_EQUAL(96, count);
+}
+
+// Test that a 4-ary heap pops in order while growing its storage
+void test_dheap_push_pop(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_dheap_t heap;
+  rtl_dheap_init(&heap, sizeof(int), heap_int_compare);
+  TEST_ASSERT_NULL(rtl_dheap_top(&heap));
+  TEST_ASSERT_FALSE(rtl_dheap_pop(&heap, NULL));
+
+  for (int i = 0; i < 1000; i++) {
+    const int value = (i * 7919) % 1000;
+    TEST_ASSERT_TRUE(rtl_dheap_push(&heap, &value));
+  }
+  TEST_ASSERT_EQUAL(1000, rtl_dheap_size(&heap));
+  TEST_ASSERT_EQUAL(0, *(const int*)rtl_dheap_top(&heap));
+
+  for (int i = 0; i < 1000; i++) {
+    int value;
+    TEST_ASSERT_TRUE(rtl_dheap_pop(&heap, &value));
+    TEST_ASSERT_EQUAL(i, value);
+  }
+  TEST_ASSERT_EQUAL(0, rtl_dheap_size(&heap));
+
+  // The storage is kept for reuse until cleanup
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_TRUE(stats.bytes >= 1000 * sizeof(int));
+  rtl_dheap_cleanup(&heap);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+}
+
+// Test pushing the heap's own top while the push has to grow the storage
+void test_dheap_push_own_top(void)
+{
+  rtl_dheap_t heap;
+  rtl_dheap_init(&heap, sizeof(int), heap_int_compare);
+  TEST_ASSERT_TRUE(rtl_dheap_reserve(&heap, 4));
+
+  for (int i = 4; i > 0; i--) {
+    TEST_ASSERT_TRUE(rtl_dheap_push(&heap, &i));
+  }
+  TEST_ASSERT_EQUAL(heap.capacity, rtl_dheap_size(&heap));
+
+  TEST_ASSERT_TRUE(rtl_dheap_push(&heap, rtl_dheap_top(&heap)));
+  TEST_ASSERT_EQUAL(5, rtl_dheap_size(&heap));
+
+  const int expected[5] = { 1, 1, 2, 3, 4 };
+  for (int i = 0; i < 5; i++) {
+    int value;
+    TEST_ASSERT_TRUE(rtl_dheap_pop(&heap, &value));
+    TEST_ASSERT_EQUAL(expected[i], value);
+  }
+
+  rtl_dheap_cleanup(&heap);
+}
+
+// Deque tests
+
+static bool deque_check_order(unsigned long index, void* item, void* user_data)
+{
+  uintptr_t* expected = (uintptr_t*)user_data;
+  TEST_ASSERT_EQUAL(*expected + index, (uintptr_t)item);
+  return true;
+}
+
+static bool deque_sum_span(void** items, size_t count, void* user_data)
+{
+  uintptr_t* sum = (uintptr_t*)user_data;
+  for (size_t i = 0; i < count; i++) {
+    *sum += (uintptr_t)items[i];
+  }
+  return true;
+}
+
+// Test FIFO and LIFO use across chunk boundaries
+void test_deque_push_pop(void)
+{
+  rtl_deque_t deque;
+  rtl_deque_init(&deque);
+  TEST_ASSERT_TRUE(rtl_deque_empty(&deque));
+  TEST_ASSERT_FALSE(rtl_deque_pop_front(&deque, NULL));
+  TEST_ASSERT_NULL(rtl_deque_front(&deque));
+
+  for (uintptr_t i = 1; i <= 1000; i++) {
+    TEST_ASSERT_TRUE(rtl_deque_push_back(&deque, (void*)i));
+  }
+  TEST_ASSERT_EQUAL(1000, rtl_deque_size(&deque));
+  TEST_ASSERT_EQUAL_PTR((void*)1, rtl_deque_front(&deque));
+  TEST_ASSERT_EQUAL_PTR((void*)1000, rtl_deque_back(&deque));
+
+  void* item;
+  for (uintptr_t i = 1; i <= 500; i++) {
+    TEST_ASSERT_TRUE(rtl_deque_pop_front(&deque, &item));
+    TEST_ASSERT_EQUAL_PTR((void*)i, item);
+  }
+  for (uintptr_t i = 1000; i > 900; i--) {
+    TEST_ASSERT_TRUE(rtl_deque_pop_back(&deque, &item));
+    TEST_ASSERT_EQUAL_PTR((void*)i, item);
+  }
+
+  // Grow the front past its chunk, then drain everything from the back
+  for (uintptr_t i = 500; i > 0; i--) {
+    TEST_ASSERT_TRUE(rtl_deque_push_front(&deque, (void*)i));
+  }
+  TEST_ASSERT_EQUAL(900, rtl_deque_size(&deque));
+  for (uintptr_t i = 900; i > 0; i--) {
+    TEST_ASSERT_TRUE(rtl_deque_pop_back(&deque, &item));
+    TEST_ASSERT_EQUAL_PTR((void*)i, item);
+  }
+  TEST_ASSERT_TRUE(rtl_deque_empty(&deque));
+  TEST_ASSERT_FALSE(rtl_deque_pop_back(&deque, &item));
+
+  rtl_deque_cleanup(&deque);
+}
+
+// Test element and span iteration
+void test_deque_iteration(void)
+{
+  rtl_deque_t deque;
+  rtl_deque_init(&deque);
+  for (uintptr_t i = 100; i < 300; i++) {
+    TEST_ASSERT_TRUE(rtl_deque_push_back(&deque, (void*)i));
+  }
+  for (uintptr_t i = 99; i >= 50; i--) {
+    TEST_ASSERT_TRUE(rtl_deque_push_front(&deque, (void*)i));
+  }
+
+  uintptr_t first = 50;
+  rtl_deque_for_each(&deque, deque_check_order, &first);
+
+  uintptr_t sum = 0;
+  rtl_deque_for_each_span(&deque, deque_sum_span, &sum);
+  TEST_ASSERT_EQUAL((50 + 299) * 250 / 2, sum);
+
+  rtl_deque_cleanup(&deque);
+}
+
+// Test that emptied chunks are recycled and cleanup frees them all
+void test_deque_chunk_recycling(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_deque_t deque;
+  rtl_deque_init(&deque);
+
+  for (uintptr_t i = 0; i < 10 * RTL_DEQUE_CHUNK_SIZE; i++) {
+    TEST_ASSERT_TRUE(rtl_deque_push_back(&deque, (void*)i));
+  }
+  while (rtl_deque_pop_front(&deque, NULL)) {
+  }
+
+  // One chunk stays linked plus the spares
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL((1 + RTL_DEQUE_SPARE_CHUNKS) * sizeof(rtl_deque_chunk_t), stats.bytes);
+
+  // Refilling within the kept chunks draws on the spares
+  TEST_ASSERT_EQUAL(1 + RTL_DEQUE_SPARE_CHUNKS, stats.allocations);
+  for (uintptr_t i = 0; i < 2 * RTL_DEQUE_CHUNK_SIZE; i++) {
+    TEST_ASSERT_TRUE(rtl_deque_push_back(&deque, (void*)i));
+  }
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL(1 + RTL_DEQUE_SPARE_CHUNKS, stats.allocations);
+
+  rtl_deque_cleanup(&deque);
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_QUEUE, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+}
+
+// Index list tests
+
+typedef struct ilist_record_t
+{
+  int value;
+  rtl_ilist_entry_t link;
+} ilist_record_t;
+
+// Test adding, removing and iterating nodes linked by index
+void test_ilist_add_remove(void)
+{
+  ilist_record_t records[16];
+  rtl_ilist_pool_t pool;
+  rtl_ilist_pool_init(&pool, records, sizeof(ilist_record_t), offsetof(ilist_record_t, link));
+  TEST_ASSERT_EQUAL(8, sizeof(rtl_ilist_entry_t));
+
+  rtl_ilist_t list;
+  rtl_ilist_init(&list, &pool);
+  TEST_ASSERT_TRUE(rtl_ilist_empty(&list));
+  TEST_ASSERT_EQUAL(RTL_ILIST_NIL, rtl_ilist_pop_head(&list));
+
+  // 0 1 2 3 4 at the back, then 10 at the front
+  for (uint32_t i = 0; i < 5; i++) {
+    records[i].value = (int)i;
+    rtl_ilist_add_tail(&list, i);
+  }
+  records[10].value = -1;
+  rtl_ilist_add_head(&list, 10);
+  TEST_ASSERT_EQUAL(6, rtl_ilist_length(&list));
+
+  // Remove from the middle and both ends
+  rtl_ilist_remove(&list, 2);
+  rtl_ilist_remove(&list, 10);
+  rtl_ilist_remove(&list, 4);
+
+  const int expected[] = { 0, 1, 3 };
+  uint32_t index;
+  int position = 0;
+  rtl_ilist_for_each(index, &list) {
+    TEST_ASSERT_EQUAL(expected[position++], rtl_ilist_record(&pool, index, ilist_record_t)->value);
+  }
+  TEST_ASSERT_EQUAL(3, position);
+  TEST_ASSERT_EQUAL(3, list.tail);
+  TEST_ASSERT_EQUAL(1, rtl_ilist_prev(&list, 3));
+
+  uint32_t n;
+  rtl_ilist_for_each_safe(index, n, &list) {
+    rtl_ilist_remove(&list, index);
+  }
+  TEST_ASSERT_TRUE(rtl_ilist_empty(&list));
+  TEST_ASSERT_EQUAL(RTL_ILIST_NIL, list.head);
+  TEST_ASSERT_EQUAL(RTL_ILIST_NIL, list.tail);
+}
+
+// Test a free list and a used list sharing one pool
+void test_ilist_free_list(void)
+{
+  ilist_record_t records[8];
+  rtl_ilist_pool_t pool;
+  rtl_ilist_pool_init(&pool, records, sizeof(ilist_record_t), offsetof(ilist_record_t, link));
+
+  rtl_ilist_t free_list;
+  rtl_ilist_t used;
+  rtl_ilist_init(&free_list, &pool);
+  rtl_ilist_init(&used, &pool);
+  for (uint32_t i = 0; i < 8; i++) {
+    rtl_ilist_add_tail(&free_list, i);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    const uint32_t index = rtl_ilist_pop_head(&free_list);
+    TEST_ASSERT_NOT_EQUAL(RTL_ILIST_NIL, index);
+    records[index].value = i * 10;
+    rtl_ilist_add_head(&used, index);
+  }
+  TEST_ASSERT_EQUAL(RTL_ILIST_NIL, rtl_ilist_pop_head(&free_list));
+  TEST_ASSERT_EQUAL(70, rtl_ilist_record(&pool, used.head, ilist_record_t)->value);
+
+  rtl_ilist_remove(&used, 3);
+  rtl_ilist_add_tail(&free_list, 3);
+  TEST_ASSERT_EQUAL(7, rtl_ilist_length(&used));
+  TEST_ASSERT_EQUAL(1, rtl_ilist_length(&free_list));
+}
+
+// Vector tests
+
+static bool vector_count_to_ten(void* element, void* user_data)
+{
+  int* next = (int*)user_data;
+  if (*next >= 10) {
+    return false;
+  }
+  *(int*)element = (*next)++;
+  return true;
+}
+
+// Test push, pop, growth and alignment of the storage
+void test_vector_push_pop(void)
+{
+  rtl_vector_t vector;
+  rtl_vector_init(&vector, sizeof(int));
+  TEST_ASSERT_TRUE(rtl_vector_empty(&vector));
+  TEST_ASSERT_NULL(rtl_vector_data(&vector));
+  TEST_ASSERT_FALSE(rtl_vector_pop_back(&vector, NULL));
+
+  for (int i = 0; i < 1000; i++) {
+    TEST_ASSERT_TRUE(rtl_vector_push_back(&vector, &i));
+  }
+  TEST_ASSERT_EQUAL(1000, rtl_vector_size(&vector));
+  TEST_ASSERT_EQUAL(1024, rtl_vector_capacity(&vector));
+  TEST_ASSERT_EQUAL(0, (uintptr_t)rtl_vector_data(&vector) % RTL_VECTOR_ALIGNMENT);
+  for (int i = 0; i < 1000; i++) {
+    TEST_ASSERT_EQUAL(i, *(int*)rtl_vector_at(&vector, (size_t)i));
+  }
+
+  int value;
+  TEST_ASSERT_TRUE(rtl_vector_pop_back(&vector, &value));
+  TEST_ASSERT_EQUAL(999, value);
+  TEST_ASSERT_EQUAL(999, rtl_vector_size(&vector));
+
+  rtl_vector_cleanup(&vector);
+}
+
+// Test inserting and erasing ranges
+void test_vector_insert_erase(void)
+{
+  rtl_vector_t vector;
+  rtl_vector_init(&vector, sizeof(int));
+
+  const int base[] = { 0, 1, 2, 7, 8, 9 };
+  const int middle[] = { 3, 4, 5, 6 };
+  TEST_ASSERT_TRUE(rtl_vector_append(&vector, base, 6));
+  TEST_ASSERT_TRUE(rtl_vector_insert(&vector, 3, middle, 4));
+  TEST_ASSERT_EQUAL(10, rtl_vector_size(&vector));
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_EQUAL(i, *(int*)rtl_vector_at(&vector, (size_t)i));
+  }
+
+  // Insert at the front, then erase from the middle and the end
+  const int front = -1;
+  TEST_ASSERT_TRUE(rtl_vector_insert(&vector, 0, &front, 1));
+  rtl_vector_erase(&vector, 3, 5);
+  rtl_vector_erase(&vector, 4, 2);
+
+  const int expected[] = { -1, 0, 1, 7 };
+  TEST_ASSERT_EQUAL(4, rtl_vector_size(&vector));
+  TEST_ASSERT_EQUAL_MEMORY(expected, rtl_vector_data(&vector), sizeof(expected));
+
+  rtl_vector_erase(&vector, 0, 0);
+  TEST_ASSERT_TRUE(rtl_vector_insert(&vector, 4, NULL, 0));
+  TEST_ASSERT_EQUAL(4, rtl_vector_size(&vector));
+
+  rtl_vector_cleanup(&vector);
+}
+
+// Test appending and inserting ranges taken from the vector itself
+void test_vector_self_insert(void)
+{
+  rtl_vector_t vector;
+  rtl_vector_init(&vector, sizeof(int));
+
+  // Appending the whole vector to itself forces a reallocation of the source
+  const int base[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  TEST_ASSERT_TRUE(rtl_vector_append(&vector, base, 8));
+  TEST_ASSERT_TRUE(rtl_vector_shrink(&vector));
+  TEST_ASSERT_TRUE(rtl_vector_append(&vector, rtl_vector_data(&vector), 8));
+  TEST_ASSERT_EQUAL(16, rtl_vector_size(&vector));
+  for (int i = 0; i < 16; i++) {
+    TEST_ASSERT_EQUAL(i % 8, *(int*)rtl_vector_at(&vector, (size_t)i));
+  }
+
+  // Insert 2 3 4 5 before index 4, the source straddles the insertion point
+  rtl_vector_erase(&vector, 8, 8);
+  TEST_ASSERT_TRUE(rtl_vector_insert(&vector, 4, rtl_vector_at(&vector, 2), 4));
+  const int straddle[] = { 0, 1, 2, 3, 2, 3, 4, 5, 4, 5, 6, 7 };
+  TEST_ASSERT_EQUAL(12, rtl_vector_size(&vector));
+  TEST_ASSERT_EQUAL_MEMORY(straddle, rtl_vector_data(&vector), sizeof(straddle));
+
+  // Insert the last two elements at the front, the source moves up
+  TEST_ASSERT_TRUE(rtl_vector_insert(&vector, 0, rtl_vector_at(&vector, 10), 2));
+  TEST_ASSERT_EQUAL(6, *(int*)rtl_vector_at(&vector, 0));
+  TEST_ASSERT_EQUAL(7, *(int*)rtl_vector_at(&vector, 1));
+  TEST_ASSERT_EQUAL(0, *(int*)rtl_vector_at(&vector, 2));
+
+  // Push one of our own elements while the storage is full
+  TEST_ASSERT_TRUE(rtl_vector_shrink(&vector));
+  TEST_ASSERT_TRUE(rtl_vector_push_back(&vector, rtl_vector_at(&vector, 0)));
+  TEST_ASSERT_EQUAL(6, *(int*)rtl_vector_at(&vector, 14));
+
+  rtl_vector_cleanup(&vector);
+}
+
+// Test reserve, shrink and bulk append from an iterator
+void test_vector_reserve_shrink_iter(void)
+{
+  rtl_memory_tag_stats_t stats;
+  rtl_vector_t vector;
+  rtl_vector_init(&vector, sizeof(int));
+
+  TEST_ASSERT_TRUE(rtl_vector_reserve(&vector, 100));
+  TEST_ASSERT_EQUAL(100, rtl_vector_capacity(&vector));
+  TEST_ASSERT_TRUE(rtl_vector_reserve(&vector, 10));
+  TEST_ASSERT_EQUAL(100, rtl_vector_capacity(&vector));
+
+  int next = 0;
+  TEST_ASSERT_TRUE(rtl_vector_append_iter(&vector, vector_count_to_ten, &next, 10));
+  TEST_ASSERT_EQUAL(10, rtl_vector_size(&vector));
+  TEST_ASSERT_EQUAL(9, *(int*)rtl_vector_at(&vector, 9));
+
+  TEST_ASSERT_TRUE(rtl_vector_shrink(&vector));
+  TEST_ASSERT_EQUAL(10, rtl_vector_capacity(&vector));
+  TEST_ASSERT_EQUAL(0, (uintptr_t)rtl_vector_data(&vector) % RTL_VECTOR_ALIGNMENT);
+  TEST_ASSERT_EQUAL(5, *(int*)rtl_vector_at(&vector, 5));
+
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_VECTOR, &stats);
+  TEST_ASSERT_EQUAL(1, stats.allocations);
+  TEST_ASSERT_EQUAL_STRING("vector", rtl_memory_tag_name(RTL_MEM_TAG_VECTOR));
+
+  // An empty vector gives its storage back
+  rtl_vector_clear(&vector);
+  TEST_ASSERT_TRUE(rtl_vector_shrink(&vector));
+  TEST_ASSERT_NULL(rtl_vector_data(&vector));
+  rtl_memory_tag_get_stats(RTL_MEM_TAG_VECTOR, &stats);
+  TEST_ASSERT_EQUAL(0, stats.bytes);
+
+  rtl_vector_cleanup(&vector);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+
+  // Assert tests
+  RUN_TEST(test_rtl_assert_success);
+
+  // Memory tests
+  RUN_TEST(test_memory_allocation);
+  RUN_TEST(test_zero_allocation);
+  RUN_TEST(test_multiple_allocations);
+  RUN_TEST(test_different_sizes);
+  RUN_TEST(test_reallocation_after_free);
+  RUN_TEST(test_memory_stress);
+  RUN_TEST(test_custom_allocators);
+
+  // List tests
+  RUN_TEST(test_list_init);
+  RUN_TEST(test_list_first_empty);
+  RUN_TEST(test_list_first_single_element);
+  RUN_TEST(test_list_first_multiple_elements);
+  RUN_TEST(test_list_next_null_current);
+  RUN_TEST(test_list_next_single_element);
+  RUN_TEST(test_list_next_multiple_elements);
+  RUN_TEST(test_list_iteration_with_first_and_next);
+  RUN_TEST(test_list_add_head);
+  RUN_TEST(test_list_add_tail);
+  RUN_TEST(test_list_remove_with_iteration);
+  RUN_TEST(test_list_length_empty);
+  RUN_TEST(test_list_length_single_element);
+  RUN_TEST(test_list_length_multiple_elements_head);
+  RUN_TEST(test_list_length_multiple_elements_tail);
+  RUN_TEST(test_list_length_after_remove);
+  RUN_TEST(test_list_length_stress);
+  RUN_TEST(test_list_for_each_indexed_empty);
+  RUN_TEST(test_list_for_each_indexed_single_element);
+  RUN_TEST(test_list_for_each_indexed_multiple_elements);
+  RUN_TEST(test_list_for_each_indexed_head_insertion_order);
+  RUN_TEST(test_list_for_each_indexed_stress);
+  RUN_TEST(test_list_for_each_callback_empty);
+  RUN_TEST(test_list_for_each_callback_null_callback);
+  RUN_TEST(test_list_for_each_callback_single_element);
+  RUN_TEST(test_list_for_each_callback_multiple_elements);
+  RUN_TEST(test_list_for_each_callback_early_stop);
+  RUN_TEST(test_list_for_each_callback_user_data);
+
+  // Hash table tests
+  RUN_TEST(test_hash_table_init_cleanup);
+  RUN_TEST(test_hash_table_insert);
+  RUN_TEST(test_hash_table_find);
+  RUN_TEST(test_hash_table_update);
+  RUN_TEST(test_hash_table_remove);
+  RUN_TEST(test_hash_table_multiple_entries);
+  RUN_TEST(test_hash_table_string_keys);
+  RUN_TEST(test_hash_table_collisions);
+  RUN_TEST(test_hash_table_load_factor);
+  RUN_TEST(test_hash_table_different_value_sizes);
+  RUN_TEST(test_hash_fnv1a_function);
+  RUN_TEST(test_hash_key_compare_functions);
+
+  // Page tests
+  RUN_TEST(test_page_alloc_free);
+  RUN_TEST(test_page_alloc_huge);
+  RUN_TEST(test_huge_malloc_sizes);
+  RUN_TEST(test_huge_malloc_hash_table);
+
+  // Virtual memory buffer tests
+  RUN_TEST(test_vmbuf_push_stable);
+  RUN_TEST(test_vmbuf_reservation_limit);
+  RUN_TEST(test_vmbuf_shrink);
+
+  // Epoch-based reclamation tests
+  RUN_TEST(test_ebr_retire_and_flush);
+  RUN_TEST(test_ebr_active_reader_blocks);
+  RUN_TEST(test_ebr_batches);
+  RUN_TEST(test_ebr_nesting_and_orphans);
+#if defined(__linux__)
+  RUN_TEST(test_ebr_threads);
+#endif
+
+  // Hazard pointer tests
+  RUN_TEST(test_hazard_retire_and_scan);
+  RUN_TEST(test_hazard_protect_blocks);
+  RUN_TEST(test_hazard_scan_threshold);
+  RUN_TEST(test_hazard_orphans);
+  RUN_TEST(test_reclaim_interface);
+
+  // Scratch allocator tests
+  RUN_TEST(test_scratch_push_pop);
+  RUN_TEST(test_scratch_nested_markers);
+  RUN_TEST(test_scratch_overflow);
+
+  // Memory tag tests
+  RUN_TEST(test_memory_tag_accounting);
+  RUN_TEST(test_memory_tag_limits);
+  RUN_TEST(test_hash_table_tag_limit);
+
+  // Memory pressure tests
+  RUN_TEST(test_memory_soft_limit_callbacks);
+  RUN_TEST(test_memory_pressure_on_failure);
+  RUN_TEST(test_memory_read_cgroup);
+
+  // Buddy allocator tests
+  RUN_TEST(test_buddy_alloc_alignment);
+  RUN_TEST(test_buddy_coalescing);
+  RUN_TEST(test_buddy_exhaustion);
+  RUN_TEST(test_buddy_malloc_hooks);
+
+  // Allocation trace tests
+  RUN_TEST(test_trace_records);
+  RUN_TEST(test_trace_buffer_flush);
+
+  // Static storage hash table tests
+  RUN_TEST(test_hash_table_static_no_alloc);
+  RUN_TEST(test_hash_table_static_full);
+  RUN_TEST(test_hash_table_static_capacity);
+  RUN_TEST(test_hash_table_static_storage_too_small);
+
+  // Counted list tests
+  RUN_TEST(test_counted_list_length);
+  RUN_TEST(test_counted_list_iteration);
+  RUN_TEST(test_counted_list_pop_head);
+
+  // List sort tests
+  RUN_TEST(test_list_sort_trivial);
+  RUN_TEST(test_list_sort_stable);
+  RUN_TEST(test_list_sort_reversed);
+  RUN_TEST(test_list_merge);
+
+  // List splice tests
+  RUN_TEST(test_list_splice);
+  RUN_TEST(test_list_cut_position);
+  RUN_TEST(test_list_replace_init);
+
+  // Prefetching iteration tests
+  RUN_TEST(test_list_for_each_prefetch);
+  RUN_TEST(test_list_for_each_safe_prefetch);
+  RUN_TEST(test_list_for_each_callback_prefetch);
+
+  // MPSC queue tests
+  RUN_TEST(test_mpsc_fifo);
+  RUN_TEST(test_mpsc_interleaved);
+#if defined(__linux__)
+  RUN_TEST(test_mpsc_threads);
+#endif
+
+  // Lock-free stack tests
+  RUN_TEST(test_lfstack_lifo);
+  RUN_TEST(test_lfstack_pop_all);
+#if defined(__linux__)
+  RUN_TEST(test_lfstack_threads);
+#endif
+
+  // SPSC ring tests
+  RUN_TEST(test_spsc_push_pop);
+  RUN_TEST(test_spsc_batch);
+#if defined(__linux__)
+  RUN_TEST(test_spsc_threads);
+#endif
+  RUN_TEST(test_spsc_memory_tag);
+
+  // MPMC queue tests
+  RUN_TEST(test_mpmc_try_push_pop);
+  RUN_TEST(test_mpmc_blocking);
+#if defined(__linux__)
+  RUN_TEST(test_mpmc_blocking_threads);
+#endif
+  RUN_TEST(test_mpmc_memory_tag);
+
+  // Skip list tests
+  RUN_TEST(test_skiplist_insert_find_remove);
+  RUN_TEST(test_skiplist_range);
+  RUN_TEST(test_skiplist_reclaim);
+#if defined(__linux__)
+  RUN_TEST(test_skiplist_threads);
+#endif
+
+  // Red-black tree tests
+  RUN_TEST(test_rbtree_insert_erase);
+  RUN_TEST(test_rbtree_lower_bound);
+
+  // Priority queue tests
+  RUN_TEST(test_pairing_heap_pop_order);
+  RUN_TEST(test_pairing_heap_decrease_and_remove);
+  RUN_TEST(test_dheap_push_pop);
+  RUN_TEST(test_dheap_push_own_top);
+
+  // Deque tests
+  RUN_TEST(test_deque_push_pop);
+  RUN_TEST(test_deque_iteration);
+  RUN_TEST(test_deque_chunk_recycling);
+
+  // Index list tests
+  RUN_TEST(test_ilist_add_remove);
+  RUN_TEST(test_ilist_free_list);
+
+  // Vector tests
+  RUN_TEST(test_vector_push_pop);
+  RUN_TEST(test_vector_insert_erase);
+  RUN_TEST(test_vector_self_insert);
+  RUN_TEST(test_vector_reserve_shrink_iter);
 
   return UNITY_END();
 }
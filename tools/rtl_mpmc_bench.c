@@ -0,0 +1,175 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+// Measures rtl_mpmc throughput across producer/consumer thread counts.
+//
+// Usage: rtl_mpmc_bench [items] [capacity]
+//
+// Every configuration moves the same number of 64-bit items through one queue
+// with the blocking push/pop calls and reports items per second.
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "rtl.h"
+#include "rtl_mpmc.h"
+
+/**
+ * @brief Default number of items moved per configuration.
+ */
+#define BENCH_DEFAULT_ITEMS 4000000UL
+
+/**
+ * @brief Default queue capacity.
+ */
+#define BENCH_DEFAULT_CAPACITY 1024UL
+
+/**
+ * @brief Highest thread count on either side.
+ */
+#define BENCH_MAX_THREADS 8
+
+/**
+ * @brief Work assigned to one thread.
+ */
+typedef struct bench_worker_t
+{
+  rtl_mpmc_t* queue; /**< Queue under test */
+  uint64_t first;    /**< First value a producer pushes */
+  uint64_t count;    /**< Number of items to push or pop */
+  uint64_t sum;      /**< Sum of the popped values, checked after the run */
+} bench_worker_t;
+
+static double bench_seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static void* bench_producer(void* arg)
+{
+  bench_worker_t* worker = (bench_worker_t*)arg;
+  for (uint64_t i = 0; i < worker->count; i++) {
+    const uint64_t value = worker->first + i;
+    rtl_mpmc_push(worker->queue, &value);
+  }
+  return NULL;
+}
+
+static void* bench_consumer(void* arg)
+{
+  bench_worker_t* worker = (bench_worker_t*)arg;
+  for (uint64_t i = 0; i < worker->count; i++) {
+    uint64_t value;
+    rtl_mpmc_pop(worker->queue, &value);
+    worker->sum += value;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Runs one configuration and prints a report line.
+ * @return true if every pushed item was popped exactly once.
+ */
+static bool bench_run(unsigned producers, unsigned consumers, uint64_t items, size_t capacity)
+{
+  rtl_mpmc_t queue;
+  if (!rtl_mpmc_init(&queue, capacity, sizeof(uint64_t))) {
+    fprintf(stderr, "Cannot allocate a queue of %lu items\n", (unsigned long)capacity);
+    return false;
+  }
+
+  bench_worker_t producer_work[BENCH_MAX_THREADS] = { { 0 } };
+  bench_worker_t consumer_work[BENCH_MAX_THREADS] = { { 0 } };
+  pthread_t threads[2 * BENCH_MAX_THREADS];
+
+  // Spread the items so the remainder goes to the first threads
+  uint64_t first = 0;
+  for (unsigned i = 0; i < producers; i++) {
+    producer_work[i].queue = &queue;
+    producer_work[i].first = first;
+    producer_work[i].count = items / producers + (i < items % producers ? 1 : 0);
+    first += producer_work[i].count;
+  }
+  for (unsigned i = 0; i < consumers; i++) {
+    consumer_work[i].queue = &queue;
+    consumer_work[i].count = items / consumers + (i < items % consumers ? 1 : 0);
+  }
+
+  const double start = bench_seconds();
+  for (unsigned i = 0; i < consumers; i++) {
+    pthread_create(&threads[i], NULL, bench_consumer, &consumer_work[i]);
+  }
+  for (unsigned i = 0; i < producers; i++) {
+    pthread_create(&threads[consumers + i], NULL, bench_producer, &producer_work[i]);
+  }
+  for (unsigned i = 0; i < producers + consumers; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  const double elapsed = bench_seconds() - start;
+
+  uint64_t sum = 0;
+  for (unsigned i = 0; i < consumers; i++) {
+    sum += consumer_work[i].sum;
+  }
+  rtl_mpmc_cleanup(&queue);
+
+  const bool valid = sum == items * (items - 1) / 2;
+  printf("%9u %9u %14.0f %9s\n", producers, consumers,
+    elapsed > 0 ? (double)items / elapsed : 0.0, valid ? "ok" : "MISMATCH");
+  return valid;
+}
+
+int main(int argc, char** argv)
+{
+  const uint64_t items = argc > 1 ? strtoull(argv[1], NULL, 10) : BENCH_DEFAULT_ITEMS;
+  const size_t capacity = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : BENCH_DEFAULT_CAPACITY;
+  if (items == 0 || capacity == 0) {
+    fprintf(stderr, "Usage: %s [items] [capacity]\n", argv[0]);
+    return 1;
+  }
+
+  static const unsigned counts[][2] = {
+    { 1, 1 }, { 1, 4 }, { 4, 1 }, { 2, 2 }, { 4, 4 }, { 8, 8 },
+  };
+
+  printf("%lu items, capacity %lu\n", (unsigned long)items, (unsigned long)capacity);
+  printf("%9s %9s %14s %9s\n", "producers", "consumers", "items/s", "check");
+
+  rtl_init(NULL, NULL);
+  bool valid = true;
+  for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+    valid = bench_run(counts[i][0], counts[i][1], items, capacity) && valid;
+  }
+  rtl_cleanup();
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,598 @@
+// MIT License
+//
+// Copyright (c) 2025 Vladislav Belousov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// Replays an allocation trace recorded with rtl_trace_start() against several
+// allocator backends and reports throughput, memory use and fragmentation.
+//
+// Usage: rtl_replay <trace file> [backend...]
+//
+// Records are replayed in file order on a single thread. Each backend runs in a
+// forked child so heap state doesn't leak from one backend into the next.
+//
+// Memory is reported two ways. The RSS column is the peak growth of the current
+// resident set over the run, measured the same way for every backend. The held
+// column is what the backend itself reports holding, which for malloc comes from
+// mallinfo2() where glibc provides it. Both are sampled after each run of
+// allocations, where they peak, and the sampling is left out of the timing.
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define REPLAY_HAVE_MALLINFO2 1
+#endif
+
+#include "rtl_buddy.h"
+#include "rtl_page.h"
+#include "rtl_trace.h"
+#include "rtl_vmbuf.h"
+
+/**
+ * @brief Alignment of every block handed out by the replay backends.
+ */
+#define REPLAY_ALIGNMENT 16
+
+/**
+ * @brief Size classes of the slab backend, powers of two from 16 bytes.
+ */
+#define REPLAY_SLAB_CLASSES 12
+
+/**
+ * @brief A trace event with its block resolved to a dense slot.
+ */
+typedef struct replay_op_t
+{
+  uint32_t slot; /**< Index into the live block table */
+  uint32_t op;   /**< rtl_trace_op_t */
+  size_t size;   /**< Requested size of the block */
+} replay_op_t;
+
+/**
+ * @brief A loaded trace.
+ */
+typedef struct replay_trace_t
+{
+  replay_op_t* ops;   /**< Events in replay order */
+  size_t op_count;    /**< Number of events */
+  size_t slot_count;  /**< Number of slots needed to hold every live block */
+  size_t total_bytes; /**< Sum of all allocation sizes */
+  size_t peak_live;   /**< Highest number of live bytes */
+} replay_trace_t;
+
+/**
+ * @brief Allocator backend under test.
+ */
+typedef struct replay_backend_t
+{
+  const char* name;
+  bool (*init)(const replay_trace_t* trace);
+  void* (*alloc)(size_t size);
+  void (*free)(void* ptr, size_t size);
+  size_t (*footprint)(void); /**< Bytes held by the backend, NULL if it can't tell */
+  void (*cleanup)(void);
+} replay_backend_t;
+
+// System malloc backend
+
+static bool replay_malloc_init(const replay_trace_t* trace)
+{
+  (void)trace;
+  return true;
+}
+
+static void* replay_malloc_alloc(size_t size)
+{
+  return malloc(size);
+}
+
+static void replay_malloc_free(void* ptr, size_t size)
+{
+  (void)size;
+  free(ptr);
+}
+
+#ifdef REPLAY_HAVE_MALLINFO2
+static size_t replay_malloc_footprint(void)
+{
+  // In-use chunks including their headers, free fastbin chunks that only serve their own size,
+  // and blocks mapped directly for large requests
+  const struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.fsmblks + info.hblkhd;
+}
+#else
+#define replay_malloc_footprint NULL
+#endif
+
+static void replay_malloc_cleanup(void)
+{
+}
+
+// Arena backend: bump allocation over a virtual memory buffer, frees are no-ops
+
+static rtl_vmbuf_t g_arena;
+
+static bool replay_arena_init(const replay_trace_t* trace)
+{
+  return rtl_vmbuf_init(&g_arena, trace->total_bytes + trace->op_count * REPLAY_ALIGNMENT + 1);
+}
+
+static void* replay_arena_alloc(size_t size)
+{
+  return rtl_vmbuf_push(&g_arena, (size + REPLAY_ALIGNMENT - 1) & ~(size_t)(REPLAY_ALIGNMENT - 1));
+}
+
+static void replay_arena_free(void* ptr, size_t size)
+{
+  (void)ptr;
+  (void)size;
+}
+
+static size_t replay_arena_footprint(void)
+{
+  return g_arena.size;
+}
+
+static void replay_arena_cleanup(void)
+{
+  rtl_vmbuf_cleanup(&g_arena);
+}
+
+// Slab backend: power-of-two size classes carved from a virtual memory buffer,
+// each class keeps its own free list, large blocks go to malloc
+
+static rtl_vmbuf_t g_slab;
+static void* g_slab_free[REPLAY_SLAB_CLASSES];
+static size_t g_slab_large_bytes;
+
+static int replay_slab_class(size_t size)
+{
+  int index = 0;
+  while (((size_t)REPLAY_ALIGNMENT << index) < size) {
+    if (++index == REPLAY_SLAB_CLASSES) {
+      return -1;
+    }
+  }
+  return index;
+}
+
+static bool replay_slab_init(const replay_trace_t* trace)
+{
+  memset(g_slab_free, 0, sizeof(g_slab_free));
+  g_slab_large_bytes = 0;
+  return rtl_vmbuf_init(&g_slab, trace->total_bytes * 2 + trace->op_count * REPLAY_ALIGNMENT + 1);
+}
+
+static void* replay_slab_alloc(size_t size)
+{
+  const int index = replay_slab_class(size);
+  if (index < 0) {
+    g_slab_large_bytes += size;
+    return malloc(size);
+  }
+
+  void* block = g_slab_free[index];
+  if (block != NULL) {
+    g_slab_free[index] = *(void**)block;
+    return block;
+  }
+  return rtl_vmbuf_push(&g_slab, (size_t)REPLAY_ALIGNMENT << index);
+}
+
+static void replay_slab_free(void* ptr, size_t size)
+{
+  const int index = replay_slab_class(size);
+  if (index < 0) {
+    g_slab_large_bytes -= size;
+    free(ptr);
+    return;
+  }
+
+  *(void**)ptr = g_slab_free[index];
+  g_slab_free[index] = ptr;
+}
+
+static size_t replay_slab_footprint(void)
+{
+  return g_slab.size + g_slab_large_bytes;
+}
+
+static void replay_slab_cleanup(void)
+{
+  rtl_vmbuf_cleanup(&g_slab);
+}
+
+// Buddy backend: a region four times the peak live size, malloc once it's exhausted
+
+static rtl_buddy_t g_buddy;
+static size_t g_buddy_fallback_bytes;
+
+static bool replay_buddy_init(const replay_trace_t* trace)
+{
+  g_buddy_fallback_bytes = 0;
+  const size_t region = trace->peak_live * 4 > 1024 * 1024 ? trace->peak_live * 4 : 1024 * 1024;
+  return rtl_buddy_init(&g_buddy, region, REPLAY_ALIGNMENT, RTL_PAGE_DEFAULT);
+}
+
+static void* replay_buddy_alloc(size_t size)
+{
+  void* ptr = rtl_buddy_alloc(&g_buddy, size);
+  if (ptr == NULL) {
+    g_buddy_fallback_bytes += size;
+    ptr = malloc(size);
+  }
+  return ptr;
+}
+
+static void replay_buddy_free(void* ptr, size_t size)
+{
+  if (rtl_buddy_owns(&g_buddy, ptr)) {
+    rtl_buddy_free(&g_buddy, ptr);
+  } else {
+    g_buddy_fallback_bytes -= size;
+    free(ptr);
+  }
+}
+
+static size_t replay_buddy_footprint(void)
+{
+  return g_buddy.used + g_buddy_fallback_bytes;
+}
+
+static void replay_buddy_cleanup(void)
+{
+  rtl_buddy_cleanup(&g_buddy);
+}
+
+static const replay_backend_t g_backends[] = {
+  {"malloc", replay_malloc_init, replay_malloc_alloc, replay_malloc_free, replay_malloc_footprint,
+    replay_malloc_cleanup},
+  {"arena", replay_arena_init, replay_arena_alloc, replay_arena_free, replay_arena_footprint,
+    replay_arena_cleanup},
+  {"slab", replay_slab_init, replay_slab_alloc, replay_slab_free, replay_slab_footprint,
+    replay_slab_cleanup},
+  {"buddy", replay_buddy_init, replay_buddy_alloc, replay_buddy_free, replay_buddy_footprint,
+    replay_buddy_cleanup},
+};
+
+/**
+ * @brief Open-addressing map from recorded block addresses to slots, used while loading.
+ */
+typedef struct replay_map_t
+{
+  uint64_t* keys;  /**< Recorded addresses, 0 marks an empty cell */
+  uint32_t* slots; /**< Slot of each key */
+  size_t capacity; /**< Number of cells, a power of two */
+} replay_map_t;
+
+static size_t replay_map_find(const replay_map_t* map, uint64_t key)
+{
+  size_t index = (size_t)((key >> 4) * 0x9E3779B97F4A7C15ULL) & (map->capacity - 1);
+  while (map->keys[index] != 0 && map->keys[index] != key) {
+    index = (index + 1) & (map->capacity - 1);
+  }
+  return index;
+}
+
+static void replay_map_erase(replay_map_t* map, size_t index)
+{
+  // Backward-shift deletion keeps probe sequences intact without tombstones
+  size_t hole = index;
+  size_t next = (hole + 1) & (map->capacity - 1);
+  while (map->keys[next] != 0) {
+    const size_t home =
+      (size_t)((map->keys[next] >> 4) * 0x9E3779B97F4A7C15ULL) & (map->capacity - 1);
+    if (((next - home) & (map->capacity - 1)) >= ((next - hole) & (map->capacity - 1))) {
+      map->keys[hole] = map->keys[next];
+      map->slots[hole] = map->slots[next];
+      hole = next;
+    }
+    next = (next + 1) & (map->capacity - 1);
+  }
+  map->keys[hole] = 0;
+}
+
+/**
+ * @brief Reads a trace file and resolves block addresses to dense slots.
+ *        Frees of blocks allocated before the trace started are dropped.
+ */
+static bool replay_load(const char* path, replay_trace_t* trace)
+{
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return false;
+  }
+
+  rtl_trace_file_header_t header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      memcmp(header.magic, RTL_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != RTL_TRACE_VERSION || header.record_size != sizeof(rtl_trace_record_t)) {
+    fprintf(stderr, "%s is not a supported allocation trace\n", path);
+    fclose(file);
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  const size_t record_count =
+    (size_t)(ftell(file) - (long)sizeof(header)) / sizeof(rtl_trace_record_t);
+  fseek(file, (long)sizeof(header), SEEK_SET);
+
+  replay_map_t map;
+  map.capacity = 16;
+  while (map.capacity < record_count * 2) {
+    map.capacity <<= 1;
+  }
+  map.keys = calloc(map.capacity, sizeof(uint64_t));
+  map.slots = malloc(map.capacity * sizeof(uint32_t));
+  uint32_t* free_slots = malloc((record_count + 1) * sizeof(uint32_t));
+  trace->ops = malloc((record_count + 1) * sizeof(replay_op_t));
+  if (!map.keys || !map.slots || !free_slots || !trace->ops) {
+    fprintf(stderr, "Out of memory loading %lu records\n", (unsigned long)record_count);
+    fclose(file);
+    return false;
+  }
+
+  size_t free_count = 0;
+  size_t live = 0;
+  trace->op_count = 0;
+  trace->slot_count = 0;
+  trace->total_bytes = 0;
+  trace->peak_live = 0;
+
+  rtl_trace_record_t record;
+  while (fread(&record, sizeof(record), 1, file) == 1) {
+    const size_t index = replay_map_find(&map, record.ptr_id);
+    replay_op_t* op = &trace->ops[trace->op_count];
+
+    if (record.op == RTL_TRACE_OP_MALLOC) {
+      if (map.keys[index] != 0) {
+        continue;  // The address was reused without a recorded free, keep the first
+      }
+      op->slot = free_count > 0 ? free_slots[--free_count] : (uint32_t)trace->slot_count++;
+      map.keys[index] = record.ptr_id;
+      map.slots[index] = op->slot;
+      live += (size_t)record.size;
+      trace->total_bytes += (size_t)record.size;
+      if (live > trace->peak_live) {
+        trace->peak_live = live;
+      }
+    } else if (record.op == RTL_TRACE_OP_FREE && map.keys[index] != 0) {
+      op->slot = map.slots[index];
+      free_slots[free_count++] = op->slot;
+      replay_map_erase(&map, index);
+      live -= (size_t)record.size;
+    } else {
+      continue;
+    }
+
+    op->op = record.op;
+    op->size = (size_t)record.size;
+    trace->op_count++;
+  }
+
+  free(map.keys);
+  free(map.slots);
+  free(free_slots);
+  fclose(file);
+  return true;
+}
+
+/**
+ * @brief Reads the current resident set size in bytes.
+ *        Falls back to the peak where /proc isn't available, which is only meaningful for
+ *        the first backend that grows past the parent's high-water mark.
+ */
+static size_t replay_current_rss(void)
+{
+#if defined(__linux__)
+  static int fd = -1;
+  if (fd < 0) {
+    fd = open("/proc/self/statm", O_RDONLY);
+  }
+
+  char buffer[128];
+  const ssize_t length = fd >= 0 ? pread(fd, buffer, sizeof(buffer) - 1, 0) : -1;
+  if (length > 0) {
+    buffer[length] = '\0';
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    if (sscanf(buffer, "%lu %lu", &size, &resident) == 2) {
+      return (size_t)resident * rtl_page_size();
+    }
+  }
+#endif
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return (size_t)usage.ru_maxrss;
+#else
+  return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+/**
+ * @brief Peak memory of a run, each reading relative to its value before the run.
+ */
+typedef struct replay_usage_t
+{
+  size_t rss_base;  /**< Resident set before the first operation */
+  size_t held_base; /**< Bytes held by the backend before the first operation */
+  size_t rss;       /**< Peak resident set growth */
+  size_t held;      /**< Peak bytes held by the backend */
+} replay_usage_t;
+
+static size_t replay_growth(size_t value, size_t base)
+{
+  return value > base ? value - base : 0;
+}
+
+static void replay_sample(const replay_backend_t* backend, replay_usage_t* usage)
+{
+  const size_t rss = replay_growth(replay_current_rss(), usage->rss_base);
+  if (rss > usage->rss) {
+    usage->rss = rss;
+  }
+  if (backend->footprint) {
+    const size_t held = replay_growth(backend->footprint(), usage->held_base);
+    if (held > usage->held) {
+      usage->held = held;
+    }
+  }
+}
+
+/**
+ * @brief Share of a footprint not explained by the live bytes of the trace.
+ */
+static double replay_fragmentation(size_t footprint, size_t peak_live)
+{
+  return footprint > peak_live ? 1.0 - (double)peak_live / (double)footprint : 0.0;
+}
+
+static double replay_seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Runs the trace against one backend and prints a report line.
+ */
+static int replay_run(const replay_backend_t* backend, const replay_trace_t* trace)
+{
+  void** blocks = calloc(trace->slot_count + 1, sizeof(void*));
+  if (blocks == NULL || !backend->init(trace)) {
+    fprintf(stderr, "%s: initialization failed\n", backend->name);
+    return EXIT_FAILURE;
+  }
+
+  const size_t page_size = rtl_page_size();
+  replay_usage_t usage = {0};
+  usage.rss_base = replay_current_rss();
+  usage.held_base = backend->footprint ? backend->footprint() : 0;
+  double sampling = 0.0;
+  const double start = replay_seconds();
+
+  for (size_t i = 0; i < trace->op_count; i++) {
+    const replay_op_t* op = &trace->ops[i];
+    if (op->op == RTL_TRACE_OP_MALLOC) {
+      char* ptr = backend->alloc(op->size);
+      if (ptr == NULL) {
+        fprintf(stderr, "%s: allocation of %lu bytes failed\n", backend->name,
+          (unsigned long)op->size);
+        return EXIT_FAILURE;
+      }
+      // Touch every page like a real user of the block would
+      for (size_t offset = 0; offset < op->size; offset += page_size) {
+        ptr[offset] = 1;
+      }
+      blocks[op->slot] = ptr;
+    } else {
+      // Memory only peaks at the end of a run of allocations
+      if (i > 0 && trace->ops[i - 1].op == RTL_TRACE_OP_MALLOC) {
+        const double sample_start = replay_seconds();
+        replay_sample(backend, &usage);
+        sampling += replay_seconds() - sample_start;
+      }
+      backend->free(blocks[op->slot], op->size);
+      blocks[op->slot] = NULL;
+    }
+  }
+
+  const double elapsed = replay_seconds() - start - sampling;
+  replay_sample(backend, &usage);
+
+  printf("%-8s %14.0f %12lu %12.1f%%", backend->name,
+    elapsed > 0 ? (double)trace->op_count / elapsed : 0.0, (unsigned long)(usage.rss / 1024),
+    replay_fragmentation(usage.rss, trace->peak_live) * 100.0);
+  if (backend->footprint) {
+    printf(" %12lu %12.1f%%\n", (unsigned long)(usage.held / 1024),
+      replay_fragmentation(usage.held, trace->peak_live) * 100.0);
+  } else {
+    printf(" %12s %13s\n", "-", "-");
+  }
+
+  backend->cleanup();
+  free(blocks);
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <trace file> [malloc|arena|slab|buddy...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  replay_trace_t trace;
+  if (!replay_load(argv[1], &trace)) {
+    return EXIT_FAILURE;
+  }
+
+  printf("%lu operations, peak live %lu KiB\n", (unsigned long)trace.op_count,
+    (unsigned long)(trace.peak_live / 1024));
+  printf("%-8s %14s %12s %13s %12s %13s\n", "backend", "ops/s", "RSS KiB", "RSS frag",
+    "held KiB", "held frag");
+  fflush(stdout);
+
+  int result = EXIT_SUCCESS;
+  const size_t backend_count = sizeof(g_backends) / sizeof(g_backends[0]);
+  for (size_t i = 0; i < backend_count; i++) {
+    bool selected = argc == 2;
+    for (int arg = 2; arg < argc; arg++) {
+      selected |= strcmp(argv[arg], g_backends[i].name) == 0;
+    }
+    if (!selected) {
+      continue;
+    }
+
+    const pid_t child = fork();
+    if (child == 0) {
+      const int status = replay_run(&g_backends[i], &trace);
+      fflush(stdout);
+      _exit(status);
+    }
+
+    int status = EXIT_FAILURE;
+    if (child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != EXIT_SUCCESS) {
+      result = EXIT_FAILURE;
+    }
+  }
+
+  free(trace.ops);
+  return result;
+}